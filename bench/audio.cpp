@@ -0,0 +1,124 @@
+#include <cstdint>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <audio_kernels.h>
+
+using Format = AudioDecoderBase::Format;
+
+// Samples per channel of one audio callback
+constexpr size_t frames = 2048;
+
+// Benchmark arguments: AudioKernels::Isa, number of channels (1 BGM + up to 32 SE)
+static void KernelIsasChannels(benchmark::internal::Benchmark* b) {
+	for (int isa = 0; isa <= static_cast<int>(AudioKernels::Isa::NEON); ++isa) {
+		for (int channels: { 1, 9, 33 }) {
+			b->Args({ isa, channels });
+		}
+	}
+}
+
+// Benchmark arguments: AudioKernels::Isa, AudioDecoderBase::Format
+static void KernelIsasFormats(benchmark::internal::Benchmark* b) {
+	for (int isa = 0; isa <= static_cast<int>(AudioKernels::Isa::NEON); ++isa) {
+		for (int format = 0; format <= static_cast<int>(Format::F32); ++format) {
+			b->Args({ isa, format });
+		}
+	}
+}
+
+struct KernelIsa {
+	KernelIsa(benchmark::State& state) {
+		auto isa = static_cast<AudioKernels::Isa>(state.range(0));
+		supported = AudioKernels::SetIsa(isa);
+		if (!supported) {
+			state.SkipWithError("Not supported");
+		}
+		state.SetLabel(AudioKernels::GetIsaName(isa));
+	}
+	~KernelIsa() {
+		AudioKernels::SetIsa(prev);
+	}
+
+	AudioKernels::Isa prev = AudioKernels::GetIsa();
+	bool supported = false;
+};
+
+static std::vector<uint8_t> MakeSamples(size_t bytes) {
+	std::vector<uint8_t> data(bytes);
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<uint8_t>(i * 7);
+	}
+	return data;
+}
+
+static void BM_ToStereoFloat(benchmark::State& state) {
+	KernelIsa kisa(state);
+	if (!kisa.supported) {
+		return;
+	}
+
+	auto format = static_cast<Format>(state.range(1));
+	// F32 samples must be valid floats
+	auto data = MakeSamples(frames * 2 * 4);
+	if (format == Format::F32) {
+		std::vector<float> samples(frames * 2, 0.25f);
+		data.assign(reinterpret_cast<uint8_t*>(samples.data()), reinterpret_cast<uint8_t*>(samples.data() + samples.size()));
+	}
+	std::vector<float> out(frames * 2);
+
+	for (auto _: state) {
+		AudioKernels::ToStereoFloat(data.data(), format, 2, frames, 0.8f, 0.6f, out.data());
+		benchmark::DoNotOptimize(out.data());
+	}
+}
+
+BENCHMARK(BM_ToStereoFloat)->Apply(KernelIsasFormats);
+
+static void BM_ToStereoFloatMono(benchmark::State& state) {
+	KernelIsa kisa(state);
+	if (!kisa.supported) {
+		return;
+	}
+
+	auto data = MakeSamples(frames * 2);
+	std::vector<float> out(frames * 2);
+
+	for (auto _: state) {
+		AudioKernels::ToStereoFloat(data.data(), Format::S16, 1, frames, 0.8f, 0.6f, out.data());
+		benchmark::DoNotOptimize(out.data());
+	}
+}
+
+BENCHMARK(BM_ToStereoFloatMono)->DenseRange(0, static_cast<int>(AudioKernels::Isa::NEON));
+
+// Work of GenericAudio::Decode for one callback: every channel is converted
+// when it is decoded and added to the mixer, then the mix is compressed.
+static void BM_Mixer(benchmark::State& state) {
+	KernelIsa kisa(state);
+	if (!kisa.supported) {
+		return;
+	}
+
+	const int channels = state.range(1);
+	std::vector<std::vector<uint8_t>> decoded;
+	for (int i = 0; i < channels; ++i) {
+		decoded.push_back(MakeSamples(frames * 2 * 2));
+	}
+	std::vector<float> channel_buffer(frames * 2);
+	std::vector<float> mixer_buffer(frames * 2);
+	std::vector<int16_t> sample_buffer(frames * 2);
+
+	for (auto _: state) {
+		std::fill(mixer_buffer.begin(), mixer_buffer.end(), 0.0f);
+		for (auto& data: decoded) {
+			AudioKernels::ToStereoFloat(data.data(), Format::S16, 2, frames, 0.9f, 0.9f, channel_buffer.data());
+			AudioKernels::MixAdd(mixer_buffer.data(), channel_buffer.data(), channel_buffer.size(), 0.8f);
+		}
+		AudioKernels::MixToS16(mixer_buffer.data(), sample_buffer.data(), sample_buffer.size(), channels * 0.72f);
+		benchmark::DoNotOptimize(sample_buffer.data());
+	}
+}
+
+BENCHMARK(BM_Mixer)->Apply(KernelIsasChannels);
+
+BENCHMARK_MAIN();
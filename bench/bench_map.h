@@ -0,0 +1,70 @@
+#ifndef EP_BENCH_MAP_H
+#define EP_BENCH_MAP_H
+
+#include "game_actors.h"
+#include "game_map.h"
+#include "game_party.h"
+#include "game_pictures.h"
+#include "game_player.h"
+#include "game_screen.h"
+#include "game_switches.h"
+#include "game_system.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "map_data.h"
+#include "output.h"
+#include <lcf/data.h>
+
+/** Chipset where every tile is passable */
+static lcf::rpg::Chipset MakeBenchChipset() {
+	lcf::rpg::Chipset chipset;
+	chipset.passable_data_lower.resize(162, 0xF);
+	chipset.passable_data_upper.resize(162, 0xF);
+	chipset.terrain_data.resize(144, 1);
+	return chipset;
+}
+
+/** Creates the game objects and loads map as map 1 with the player on it */
+static void SetupBenchMap(std::unique_ptr<lcf::rpg::Map> map, const lcf::rpg::Chipset& chipset = MakeBenchChipset()) {
+	Output::SetLogLevel(LogLevel::Error);
+
+	lcf::Data::terrains.push_back({});
+	lcf::Data::chipsets.push_back(chipset);
+
+	auto& treemap = lcf::Data::treemap;
+	treemap = {};
+	treemap.maps.push_back(lcf::rpg::MapInfo());
+	treemap.maps.back().type = lcf::rpg::TreeMap::MapType_root;
+	treemap.maps.push_back(lcf::rpg::MapInfo());
+	treemap.maps.back().ID = 1;
+	treemap.maps.back().type = lcf::rpg::TreeMap::MapType_map;
+
+	Main_Data::game_actors = std::make_unique<Game_Actors>();
+	Main_Data::game_party = std::make_unique<Game_Party>();
+	Game_Map::Init();
+	Main_Data::game_system = std::make_unique<Game_System>();
+	Main_Data::game_switches = std::make_unique<Game_Switches>();
+	Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	Main_Data::game_pictures = std::make_unique<Game_Pictures>();
+	Main_Data::game_screen = std::make_unique<Game_Screen>();
+	Main_Data::game_player = std::make_unique<Game_Player>();
+	Main_Data::game_player->SetMapId(1);
+
+	Game_Map::Setup(std::move(map));
+}
+
+static void TeardownBenchMap() {
+	Main_Data::game_switches = {};
+	Main_Data::game_variables = {};
+	Main_Data::game_player = {};
+	Main_Data::game_screen = {};
+	Main_Data::game_pictures = {};
+	Game_Map::Quit();
+	lcf::Data::data = {};
+	Main_Data::game_party.reset();
+	Main_Data::game_actors.reset();
+
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+#endif
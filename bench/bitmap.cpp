@@ -4,6 +4,7 @@
 #include <bitmap.h>
 #include <pixel_format.h>
 #include <transform.h>
+#include <bitmap_kernels.h>
 
 constexpr auto opacity_100 = Opacity::Opaque();
 constexpr auto opacity_0 = Opacity(0);
@@ -20,6 +21,28 @@ const auto fmt_abgr = format_A8B8G8R8_a().format();
 const DynamicFormat formats[] = { fmt_rgba, fmt_bgra, fmt_argb, fmt_abgr };
 const auto format = fmt_rgba;
 
+// Benchmark argument for each BitmapKernels::Isa
+static void KernelIsas(benchmark::internal::Benchmark* b) {
+	b->DenseRange(0, static_cast<int>(BitmapKernels::Isa::NEON));
+}
+
+struct KernelIsa {
+	KernelIsa(benchmark::State& state) {
+		auto isa = static_cast<BitmapKernels::Isa>(state.range(0));
+		supported = BitmapKernels::SetIsa(isa);
+		if (!supported) {
+			state.SkipWithError("Not supported");
+		}
+		state.SetLabel(BitmapKernels::GetIsaName(isa));
+	}
+	~KernelIsa() {
+		BitmapKernels::SetIsa(prev);
+	}
+
+	BitmapKernels::Isa prev = BitmapKernels::GetIsa();
+	bool supported = false;
+};
+
 struct BitmapAccess : public Bitmap {
 	static pixman_format_code_t find_format(const DynamicFormat& format) {
 		return Bitmap::find_format(format);
@@ -72,6 +95,20 @@ static void BM_ComputeImageOpacityChipset(benchmark::State& state) {
 
 BENCHMARK(BM_ComputeImageOpacityChipset);
 
+static void BM_ComputeImageOpacityKernel(benchmark::State& state) {
+	KernelIsa isa(state);
+	if (!isa.supported) {
+		return;
+	}
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto bm = Bitmap::Create(320, 240);
+	for (auto _: state) {
+		bm->ComputeImageOpacity();
+	}
+}
+
+BENCHMARK(BM_ComputeImageOpacityKernel)->Apply(KernelIsas);
+
 static void BM_Create(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	for (auto _: state) {
@@ -277,6 +314,41 @@ static void BM_ToneBlit(benchmark::State& state) {
 
 BENCHMARK(BM_ToneBlit);
 
+static void BM_ToneBlitKernel(benchmark::State& state) {
+	KernelIsa isa(state);
+	if (!isa.supported) {
+		return;
+	}
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	dest->Fill(Color(200, 100, 50, 255));
+	auto rect = dest->GetRect();
+	// Saturation and color change
+	auto tone = Tone(160, 128, 96, 64);
+	for (auto _: state) {
+		dest->ToneBlit(0, 0, *dest, rect, tone, opacity);
+	}
+}
+
+BENCHMARK(BM_ToneBlitKernel)->Apply(KernelIsas);
+
+static void BM_ToneBlitSaturationKernel(benchmark::State& state) {
+	KernelIsa isa(state);
+	if (!isa.supported) {
+		return;
+	}
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	dest->Fill(Color(200, 100, 50, 255));
+	auto rect = dest->GetRect();
+	auto tone = Tone(128, 128, 128, 0);
+	for (auto _: state) {
+		dest->ToneBlit(0, 0, *dest, rect, tone, opacity);
+	}
+}
+
+BENCHMARK(BM_ToneBlitSaturationKernel)->Apply(KernelIsas);
+
 static void BM_BlendBlit(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
@@ -1,9 +1,12 @@
+#include <cstdlib>
 #include <benchmark/benchmark.h>
+#include <filefinder.h>
 #include <font.h>
 #include <rect.h>
 #include <bitmap.h>
 #include <pixel_format.h>
 #include <cache.h>
+#include <text.h>
 
 const std::string text = "Alex landed a critical hit on Slime!";
 char32_t symbol = '\\';
@@ -53,4 +56,66 @@ static void BM_Render(benchmark::State& state) {
 
 BENCHMARK(BM_Render);
 
+// TrueType font set with the EP_BENCH_FONT environment variable
+static FontRef LoadTtf(benchmark::State& state) {
+	const char* path = std::getenv("EP_BENCH_FONT");
+	if (!path) {
+		state.SkipWithError("EP_BENCH_FONT not set");
+		return nullptr;
+	}
+
+	auto font = Font::CreateFtFont(FileFinder::Root().OpenInputStream(path), 12, false, false);
+	if (!font) {
+		state.SkipWithError("Not supported");
+		return nullptr;
+	}
+	font->SetFallbackFont(Font::DefaultBitmapFont());
+	return font;
+}
+
+static void BM_vRenderTtf(benchmark::State& state) {
+	auto font = LoadTtf(state);
+	if (!font) {
+		return;
+	}
+
+	for (auto _: state) {
+		auto bm = font->vRender(symbol);
+		(void)bm;
+	}
+}
+
+BENCHMARK(BM_vRenderTtf);
+
+static void BM_FontSizeStrTtf(benchmark::State& state) {
+	auto font = LoadTtf(state);
+	if (!font) {
+		return;
+	}
+
+	for (auto _: state) {
+		auto rect = Text::GetSize(*font, text);
+		(void)rect;
+	}
+}
+
+BENCHMARK(BM_FontSizeStrTtf);
+
+static void BM_TextDrawTtf(benchmark::State& state) {
+	auto font = LoadTtf(state);
+	if (!font) {
+		return;
+	}
+
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SystemOrBlack();
+
+	for (auto _: state) {
+		Text::Draw(*surface, 0, 0, *font, *system, 0, text);
+	}
+}
+
+BENCHMARK(BM_TextDrawTtf);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <initializer_list>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "game_interpreter_jump_table.h"
+
+using Cmd = lcf::rpg::EventCommand::Code;
+using CommandList = std::vector<lcf::rpg::EventCommand>;
+
+static void AddCommand(CommandList& list, Cmd code, int indent, int32_t param = 0) {
+	lcf::rpg::EventCommand cmd;
+	cmd.code = static_cast<int32_t>(code);
+	cmd.indent = indent;
+	cmd.parameters = lcf::DBArray<int32_t>(&param, &param + 1);
+	list.push_back(std::move(cmd));
+}
+
+// Block of commands with nested control flow, where about a third of the
+// commands run and the rest is skipped by jumps
+static void AddBlock(CommandList& list, int indent, int depth, int& label_id) {
+	for (int i = 0; i < 10; ++i) {
+		AddCommand(list, Cmd::ControlVariables, indent);
+	}
+	if (depth == 0) {
+		return;
+	}
+
+	// Branch that is not taken: jump over the big true case into the else case
+	AddCommand(list, Cmd::ConditionalBranch, indent, 0);
+	AddBlock(list, indent + 1, depth - 1, label_id);
+	AddCommand(list, Cmd::ElseBranch, indent);
+	AddCommand(list, Cmd::ControlVariables, indent + 1);
+	AddCommand(list, Cmd::EndBranch, indent);
+
+	// Branch that is taken: the else case is skipped
+	AddCommand(list, Cmd::ConditionalBranch, indent, 1);
+	AddCommand(list, Cmd::ControlVariables, indent + 1);
+	AddCommand(list, Cmd::ElseBranch, indent);
+	AddBlock(list, indent + 1, depth - 1, label_id);
+	AddCommand(list, Cmd::EndBranch, indent);
+
+	// Loop running three times with a break out of a nested loop
+	AddCommand(list, Cmd::Loop, indent, 3);
+	AddBlock(list, indent + 1, depth - 1, label_id);
+	AddCommand(list, Cmd::Loop, indent + 1, 100);
+	AddCommand(list, Cmd::ControlVariables, indent + 2);
+	AddCommand(list, Cmd::BreakLoop, indent + 2);
+	AddCommand(list, Cmd::EndLoop, indent + 1, 100);
+	AddCommand(list, Cmd::EndLoop, indent, 3);
+
+	// Jump over a block to a label
+	const int id = ++label_id;
+	AddCommand(list, Cmd::JumpToLabel, indent, id);
+	AddBlock(list, indent, depth - 1, label_id);
+	AddCommand(list, Cmd::Label, indent, id);
+}
+
+// Large parallel common event with nested branches, loops and labels,
+// around 4800 commands of which 2100 are executed
+static CommandList MakeEvent() {
+	CommandList list;
+	int label_id = 0;
+	AddBlock(list, 0, 4, label_id);
+	return list;
+}
+
+// Scans of the interpreter before the jump table was added
+struct LinearJumps {
+	explicit LinearJumps(const CommandList& list) : list(list) {}
+
+	int FindNextConditional(int index, std::initializer_list<Cmd> codes, int indent) const {
+		for (++index; index < static_cast<int>(list.size()); ++index) {
+			const auto& com = list[index];
+			if (com.indent > indent) {
+				continue;
+			}
+			if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
+				break;
+			}
+		}
+		return index;
+	}
+
+	int FindLoopStart(int index, int indent) const {
+		for (int idx = index; idx >= 0; idx--) {
+			if (list[idx].indent > indent)
+				continue;
+			if (list[idx].indent < indent)
+				return -1;
+			if (static_cast<Cmd>(list[idx].code) != Cmd::Loop)
+				continue;
+			return idx;
+		}
+		return index;
+	}
+
+	int FindLabel(int label_id) const {
+		for (int idx = 0; (size_t)idx < list.size(); idx++) {
+			if (static_cast<Cmd>(list[idx].code) == Cmd::Label && list[idx].parameters[0] == label_id) {
+				return idx;
+			}
+		}
+		return -1;
+	}
+
+	const CommandList& list;
+};
+
+// Runs the control flow of the event like Game_Interpreter does,
+// returns the number of executed commands.
+template <typename Jumps>
+static int RunEvent(const CommandList& list, const Jumps& jumps) {
+	std::vector<int> loop_counters(16);
+	std::vector<bool> take_else(16);
+	int executed = 0;
+
+	for (int index = 0; index < static_cast<int>(list.size()); ++executed) {
+		const auto& com = list[index];
+		switch (static_cast<Cmd>(com.code)) {
+			case Cmd::ConditionalBranch:
+				take_else[com.indent] = com.parameters[0] == 0;
+				if (take_else[com.indent]) {
+					index = jumps.FindNextConditional(index, { Cmd::ElseBranch, Cmd::EndBranch }, com.indent);
+					continue;
+				}
+				break;
+			case Cmd::ElseBranch:
+				if (!take_else[com.indent]) {
+					index = jumps.FindNextConditional(index, { Cmd::EndBranch }, com.indent);
+					continue;
+				}
+				break;
+			case Cmd::Loop:
+				loop_counters[com.indent] = 0;
+				break;
+			case Cmd::BreakLoop:
+				index = jumps.FindNextConditional(index, { Cmd::EndLoop }, com.indent - 1) + 1;
+				continue;
+			case Cmd::EndLoop:
+				if (++loop_counters[com.indent] < com.parameters[0]) {
+					index = jumps.FindLoopStart(index, com.indent) + 1;
+					continue;
+				}
+				break;
+			case Cmd::JumpToLabel:
+				index = jumps.FindLabel(com.parameters[0]);
+				continue;
+			default:
+				break;
+		}
+		++index;
+	}
+	return executed;
+}
+
+static void BM_RunEventLinear(benchmark::State& state) {
+	const auto list = MakeEvent();
+	LinearJumps jumps(list);
+
+	for (auto _: state) {
+		benchmark::DoNotOptimize(RunEvent(list, jumps));
+	}
+}
+
+BENCHMARK(BM_RunEventLinear);
+
+static void BM_RunEventJumpTable(benchmark::State& state) {
+	const auto list = MakeEvent();
+	Game_Interpreter_JumpTable jumps(list);
+
+	for (auto _: state) {
+		benchmark::DoNotOptimize(RunEvent(list, jumps));
+	}
+}
+
+BENCHMARK(BM_RunEventJumpTable);
+
+// Cost paid once when the event is pushed
+static void BM_BuildJumpTable(benchmark::State& state) {
+	const auto list = MakeEvent();
+
+	for (auto _: state) {
+		Game_Interpreter_JumpTable jumps(list);
+		benchmark::DoNotOptimize(jumps.GetSize());
+	}
+}
+
+BENCHMARK(BM_BuildJumpTable);
+
+BENCHMARK_MAIN();
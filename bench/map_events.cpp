@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+#include "bench_map.h"
+
+constexpr int map_size = 100;
+constexpr int num_events = 500;
+constexpr int num_switches = 50;
+
+// Passable map with events spread over a pseudo random set of tiles,
+// like the many small NPCs and projectiles of an action game.
+// Every event has a second page turned on by one of the switches.
+static std::unique_ptr<lcf::rpg::Map> MakeEventMap() {
+	auto map = std::make_unique<lcf::rpg::Map>();
+	map->width = map_size;
+	map->height = map_size;
+	map->upper_layer.resize(map_size * map_size, BLOCK_F);
+	map->lower_layer.resize(map_size * map_size, BLOCK_E);
+
+	for (int i = 1; i <= num_events; ++i) {
+		map->events.push_back({});
+		auto& ev = map->events.back();
+		ev.ID = i;
+		ev.x = (i * 37) % map_size;
+		ev.y = (i * 53) % map_size;
+		ev.pages.push_back({});
+		ev.pages.back().ID = 1;
+		ev.pages.back().move_type = lcf::rpg::EventPage::MoveType_stationary;
+		ev.pages.back().layer = lcf::rpg::EventPage::Layers_same;
+		ev.pages.push_back(ev.pages.back());
+		ev.pages.back().ID = 2;
+		ev.pages.back().condition.flags.switch_a = true;
+		ev.pages.back().condition.switch_a_id = i % num_switches + 1;
+	}
+
+	return map;
+}
+
+static void BM_GetEventAt(benchmark::State& state) {
+	SetupBenchMap(MakeEventMap());
+
+	int i = 0;
+	for (auto _: state) {
+		benchmark::DoNotOptimize(Game_Map::GetEventAt(i % map_size, (i / map_size) % map_size, true));
+		++i;
+	}
+
+	TeardownBenchMap();
+}
+
+BENCHMARK(BM_GetEventAt);
+
+// One collision test for every event, what a frame with all events moving costs
+static void BM_CheckWayAllEvents(benchmark::State& state) {
+	SetupBenchMap(MakeEventMap());
+
+	auto& events = Game_Map::GetEvents();
+
+	for (auto _: state) {
+		for (auto& ev: events) {
+			const int x = ev.GetX();
+			const int y = ev.GetY();
+			benchmark::DoNotOptimize(Game_Map::CheckWay(ev, x, y, Game_Map::RoundX(x + 1), y));
+		}
+	}
+
+	TeardownBenchMap();
+}
+
+BENCHMARK(BM_CheckWayAllEvents);
+
+// Cost of keeping the index up to date
+static void BM_MoveAllEvents(benchmark::State& state) {
+	SetupBenchMap(MakeEventMap());
+
+	auto& events = Game_Map::GetEvents();
+
+	int dx = 1;
+	for (auto _: state) {
+		for (auto& ev: events) {
+			ev.SetX(ev.GetX() + dx);
+		}
+		dx = -dx;
+	}
+
+	TeardownBenchMap();
+}
+
+BENCHMARK(BM_MoveAllEvents);
+
+// A parallel event toggling a switch, before the targeted refresh every
+// switch change refreshed the pages of all events
+static void BM_RefreshAllEvents(benchmark::State& state) {
+	SetupBenchMap(MakeEventMap());
+
+	for (auto _: state) {
+		Main_Data::game_switches->Flip(1);
+		Game_Map::SetNeedRefresh(true);
+		Game_Map::Refresh();
+	}
+
+	TeardownBenchMap();
+}
+
+BENCHMARK(BM_RefreshAllEvents);
+
+static void BM_RefreshSwitchEvents(benchmark::State& state) {
+	SetupBenchMap(MakeEventMap());
+
+	for (auto _: state) {
+		Main_Data::game_switches->Flip(1);
+		Game_Map::SetNeedRefreshForSwitchChange(1);
+		Game_Map::RefreshChanged();
+	}
+
+	TeardownBenchMap();
+}
+
+BENCHMARK(BM_RefreshSwitchEvents);
+
+BENCHMARK_MAIN();
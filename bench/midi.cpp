@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <decoder_fmmidi.h>
+#include <thread_pool.h>
+
+#ifdef WANT_FMMIDI
+
+constexpr int frequency = 44100;
+constexpr int block_frames = 1024;
+// Length of the reference song
+constexpr int song_blocks = 5 * frequency / block_frames;
+
+// Reference song: 16 channels playing chords with drums on channel 10,
+// around 50 notes are playing at the same time
+static void PlayBlock(FmMidiDecoder& dec, int block) {
+	static const int chords[4][3] = { { 0, 4, 7 }, { 5, 9, 12 }, { 7, 11, 14 }, { -3, 0, 4 } };
+
+	if (block % 8 != 0) {
+		return;
+	}
+
+	const int beat = block / 8;
+	const auto& chord = chords[(beat / 4) % 4];
+	for (int ch = 0; ch < 16; ++ch) {
+		const int base = (ch == 9) ? 35 : 36 + (ch % 4) * 12;
+		for (int i = 0; i < 3; ++i) {
+			const int prev = (ch == 9) ? base + ((beat + 3) % 4) * 3 + i : base + chords[((beat - 1) / 4) % 4][i];
+			const int note = (ch == 9) ? base + (beat % 4) * 3 + i : base + chord[i];
+			if (beat > 0) {
+				dec.SendMidiMessage(0x80 | ch | (prev << 8) | (64 << 16));
+			}
+			dec.SendMidiMessage(0x90 | ch | (note << 8) | ((70 + ch * 3) << 16));
+		}
+	}
+}
+
+static void BM_FmMidiSong(benchmark::State& state) {
+	const int threads = state.range(0);
+	std::unique_ptr<ThreadPool> pool;
+	if (threads > 0) {
+		pool.reset(new ThreadPool(threads));
+	}
+
+	std::vector<int16_t> out(block_frames * 2);
+
+	for (auto _: state) {
+		state.PauseTiming();
+		FmMidiDecoder dec;
+		dec.synth->set_thread_pool(pool.get());
+		for (int ch = 0; ch < 16; ++ch) {
+			dec.SendMidiMessage(0xC0 | ch | (((ch * 11) % 128) << 8));
+			// Modulation for vibrato
+			dec.SendMidiMessage(0xB0 | ch | (1 << 8) | ((ch * 8) << 16));
+		}
+		state.ResumeTiming();
+
+		for (int block = 0; block < song_blocks; ++block) {
+			PlayBlock(dec, block);
+			dec.synth->synthesize(out.data(), block_frames, frequency);
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+
+	// Seconds of audio rendered per second, above 1 is faster than real time
+	state.counters["realtime"] = benchmark::Counter(static_cast<double>(song_blocks) * block_frames / frequency,
+		benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Argument: worker threads, 0 renders all channels on the calling thread
+BENCHMARK(BM_FmMidiSong)->Arg(0)->Arg(1)->Arg(3)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+#endif
+
+BENCHMARK_MAIN();
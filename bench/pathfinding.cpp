@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+#include "bench_map.h"
+
+// Vertical walls every 4 tiles with a gap alternating between top and bottom.
+// The route has to snake through the whole map.
+static std::unique_ptr<lcf::rpg::Map> MakeMazeMap(int w, int h) {
+	auto map = std::make_unique<lcf::rpg::Map>();
+	map->width = w;
+	map->height = h;
+	map->upper_layer.resize(w * h, BLOCK_F);
+	map->lower_layer.resize(w * h, BLOCK_E);
+
+	for (int x = 2; x < w; x += 4) {
+		int gap_y = ((x / 4) % 2 == 0) ? h - 1 : 0;
+		for (int y = 0; y < h; ++y) {
+			if (y != gap_y) {
+				map->lower_layer[y * w + x] = BLOCK_E + 1;
+			}
+		}
+	}
+
+	return map;
+}
+
+static void SetupMap(int w, int h) {
+	auto chipset = MakeBenchChipset();
+	chipset.passable_data_lower[BLOCK_E_INDEX + 1] = 0;
+	SetupBenchMap(MakeMazeMap(w, h), chipset);
+}
+
+static void BM_CalculateMoveRoute(benchmark::State& state) {
+	const int size = state.range(0);
+	SetupMap(size, size);
+
+	auto& player = *Main_Data::game_player;
+
+	Game_Character::CalculateMoveRouteArgs args;
+	args.dest_x = size - 1;
+	args.dest_y = size - 1;
+	args.allow_diagonal = state.range(1) != 0;
+
+	for (auto _: state) {
+		player.SetX(0);
+		player.SetY(0);
+		benchmark::DoNotOptimize(player.CalculateMoveRoute(args));
+	}
+
+	TeardownBenchMap();
+}
+
+BENCHMARK(BM_CalculateMoveRoute)->Args({50, 0})->Args({50, 1})->Args({200, 0})->Args({200, 1})->Args({500, 0});
+
+// Many short searches per frame, like a Maniac "Search Path" for every event
+static void BM_CalculateMoveRouteShort(benchmark::State& state) {
+	const int size = 500;
+	SetupMap(size, size);
+
+	auto& player = *Main_Data::game_player;
+
+	Game_Character::CalculateMoveRouteArgs args;
+	args.dest_x = 1;
+	args.dest_y = 20;
+	args.steps_max = 1;
+
+	for (auto _: state) {
+		player.SetX(0);
+		player.SetY(0);
+		benchmark::DoNotOptimize(player.CalculateMoveRoute(args));
+	}
+
+	TeardownBenchMap();
+}
+
+BENCHMARK(BM_CalculateMoveRouteShort);
+
+BENCHMARK_MAIN();
@@ -1,7 +1,12 @@
+#include <map>
+#include <string>
+#include <vector>
 #include <benchmark/benchmark.h>
 #include "filefinder_rtp.h"
+#include "filesystem.h"
 #include "output.h"
 #include "player.h"
+#include "rtp.h"
 
 static void BM_InitRtp2k(benchmark::State& state) {
 	Output::SetLogLevel(LogLevel::Error);
@@ -35,4 +40,149 @@ static void BM_InitRtp2k3(benchmark::State& state) {
 
 BENCHMARK(BM_InitRtp2k3);
 
+// Game directory in memory with all assets of one RTP and the game files
+class GameFilesystem : public Filesystem {
+public:
+	GameFilesystem(const char* const rtp_table[][RTP::num_2k3_rtps + 1], int rtp_column) : Filesystem("", FilesystemView()) {
+		for (const char* file: { "RPG_RT.ldb", "RPG_RT.lmt", "RPG_RT.ini", "RPG_RT.exe", "Map0001.lmu", "Map0002.lmu" }) {
+			dirs[""].emplace_back(file, DirectoryTree::FileType::Regular);
+		}
+
+		for (int i = 0; rtp_table[i][0] != nullptr; ++i) {
+			std::string category = rtp_table[i][0];
+			const char* name = rtp_table[i][rtp_column];
+			if (name == nullptr) {
+				continue;
+			}
+
+			auto& files = dirs[category];
+			if (files.empty()) {
+				dirs[""].emplace_back(category, DirectoryTree::FileType::Directory);
+			}
+
+			const char* ext = ".png";
+			if (category == "sound") {
+				ext = ".wav";
+			} else if (category == "music") {
+				ext = ".mid";
+			} else if (category == "movie") {
+				ext = ".avi";
+			}
+			files.emplace_back(std::string(name) + ext, DirectoryTree::FileType::Regular);
+		}
+	}
+
+	bool IsFile(std::string_view path) const override {
+		return !IsDirectory(path, false) && Exists(path);
+	}
+
+	bool IsDirectory(std::string_view path, bool) const override {
+		return dirs.find(std::string(path)) != dirs.end();
+	}
+
+	bool Exists(std::string_view) const override {
+		return true;
+	}
+
+	int64_t GetFilesize(std::string_view) const override {
+		return 0;
+	}
+
+	std::string Describe() const override {
+		return "[Bench]";
+	}
+
+protected:
+	bool GetDirectoryContent(std::string_view path, std::vector<DirectoryTree::Entry>& entries) const override {
+		auto it = dirs.find(std::string(path));
+		if (it == dirs.end()) {
+			return false;
+		}
+		entries = it->second;
+		return true;
+	}
+
+	std::streambuf* CreateInputStreambuffer(std::string_view, std::ios_base::openmode) const override {
+		return nullptr;
+	}
+
+private:
+	std::map<std::string, std::vector<DirectoryTree::Entry>> dirs;
+};
+
+template <typename T>
+static std::vector<std::pair<std::string, std::string>> GetAssets(T rtp_table, int rtp_column) {
+	std::vector<std::pair<std::string, std::string>> assets;
+	for (int i = 0; rtp_table[i][0] != nullptr; ++i) {
+		if (rtp_table[i][rtp_column] != nullptr) {
+			assets.emplace_back(rtp_table[i][0], rtp_table[i][rtp_column]);
+		}
+	}
+	return assets;
+}
+
+// Official English 2003 RTP
+constexpr int bench_rtp_column = 2;
+constexpr auto bench_rtp = RTP::Type::RPG2003_OfficialEnglish;
+
+static void BM_DetectRtp2k3(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	auto game_fs = std::make_shared<GameFilesystem>(RTP::rtp_table_2k3, bench_rtp_column);
+	auto fs = game_fs->Subtree("");
+
+	for (auto _: state) {
+		auto hits = RTP::Detect(fs, 2003);
+		benchmark::DoNotOptimize(hits.data());
+	}
+
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_DetectRtp2k3);
+
+static void BM_DetectRtpAll(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	auto game_fs = std::make_shared<GameFilesystem>(RTP::rtp_table_2k3, bench_rtp_column);
+	auto fs = game_fs->Subtree("");
+
+	for (auto _: state) {
+		auto hits = RTP::Detect(fs, 0);
+		benchmark::DoNotOptimize(hits.data());
+	}
+
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_DetectRtpAll);
+
+// Every asset of the RTP, as done for the assets of a game that are not in the game directory
+static void BM_LookupAnyToRtp(benchmark::State& state) {
+	auto assets = GetAssets(RTP::rtp_table_2k3, bench_rtp_column);
+
+	for (auto _: state) {
+		for (const auto& [category, name]: assets) {
+			auto types = RTP::LookupAnyToRtp(category, name, 2003);
+			benchmark::DoNotOptimize(types.data());
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * assets.size());
+}
+
+BENCHMARK(BM_LookupAnyToRtp);
+
+static void BM_LookupRtpToRtp(benchmark::State& state) {
+	auto assets = GetAssets(RTP::rtp_table_2k3, bench_rtp_column);
+
+	for (auto _: state) {
+		for (const auto& [category, name]: assets) {
+			bool is_rtp_asset;
+			auto translated = RTP::LookupRtpToRtp(category, name, bench_rtp, RTP::Type::RPG2003_OfficialJapanese, &is_rtp_asset);
+			benchmark::DoNotOptimize(translated.data());
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * assets.size());
+}
+
+BENCHMARK(BM_LookupRtpToRtp);
+
 BENCHMARK_MAIN();
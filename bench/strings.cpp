@@ -0,0 +1,52 @@
+#include <regex>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "regex_cache.h"
+
+// Typical pattern of a string command run by a parallel event every frame
+static const std::wstring pattern = L"([A-Za-z]+)\\s*=\\s*(\\d+)";
+static const std::wstring text = L"Name=Alex HP = 120 MP = 45 Level=7";
+
+static void BM_RegexSearch(benchmark::State& state) {
+	for (auto _: state) {
+		std::wregex r(pattern);
+		std::wsmatch match;
+		benchmark::DoNotOptimize(std::regex_search(text, match, r));
+	}
+}
+
+BENCHMARK(BM_RegexSearch);
+
+static void BM_RegexSearchCached(benchmark::State& state) {
+	RegexCache::Clear();
+
+	for (auto _: state) {
+		auto r = RegexCache::Get(pattern);
+		std::wsmatch match;
+		benchmark::DoNotOptimize(std::regex_search(text, match, *r));
+	}
+}
+
+BENCHMARK(BM_RegexSearchCached);
+
+static void BM_RegexReplace(benchmark::State& state) {
+	for (auto _: state) {
+		std::wregex r(pattern);
+		benchmark::DoNotOptimize(std::regex_replace(text, r, L"$2"));
+	}
+}
+
+BENCHMARK(BM_RegexReplace);
+
+static void BM_RegexReplaceCached(benchmark::State& state) {
+	RegexCache::Clear();
+
+	for (auto _: state) {
+		auto r = RegexCache::Get(pattern);
+		benchmark::DoNotOptimize(std::regex_replace(text, *r, L"$2"));
+	}
+}
+
+BENCHMARK(BM_RegexReplaceCached);
+
+BENCHMARK_MAIN();
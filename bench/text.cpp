@@ -1,4 +1,6 @@
+#include <cstdlib>
 #include <benchmark/benchmark.h>
+#include <filefinder.h>
 #include <font.h>
 #include <rect.h>
 #include <bitmap.h>
@@ -81,4 +83,70 @@ static void BM_TextDrawCharColorEx(benchmark::State& state) {
 
 BENCHMARK(BM_TextDrawCharColorEx);
 
+// TrueType font set with the EP_BENCH_FONT environment variable
+static FontRef LoadShapingFont(benchmark::State& state) {
+	const char* path = std::getenv("EP_BENCH_FONT");
+	if (!path) {
+		state.SkipWithError("EP_BENCH_FONT not set");
+		return nullptr;
+	}
+
+	auto font = Font::CreateFtFont(FileFinder::Root().OpenInputStream(path), 12, false, false);
+	if (!font || !font->CanShape()) {
+		state.SkipWithError("Not supported");
+		return nullptr;
+	}
+	font->SetFallbackFont(Font::DefaultBitmapFont());
+	return font;
+}
+
+static const std::u32string text32 = U"Alex landed a critical hit on Slime!";
+
+static void BM_ShapeUncached(benchmark::State& state) {
+	auto font = LoadShapingFont(state);
+	if (!font) {
+		return;
+	}
+
+	for (auto _: state) {
+		auto shape = font->vShape(text32);
+		benchmark::DoNotOptimize(shape.data());
+	}
+}
+
+BENCHMARK(BM_ShapeUncached);
+
+static void BM_ShapeCached(benchmark::State& state) {
+	auto font = LoadShapingFont(state);
+	if (!font) {
+		return;
+	}
+
+	for (auto _: state) {
+		auto shape = font->Shape(text32);
+		benchmark::DoNotOptimize(shape.data());
+	}
+}
+
+BENCHMARK(BM_ShapeCached);
+
+// Window code measures the text before drawing it
+static void BM_TextSizeDrawShaped(benchmark::State& state) {
+	auto font = LoadShapingFont(state);
+	if (!font) {
+		return;
+	}
+
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SysBlack();
+
+	for (auto _: state) {
+		auto rect = Text::GetSize(*font, text);
+		Text::Draw(*surface, width - rect.width, 0, *font, *system, 0, text, Text::AlignLeft);
+	}
+}
+
+BENCHMARK(BM_TextSizeDrawShaped);
+
 BENCHMARK_MAIN();
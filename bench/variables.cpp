@@ -1,5 +1,9 @@
 #include <benchmark/benchmark.h>
+#include "game_interpreter.h"
+#include "game_switches.h"
 #include "game_variables.h"
+#include "main_data.h"
+#include "maniac_patch.h"
 #include <lcf/data.h>
 
 constexpr int max_vars = 1024; // Keep this a power of 2 so no expensive modulus instructions
@@ -124,4 +128,79 @@ static void BM_VariableSetRangeRandom(benchmark::State& state) {
 
 BENCHMARK(BM_VariableSetRangeRandom);
 
+// Packs Maniac expression op code bytes into event command parameters
+static std::vector<int32_t> MakeExpression(std::initializer_list<uint8_t> bytes) {
+	std::vector<uint8_t> data(bytes);
+	data.resize((data.size() + 3) / 4 * 4);
+	std::vector<int32_t> ops(data.size() / 4);
+	for (size_t i = 0; i < ops.size(); ++i) {
+		ops[i] = static_cast<int32_t>(data[i * 4] | (data[i * 4 + 1] << 8) | (data[i * 4 + 2] << 16) | (static_cast<uint32_t>(data[i * 4 + 3]) << 24));
+	}
+	return ops;
+}
+
+// v[1] * 3 + (v[2] < 100 ? max(v[3], 7) : v[v[4]] / 2) - s[5]
+static const std::vector<int32_t> expression = MakeExpression({
+	49, // Sub
+		48, // Add
+			50, 8, 1, 1, 1, 3, // Mul Var U8 1, U8 3
+			72, // Ternary
+				62, 8, 1, 2, 2, 100, 0, // Less Var U8 2, U16 100
+				78, 13, 2, 8, 1, 3, 1, 7, // Function Max (Var U8 3, U8 7)
+				51, 13, 1, 4, 1, 2, // Div VarIndirect U8 4, U8 2
+		9, 1, 5 // Switch U8 5
+});
+
+// Three expressions like used by the Maniac commands taking multiple values
+static const std::vector<int32_t> expressions = MakeExpression({
+	48, 8, 1, 1, 1, 3, // Add Var U8 1, U8 3
+	50, 8, 1, 2, 8, 1, 3, // Mul Var U8 2, Var U8 3
+	78, 14, 1, 49, 1, 4, 8, 1, 5, // Function Abs (Sub U8 4, Var U8 5)
+	0
+});
+
+template <typename F>
+static void BM_ManiacExpressionOp(benchmark::State& state, F&& op) {
+	lcf::Data::variables.resize(max_vars);
+	lcf::Data::switches.resize(max_vars);
+	Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	Main_Data::game_variables->SetRange(1, max_vars, 1);
+	Main_Data::game_switches = std::make_unique<Game_Switches>();
+	Game_Interpreter interpreter;
+
+	for (auto _: state) {
+		op(interpreter);
+	}
+
+	ManiacPatch::ClearExpressionCache();
+	Main_Data::game_variables.reset();
+	Main_Data::game_switches.reset();
+}
+
+static void BM_ManiacExpression(benchmark::State& state) {
+	BM_ManiacExpressionOp(state, [](auto& ip) {
+		benchmark::DoNotOptimize(ManiacPatch::ParseExpression(MakeSpan(expression), ip));
+	});
+}
+
+BENCHMARK(BM_ManiacExpression);
+
+// Evaluation when the expression is not cached yet
+static void BM_ManiacExpressionCompile(benchmark::State& state) {
+	BM_ManiacExpressionOp(state, [](auto& ip) {
+		ManiacPatch::ClearExpressionCache();
+		benchmark::DoNotOptimize(ManiacPatch::ParseExpression(MakeSpan(expression), ip));
+	});
+}
+
+BENCHMARK(BM_ManiacExpressionCompile);
+
+static void BM_ManiacExpressions(benchmark::State& state) {
+	BM_ManiacExpressionOp(state, [](auto& ip) {
+		benchmark::DoNotOptimize(ManiacPatch::ParseExpressions(MakeSpan(expressions), ip));
+	});
+}
+
+BENCHMARK(BM_ManiacExpressions);
+
 BENCHMARK_MAIN();
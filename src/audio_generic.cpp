@@ -17,11 +17,25 @@
 
 #include "system.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <cassert>
 #include <memory>
 #include "audio_generic.h"
+#include "audio_kernels.h"
 #include "output.h"
+#include "instrumentation.h"
+
+namespace {
+	/** Samples per channel ring buffer, stereo */
+	constexpr size_t ring_buffer_samples = 32768;
+	/** Frames decoded at once */
+	constexpr size_t decode_chunk_frames = 1024;
+	/** Minimum time between two underrun reports */
+	constexpr auto underrun_report_interval = std::chrono::seconds(10);
+
+}
 
 GenericAudio::GenericAudio(const Game_ConfigAudio& cfg) : AudioInterface(cfg) {
 	int i = 0;
@@ -42,6 +56,12 @@ GenericAudio::GenericAudio(const Game_ConfigAudio& cfg) : AudioInterface(cfg) {
 	// Initialize to some arbitrary (low-quality) format to prevent crashes
 	// when the inheriting class doesn't call SetFormat
 	SetFormat(12345, AudioDecoder::Format::S8, 1);
+
+	StartDecodeThread();
+}
+
+GenericAudio::~GenericAudio() {
+	StopDecodeThread();
 }
 
 void GenericAudio::BGM_Play(Filesystem_Stream::InputStream stream, int volume, int pitch, int fadein, int balance) {
@@ -80,10 +100,10 @@ void GenericAudio::BGM_Resume() {
 }
 
 void GenericAudio::BGM_Stop() {
-	LockMutex();
 	for (auto& BGM_Channel : BGM_Channels) {
 		BGM_Channel.Stop();
 	}
+	LockMutex();
 	BGM_PlayedOnceIndicator = false;
 	UnlockMutex();
 }
@@ -116,65 +136,54 @@ bool GenericAudio::BGM_IsPlaying() const {
 
 int GenericAudio::BGM_GetTicks() const {
 	unsigned ticks = 0;
-	LockMutex();
 	for (auto& BGM_Channel : BGM_Channels) {
 		int cur_ticks = BGM_Channel.GetTicks();
 		if (cur_ticks >= 0) {
 			ticks = static_cast<unsigned>(cur_ticks);
 		}
 	}
-	UnlockMutex();
 	return ticks;
 }
 
 void GenericAudio::BGM_Fade(int fade) {
-	LockMutex();
 	for (auto& BGM_Channel : BGM_Channels) {
 		BGM_Channel.SetFade(fade);
 	}
-	UnlockMutex();
 }
 
 void GenericAudio::BGM_Volume(int volume) {
-	LockMutex();
 	for (auto& BGM_Channel : BGM_Channels) {
 		BGM_Channel.SetVolume(volume);
 	}
-	UnlockMutex();
 }
 
 void GenericAudio::BGM_Pitch(int pitch) {
-	LockMutex();
 	for (auto& BGM_Channel : BGM_Channels) {
 		BGM_Channel.SetPitch(pitch);
 	}
-	UnlockMutex();
 }
 
 void GenericAudio::BGM_Balance(int balance) {
-	LockMutex();
 	for (auto& BGM_Channel : BGM_Channels) {
 		BGM_Channel.SetBalance(balance);
 	}
-	UnlockMutex();
 }
 
 std::string GenericAudio::BGM_GetType() const {
 	std::string type;
 
-	LockMutex();
 	for (auto& BGM_Channel : BGM_Channels) {
-		if (BGM_Channel.IsUsed()) {
-			if (BGM_Channel.midi_out_used) {
-				type = "midi";
-				break;
-			} else {
-				type = BGM_Channel.decoder->GetType();
-				break;
-			}
+		if (BGM_Channel.midi_out_used) {
+			type = "midi";
+			break;
+		}
+
+		std::lock_guard<DecodeMutex> lock(BGM_Channel.buffer.mutex);
+		if (BGM_Channel.decoder) {
+			type = BGM_Channel.decoder->GetType();
+			break;
 		}
 	}
-	UnlockMutex();
 
 	return type;
 }
@@ -203,7 +212,20 @@ void GenericAudio::SE_Stop() {
 }
 
 void GenericAudio::Update() {
-	// no-op, handled by the Decode function called through a thread
+	// Decoding is handled by the Decode function called through a thread
+	auto underruns = underrun_count.load(std::memory_order_relaxed);
+	if (underruns != reported_underrun_count) {
+		auto now = Game_Clock::now();
+		if (now - underrun_report_time >= underrun_report_interval) {
+			Output::Debug("Audio: {} decode underruns (total {})", underruns - reported_underrun_count, underruns);
+			reported_underrun_count = underruns;
+			underrun_report_time = now;
+		}
+	}
+}
+
+uint32_t GenericAudio::GetUnderrunCount() const {
+	return underrun_count.load(std::memory_order_relaxed);
 }
 
 GenericAudioMidiOut* GenericAudio::CreateAndGetMidiOut() {
@@ -236,7 +258,7 @@ bool GenericAudio::PlayOnChannel(BgmChannel& chan, Filesystem_Stream::InputStrea
 
 	// Midiout is only supported on channel 0 because this is an exclusive resource
 	if (chan.id == 0 && GenericAudioMidiOut::IsSupported(filestream)) {
-		chan.decoder.reset();
+		SetChannelDecoder(chan.decoder, chan.buffer, nullptr);
 
 		// Order is Fluidsynth, WildMidi, Native, FmMidi
 		bool fluidsynth = Audio().GetFluidsynthEnabled() && MidiDecoder::CreateFluidsynth(true);
@@ -269,19 +291,21 @@ bool GenericAudio::PlayOnChannel(BgmChannel& chan, Filesystem_Stream::InputStrea
 		midi_thread->GetMidiOut().Reset();
 	}
 
-	chan.decoder = AudioDecoder::Create(filestream);
+	auto decoder = AudioDecoder::Create(filestream);
 	chan.midi_out_used = false;
-	if (chan.decoder && chan.decoder->Open(std::move(filestream))) {
-		chan.decoder->SetPitch(pitch);
-		chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
-		chan.decoder->SetVolume(0);
-		chan.decoder->SetFade(volume, std::chrono::milliseconds(fadein));
-		chan.decoder->SetLooping(true);
-		chan.decoder->SetBalance(balance);
+	if (decoder && decoder->Open(std::move(filestream))) {
+		decoder->SetPitch(pitch);
+		decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
+		decoder->SetVolume(0);
+		decoder->SetFade(volume, std::chrono::milliseconds(fadein));
+		decoder->SetLooping(true);
+		decoder->SetBalance(balance);
+		SetChannelDecoder(chan.decoder, chan.buffer, std::move(decoder));
 		chan.paused = false; // Unpause channel -> Play it.
 
 		return true;
 	} else {
+		SetChannelDecoder(chan.decoder, chan.buffer, nullptr);
 		Output::Warning("Couldn't play BGM {}. Format not supported", filestream.GetName());
 	}
 
@@ -292,16 +316,220 @@ bool GenericAudio::PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache>
 	chan.paused = true; // Pause channel so the audio thread doesn't work on it
 	chan.stopped = false; // Unstop channel so the audio thread doesn't delete it
 
-	chan.decoder = se->CreateSeDecoder();
-	chan.decoder->SetPitch(pitch);
-	chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
-	chan.decoder->SetVolume(volume);
-	chan.decoder->SetBalance(balance);
+	auto decoder = se->CreateSeDecoder(output_format.frequency, output_format.format, output_format.channels, pitch);
+	decoder->SetVolume(volume);
+	decoder->SetBalance(balance);
+	SetChannelDecoder(chan.decoder, chan.buffer, std::move(decoder));
 	chan.paused = false; // Unpause channel -> Play it.
 	return true;
 }
 
+void GenericAudio::SetChannelDecoder(std::unique_ptr<AudioDecoderBase>& chan_decoder, DecodeBuffer& buffer, std::unique_ptr<AudioDecoderBase> decoder) {
+	{
+		std::lock_guard<DecodeMutex> lock(buffer.mutex);
+		LockMutex();
+		// The old decoder is destroyed when leaving the function, outside of the locks
+		chan_decoder.swap(decoder);
+		if (chan_decoder && buffer.ring.Capacity() == 0) {
+			buffer.ring.Resize(ring_buffer_samples);
+		}
+		buffer.ring.Clear();
+		buffer.end_of_stream = false;
+		buffer.volume = 0.0f;
+		buffer.played_once = false;
+		UnlockMutex();
+	}
+
+#ifdef HAVE_THREADS
+	// Decode the beginning before the next audio callback
+	decode_thread_cv.notify_one();
+#endif
+}
+
+void GenericAudio::FillChannel(AudioDecoderBase& decoder, DecodeBuffer& buffer, bool is_bgm, size_t samples, DecodeScratch& scratch) {
+	if (buffer.end_of_stream) {
+		return;
+	}
+
+	samples = std::min(samples, buffer.ring.Capacity());
+	if (buffer.ring.ReadAvailable() >= samples) {
+		return;
+	}
+
+	Instrumentation::Scope iscope("Audio decode");
+
+	while (buffer.ring.ReadAvailable() < samples) {
+		int frequency = 0;
+		int channels = 0;
+		AudioDecoder::Format sampleformat;
+		decoder.GetFormat(frequency, sampleformat, channels);
+		const int samplesize = AudioDecoder::GetSamplesizeForFormat(sampleformat);
+
+		const size_t frames = std::min(buffer.ring.WriteAvailable() / 2, decode_chunk_frames);
+		if (frames == 0) {
+			break;
+		}
+
+		if (is_bgm) {
+			// Advances the fade in sync with the decoded samples
+			decoder.Update(std::chrono::microseconds(static_cast<int64_t>(frames) * 1000000 / frequency));
+		}
+
+		StereoVolume volume = decoder.GetVolume();
+		const float vleft = volume.left_volume / 100.0f;
+		const float vright = volume.right_volume / 100.0f;
+
+		const size_t bytes_to_read = frames * samplesize * channels;
+		if (scratch.raw.size() < bytes_to_read) {
+			scratch.raw.resize(bytes_to_read);
+		}
+
+		int read_bytes = decoder.Decode(scratch.raw.data(), bytes_to_read);
+		if (read_bytes <= 0) {
+			// An error occured when reading - the channel is faulty - discard
+			buffer.end_of_stream = true;
+			break;
+		}
+
+		// Convert to stereo floating point
+		const size_t read_frames = read_bytes / (samplesize * channels);
+		if (scratch.samples.size() < read_frames * 2) {
+			scratch.samples.resize(read_frames * 2);
+		}
+		AudioKernels::ToStereoFloat(scratch.raw.data(), sampleformat, channels, read_frames, vleft, vright, scratch.samples.data());
+		buffer.ring.Write(scratch.samples.data(), read_frames * 2);
+		buffer.volume = std::max(vleft, vright);
+
+		if (is_bgm) {
+			buffer.played_once = decoder.GetLoopCount() > 0;
+		} else if (decoder.IsFinished()) {
+			// SE are only played once
+			buffer.end_of_stream = true;
+			break;
+		}
+	}
+}
+
+bool GenericAudio::MixChannel(std::unique_ptr<AudioDecoderBase>& decoder, DecodeBuffer& buffer, bool is_bgm, bool stopped, float master_volume, int samples_per_frame, float& total_volume) {
+	if (stopped) {
+		ReleaseChannel(decoder, buffer);
+		return false;
+	}
+
+	const size_t samples = samples_per_frame * 2;
+	size_t mixed = buffer.ring.Read(channel_buffer.data(), samples);
+
+	if (mixed < samples && !buffer.end_of_stream) {
+		if (decode_thread_running) {
+			underrun_count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Decode the missing samples here. When the worker is decoding this
+		// channel right now the samples are missing from the output.
+		std::unique_lock<DecodeMutex> lock(buffer.mutex, std::try_to_lock);
+		if (lock.owns_lock()) {
+			while (mixed < samples) {
+				FillChannel(*decoder, buffer, is_bgm, samples - mixed, callback_scratch);
+				size_t read = buffer.ring.Read(channel_buffer.data() + mixed, samples - mixed);
+				if (read == 0) {
+					break;
+				}
+				mixed += read;
+			}
+		}
+	}
+
+	if (buffer.end_of_stream && buffer.ring.ReadAvailable() == 0) {
+		ReleaseChannel(decoder, buffer);
+	}
+
+	if (mixed == 0) {
+		return false;
+	}
+
+	total_volume += buffer.volume * master_volume;
+
+	AudioKernels::MixAdd(mixer_buffer.data(), channel_buffer.data(), mixed, master_volume);
+
+	return true;
+}
+
+void GenericAudio::ReleaseChannel(std::unique_ptr<AudioDecoderBase>& decoder, DecodeBuffer& buffer) {
+	// Retried on the next call when the worker uses the decoder
+	std::unique_lock<DecodeMutex> lock(buffer.mutex, std::try_to_lock);
+	if (!lock.owns_lock()) {
+		return;
+	}
+
+	decoder.reset();
+	buffer.ring.Clear();
+	buffer.end_of_stream = false;
+	buffer.played_once = false;
+}
+
+void GenericAudio::StartDecodeThread() {
+#ifdef HAVE_THREADS
+	decode_thread_stop = false;
+	decode_thread = std::thread(&GenericAudio::DecodeThreadFunction, this);
+	decode_thread_running = true;
+#endif
+}
+
+void GenericAudio::StopDecodeThread() {
+#ifdef HAVE_THREADS
+	if (!decode_thread_running) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(decode_thread_mutex);
+		decode_thread_stop = true;
+	}
+	decode_thread_cv.notify_one();
+	decode_thread.join();
+	decode_thread_running = false;
+#endif
+}
+
+void GenericAudio::DecodeThreadFunction() {
+#ifdef HAVE_THREADS
+	DecodeScratch scratch;
+
+	auto fill = [&](std::unique_ptr<AudioDecoderBase>& decoder, DecodeBuffer& buffer, bool is_bgm, size_t samples) {
+		// Channels that are changed right now are skipped
+		std::unique_lock<DecodeMutex> lock(buffer.mutex, std::try_to_lock);
+		if (lock.owns_lock() && decoder) {
+			FillChannel(*decoder, buffer, is_bgm, samples, scratch);
+		}
+	};
+
+	std::unique_lock<std::mutex> lock(decode_thread_mutex);
+	while (!decode_thread_stop) {
+		lock.unlock();
+
+		// Zero until the first audio callback announced its buffer size
+		const size_t samples = decode_ahead_samples.load(std::memory_order_relaxed);
+		if (samples > 0) {
+			for (auto& BGM_Channel : BGM_Channels) {
+				fill(BGM_Channel.decoder, BGM_Channel.buffer, true, samples);
+			}
+			for (auto& SE_Channel : SE_Channels) {
+				fill(SE_Channel.decoder, SE_Channel.buffer, false, samples);
+			}
+		}
+
+		lock.lock();
+		if (!decode_thread_stop) {
+			// Woken up by the audio callback and when a channel starts playing
+			decode_thread_cv.wait_for(lock, std::chrono::milliseconds(5));
+		}
+	}
+#endif
+}
+
 void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
+	Instrumentation::Scope iscope("Audio mix");
+
 	bool channel_active = false;
 	float total_volume = 0;
 	int samples_per_frame = buffer_length / output_format.channels / 2;
@@ -314,183 +542,42 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 	if (mixer_buffer.size() != (size_t)buffer_length) {
 		mixer_buffer.resize(buffer_length);
 	}
-	scrap_buffer_size = samples_per_frame * output_format.channels * sizeof(uint32_t);
-	if (scrap_buffer.size() != scrap_buffer_size) {
-		scrap_buffer.resize(scrap_buffer_size);
+	if (channel_buffer.size() != (size_t)(samples_per_frame * 2)) {
+		channel_buffer.resize(samples_per_frame * 2);
 	}
-	std::fill(mixer_buffer.begin(), mixer_buffer.end(), '\0');
+	std::fill(mixer_buffer.begin(), mixer_buffer.end(), 0.0f);
 
-	for (unsigned i = 0; i < nr_of_bgm_channels + nr_of_se_channels; i++) {
-		int read_bytes = 0;
-		int channels = 0;
-		int samplesize = 0;
-		int frequency = 0;
-		AudioDecoder::Format sampleformat;
-		float vleft, vright;
-
-		// Mix BGM and SE together;
-		bool is_bgm_channel = i < nr_of_bgm_channels;
-		bool channel_used = false;
-
-		if (is_bgm_channel) {
-			BgmChannel& currently_mixed_channel = BGM_Channels[i];
-			float current_master_volume = cfg.music_volume.Get() / 100.0f;
-
-			if (currently_mixed_channel.decoder && !currently_mixed_channel.paused) {
-				if (currently_mixed_channel.stopped) {
-					currently_mixed_channel.decoder.reset();
-				} else {
-					StereoVolume volume = currently_mixed_channel.decoder->GetVolume();
-					vleft = volume.left_volume / 100.0f * current_master_volume;
-					vright = volume.right_volume / 100.0f * current_master_volume;
-					currently_mixed_channel.decoder->GetFormat(frequency, sampleformat, channels);
-					currently_mixed_channel.decoder->Update(std::chrono::milliseconds(samples_per_frame * 1000 / frequency));
-					samplesize = AudioDecoder::GetSamplesizeForFormat(sampleformat);
-
-					total_volume += std::max(vleft, vright);
-
-					// determine how much data has to be read from this channel (but cap at the bounds of the scrap buffer)
-					unsigned bytes_to_read = (samplesize * channels * samples_per_frame);
-					bytes_to_read = (bytes_to_read < scrap_buffer_size) ? bytes_to_read : scrap_buffer_size;
-
-					read_bytes = currently_mixed_channel.decoder->Decode(scrap_buffer.data(), bytes_to_read);
-
-					if (read_bytes <= 0) {
-						// An error occured when reading - the channel is faulty - discard
-						currently_mixed_channel.decoder.reset();
-						continue; // skip this loop run - there is nothing to mix
-					}
-
-					if (!currently_mixed_channel.stopped) {
-						BGM_PlayedOnceIndicator = currently_mixed_channel.decoder->GetLoopCount() > 0;
-					}
-
-					channel_used = true;
-				}
-			}
-		} else {
-			SeChannel& currently_mixed_channel = SE_Channels[i - nr_of_bgm_channels];
-			float current_master_volume = cfg.sound_volume.Get() / 100.0f;
-
-			if (currently_mixed_channel.decoder && !currently_mixed_channel.paused) {
-				if (currently_mixed_channel.stopped) {
-					currently_mixed_channel.decoder.reset();
-				} else {
-					StereoVolume volume = currently_mixed_channel.decoder->GetVolume();
-					vleft = volume.left_volume / 100.0f * current_master_volume;
-					vright = volume.right_volume / 100.0f * current_master_volume;
-					currently_mixed_channel.decoder->GetFormat(frequency, sampleformat, channels);
-					samplesize = AudioDecoder::GetSamplesizeForFormat(sampleformat);
-
-					total_volume += std::max(vleft, vright);
-
-					// determine how much data has to be read from this channel (but cap at the bounds of the scrap buffer)
-					unsigned bytes_to_read = (samplesize * channels * samples_per_frame);
-					bytes_to_read = (bytes_to_read < scrap_buffer_size) ? bytes_to_read : scrap_buffer_size;
-
-					read_bytes = currently_mixed_channel.decoder->Decode(scrap_buffer.data(), bytes_to_read);
-
-					if (read_bytes <= 0) {
-						// An error occured when reading - the channel is faulty - discard
-						currently_mixed_channel.decoder.reset();
-						continue; // skip this loop run - there is nothing to mix
-					}
-
-					// Now decide what to do when a channel has reached its end
-					if (currently_mixed_channel.decoder->IsFinished()) {
-						// SE are only played once so free the se if finished
-						currently_mixed_channel.decoder.reset();
-					}
-
-					channel_used = true;
-				}
-			}
-		}
-
-		//--------------------------------------------------------------------------------------------------------------------//
-		// From here downwards the currently_mixed_channel decoder may already be freed - so don't use it below this comment. //
-		//--------------------------------------------------------------------------------------------------------------------//
-
-		if (channel_used) {
-			for (unsigned ii = 0; ii < (unsigned)(read_bytes / (samplesize * channels)); ii++) {
-
-				float vall = vleft;
-				float valr = vright;
-
-				// Convert to floating point
-				switch (sampleformat) {
-					case AudioDecoder::Format::S8:
-						vall *= (((int8_t *) scrap_buffer.data())[ii * channels] / 128.0);
-						valr *= (((int8_t *) scrap_buffer.data())[ii * channels + 1] / 128.0);
-						break;
-					case AudioDecoder::Format::U8:
-						vall *= (((uint8_t *) scrap_buffer.data())[ii * channels] / 128.0 - 1.0);
-						valr *= (((uint8_t *) scrap_buffer.data())[ii * channels + 1] / 128.0 - 1.0);
-						break;
-					case AudioDecoder::Format::S16:
-						vall *= (((int16_t *) scrap_buffer.data())[ii * channels] / 32768.0);
-						valr *= (((int16_t *) scrap_buffer.data())[ii * channels + 1] / 32768.0);
-						break;
-					case AudioDecoder::Format::U16:
-						vall *= (((uint16_t *) scrap_buffer.data())[ii * channels] / 32768.0 - 1.0);
-						valr *= (((uint16_t *) scrap_buffer.data())[ii * channels + 1] / 32768.0 - 1.0);
-						break;
-					case AudioDecoder::Format::S32:
-						vall *= (((int32_t *) scrap_buffer.data())[ii * channels] / 2147483648.0);
-						valr *= (((int32_t *) scrap_buffer.data())[ii * channels + 1] / 2147483648.0);
-						break;
-					case AudioDecoder::Format::U32:
-						vall *= (((uint32_t *) scrap_buffer.data())[ii * channels] / 2147483648.0 - 1.0);
-						valr *= (((uint32_t *) scrap_buffer.data())[ii * channels + 1] / 2147483648.0 - 1.0);
-						break;
-					case AudioDecoder::Format::F32:
-						vall *= (((float *) scrap_buffer.data())[ii * channels]);
-						valr *= (((float *) scrap_buffer.data())[ii * channels + 1]);
-						break;
-				}
+	// The worker keeps two callbacks worth of samples decoded
+	decode_ahead_samples.store(std::min<size_t>(samples_per_frame * 2 * 2, ring_buffer_samples), std::memory_order_relaxed);
 
-				if (!channel_active) {
-					// first channel
-					mixer_buffer[ii * output_format.channels] = vall;
-					if (channels > 1) {
-						mixer_buffer[ii * output_format.channels + 1] = valr;
-					} else {
-						mixer_buffer[ii * output_format.channels + 1] = mixer_buffer[ii * output_format.channels];
-					}
-				} else {
-					mixer_buffer[ii * output_format.channels] += vall;
-					if (channels > 1) {
-						mixer_buffer[ii * output_format.channels + 1] += valr;
-					} else {
-						mixer_buffer[ii * output_format.channels + 1] = mixer_buffer[ii * output_format.channels];
-					}
-				}
+	// Mix BGM and SE together
+	const float music_volume = cfg.music_volume.Get() / 100.0f;
+	for (auto& BGM_Channel : BGM_Channels) {
+		if (BGM_Channel.decoder && !BGM_Channel.paused) {
+			bool stopped = BGM_Channel.stopped;
+			channel_active |= MixChannel(BGM_Channel.decoder, BGM_Channel.buffer, true, stopped, music_volume, samples_per_frame, total_volume);
 
+			if (!stopped) {
+				BGM_PlayedOnceIndicator = BGM_Channel.buffer.played_once.load();
 			}
-			channel_active = true;
 		}
 	}
 
-	if (channel_active) {
-		if (total_volume > 1.0) {
-			float threshold = 0.8f;
-			for (unsigned i = 0; i < (unsigned)(samples_per_frame * 2); i++) {
-				float sample = mixer_buffer[i];
-				float sign = (sample < 0) ? -1.0 : 1.0;
-				sample /= sign;
-				//dynamic range compression
-				if (sample > threshold) {
-					sample_buffer[i] = sign * 32768.0 * (threshold + (1.0 - threshold) * (sample - threshold) / (total_volume - threshold));
-				} else {
-					sample_buffer[i] = sign * sample * 32768.0;
-				}
-			}
-		} else {
-			//No dynamic range compression necessary
-			for (unsigned i = 0; i < (unsigned)(samples_per_frame * 2); i++) {
-				sample_buffer[i] = mixer_buffer[i] * 32768.0;
-			}
+	const float sound_volume = cfg.sound_volume.Get() / 100.0f;
+	for (auto& SE_Channel : SE_Channels) {
+		if (SE_Channel.decoder && !SE_Channel.paused) {
+			channel_active |= MixChannel(SE_Channel.decoder, SE_Channel.buffer, false, SE_Channel.stopped, sound_volume, samples_per_frame, total_volume);
 		}
+	}
+
+#ifdef HAVE_THREADS
+	// Refill the consumed samples
+	decode_thread_cv.notify_one();
+#endif
+
+	if (channel_active) {
+		// Dynamic range compression when the channels are louder than 1
+		AudioKernels::MixToS16(mixer_buffer.data(), sample_buffer.data(), samples_per_frame * 2, total_volume);
 
 		memcpy(output_buffer, sample_buffer.data(), buffer_length);
 	} else {
@@ -499,14 +586,23 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 }
 
 void GenericAudio::BgmChannel::Stop() {
+	// Destroyed outside of the locks
+	std::unique_ptr<AudioDecoderBase> old_decoder;
+
+	std::lock_guard<DecodeMutex> lock(buffer.mutex);
+	instance->LockMutex();
 	stopped = true;
 	if (midi_out_used) {
 		midi_out_used = false;
 		instance->midi_thread->GetMidiOut().Reset();
 		instance->midi_thread->GetMidiOut().Pause();
 	} else if (decoder) {
-		decoder.reset();
+		old_decoder = std::move(decoder);
+		buffer.ring.Clear();
+		buffer.end_of_stream = false;
+		buffer.played_once = false;
 	}
+	instance->UnlockMutex();
 }
 
 void GenericAudio::BgmChannel::SetPaused(bool newPaused) {
@@ -522,41 +618,69 @@ void GenericAudio::BgmChannel::SetPaused(bool newPaused) {
 
 int GenericAudio::BgmChannel::GetTicks() const {
 	if (midi_out_used) {
-		return instance->midi_thread->GetMidiOut().GetTicks();
-	} else if (decoder) {
-		return decoder->GetTicks();
+		instance->LockMutex();
+		int ticks = instance->midi_thread->GetMidiOut().GetTicks();
+		instance->UnlockMutex();
+		return ticks;
 	}
-	return -1;
+
+	// Only the decoder mutex, waiting for the worker must not block the audio callback
+	std::lock_guard<DecodeMutex> lock(buffer.mutex);
+	return decoder ? decoder->GetTicks() : -1;
 }
 
 void GenericAudio::BgmChannel::SetFade(int fade) {
 	if (midi_out_used) {
+		instance->LockMutex();
 		instance->midi_thread->GetMidiOut().SetFade(0, std::chrono::milliseconds(fade));
-	} else if (decoder) {
+		instance->UnlockMutex();
+		return;
+	}
+
+	std::lock_guard<DecodeMutex> lock(buffer.mutex);
+	if (decoder) {
 		decoder->SetFade(0, std::chrono::milliseconds(fade));
 	}
 }
 
 void GenericAudio::BgmChannel::SetVolume(int volume) {
 	if (midi_out_used) {
+		instance->LockMutex();
 		instance->midi_thread->GetMidiOut().SetVolume(volume);
-	} else if (decoder) {
+		instance->UnlockMutex();
+		return;
+	}
+
+	std::lock_guard<DecodeMutex> lock(buffer.mutex);
+	if (decoder) {
 		decoder->SetVolume(volume);
 	}
 }
 
 void GenericAudio::BgmChannel::SetPitch(int pitch) {
 	if (midi_out_used) {
+		instance->LockMutex();
 		instance->midi_thread->GetMidiOut().SetPitch(pitch);
-	} else if (decoder) {
+		instance->UnlockMutex();
+		return;
+	}
+
+	std::lock_guard<DecodeMutex> lock(buffer.mutex);
+	if (decoder) {
 		decoder->SetPitch(pitch);
 	}
 }
 
 void GenericAudio::BgmChannel::SetBalance(int balance) {
 	if (midi_out_used) {
+		instance->LockMutex();
 		instance->midi_thread->GetMidiOut().SetBalance(balance);
-	} else if (decoder) {
+		instance->UnlockMutex();
+		return;
+	}
+
+	std::lock_guard<DecodeMutex> lock(buffer.mutex);
+	if (decoder) {
 		decoder->SetBalance(balance);
 	}
 }
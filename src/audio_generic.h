@@ -22,7 +22,17 @@
 #include "audio_secache.h"
 #include "audio_decoder_base.h"
 #include "audio_generic_midiout.h"
+#include "audio_ring_buffer.h"
+#include "game_clock.h"
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+
+#ifdef HAVE_THREADS
+#  include <condition_variable>
+#  include <thread>
+#endif
 
 /**
  * A software implementation for handling EasyRPG Audio utilizing the
@@ -37,11 +47,16 @@
  * 4. Implement LockMutex and UnlockMutex. Locking and Unlocking when
  *    calling Decode must be done manually.
  * 5. Implement update function (optional)
+ *
+ * When the build has thread support the BGM and SE decoders run on a worker
+ * thread that decodes ahead into a ring buffer per channel. Decode then only
+ * mixes already decoded samples and decodes in the callback only when a ring
+ * buffer ran empty (an underrun).
  */
 class GenericAudio : public AudioInterface {
 public:
 	GenericAudio(const Game_ConfigAudio& cfg);
-	virtual ~GenericAudio() = default;
+	virtual ~GenericAudio();
 
 	void BGM_Play(Filesystem_Stream::InputStream stream, int volume, int pitch, int fadein, int balance) override;
 	void BGM_Pause() override;
@@ -71,7 +86,50 @@ public:
 
 	void Decode(uint8_t* output_buffer, int buffer_length);
 
+	/**
+	 * @return how often a channel ran out of decoded samples during Decode
+	 *   since the audio system was created
+	 */
+	uint32_t GetUnderrunCount() const;
+
 private:
+#ifdef HAVE_THREADS
+	using DecodeMutex = std::mutex;
+#else
+	struct DecodeMutex {
+		void lock() {}
+		void unlock() {}
+		bool try_lock() { return true; }
+	};
+#endif
+
+	/**
+	 * Decoded samples of a channel.
+	 * The decoder of a channel is only accessed while holding the mutex.
+	 * The decoder pointer is only changed while holding the mutex and the
+	 * audio mutex (LockMutex), so the audio callback can check it.
+	 * The mutex is always locked before the audio mutex. While holding the
+	 * audio mutex it is only try-locked: the worker holds it during a whole
+	 * decode, which must not stall the audio callback.
+	 */
+	struct DecodeBuffer {
+		/** Stereo float samples with the channel volume applied, producer is the decode worker */
+		AudioRingBuffer ring;
+		mutable DecodeMutex mutex;
+		/** The decoder finished or failed, nothing will be added to the ring anymore */
+		std::atomic<bool> end_of_stream = { false };
+		/** Louder side of the channel volume of the last decoded samples */
+		std::atomic<float> volume = { 0.0f };
+		/** The BGM decoder looped at least once */
+		std::atomic<bool> played_once = { false };
+	};
+
+	/** Temporary buffers used while decoding */
+	struct DecodeScratch {
+		std::vector<uint8_t> raw;
+		std::vector<float> samples;
+	};
+
 	struct BgmChannel {
 		int id;
 		std::unique_ptr<AudioDecoderBase> decoder;
@@ -79,6 +137,7 @@ private:
 		bool paused;
 		bool stopped;
 		bool midi_out_used = false;
+		DecodeBuffer buffer;
 		void Stop();
 		void SetPaused(bool newPaused);
 		int GetTicks() const;
@@ -94,6 +153,7 @@ private:
 		GenericAudio* instance = nullptr;
 		bool paused;
 		bool stopped;
+		DecodeBuffer buffer;
 	};
 	struct Format {
 		int frequency;
@@ -105,17 +165,64 @@ private:
 	bool PlayOnChannel(BgmChannel& chan, Filesystem_Stream::InputStream stream, int volume, int pitch, int fadein, int balance);
 	bool PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance);
 
+	/**
+	 * Replaces the decoder of a channel and discards the decoded samples.
+	 * Must be called without holding the audio mutex.
+	 */
+	void SetChannelDecoder(std::unique_ptr<AudioDecoderBase>& chan_decoder, DecodeBuffer& buffer, std::unique_ptr<AudioDecoderBase> decoder);
+
+	/**
+	 * Decodes samples of a channel into its ring buffer.
+	 * The caller must hold the mutex of the buffer.
+	 *
+	 * @param decoder decoder of the channel
+	 * @param buffer buffer of the channel
+	 * @param is_bgm whether this is a BGM channel
+	 * @param samples number of samples the ring buffer shall hold afterwards
+	 * @param scratch temporary buffers of the calling thread
+	 */
+	void FillChannel(AudioDecoderBase& decoder, DecodeBuffer& buffer, bool is_bgm, size_t samples, DecodeScratch& scratch);
+
+	/**
+	 * Mixes the decoded samples of a channel into the mixer buffer.
+	 * Called by Decode.
+	 *
+	 * @return whether samples were mixed
+	 */
+	bool MixChannel(std::unique_ptr<AudioDecoderBase>& decoder, DecodeBuffer& buffer, bool is_bgm, bool stopped, float master_volume, int samples_per_frame, float& total_volume);
+
+	/** Releases the decoder of a channel that finished or was stopped, when the decoder is not in use */
+	void ReleaseChannel(std::unique_ptr<AudioDecoderBase>& decoder, DecodeBuffer& buffer);
+
+	void StartDecodeThread();
+	void StopDecodeThread();
+	void DecodeThreadFunction();
+
 	static constexpr unsigned nr_of_se_channels = 31;
 	static constexpr unsigned nr_of_bgm_channels = 2;
 
 	BgmChannel BGM_Channels[nr_of_bgm_channels];
 	SeChannel SE_Channels[nr_of_se_channels];
-	mutable bool BGM_PlayedOnceIndicator;
+	mutable std::atomic<bool> BGM_PlayedOnceIndicator;
 
 	std::vector<int16_t> sample_buffer = {};
-	std::vector<uint8_t> scrap_buffer = {};
-	unsigned scrap_buffer_size = 0;
+	std::vector<float> channel_buffer = {};
 	std::vector<float> mixer_buffer = {};
+	DecodeScratch callback_scratch;
+
+	/** Number of samples the decode worker keeps in each ring buffer */
+	std::atomic<size_t> decode_ahead_samples = { 0 };
+	std::atomic<uint32_t> underrun_count = { 0 };
+	uint32_t reported_underrun_count = 0;
+	Game_Clock::time_point underrun_report_time;
+	bool decode_thread_running = false;
+
+#ifdef HAVE_THREADS
+	std::thread decode_thread;
+	std::mutex decode_thread_mutex;
+	std::condition_variable decode_thread_cv;
+	bool decode_thread_stop = false;
+#endif
 
 	std::unique_ptr<GenericAudioMidiOut> midi_thread;
 };
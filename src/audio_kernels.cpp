@@ -0,0 +1,466 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include "audio_kernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EP_KERNELS_SSE2
+#  include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define EP_KERNELS_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace AudioKernels {
+
+namespace {
+
+using Format = AudioDecoderBase::Format;
+
+template <Format F>
+using FormatTag = std::integral_constant<Format, F>;
+
+/** Dynamic range compression starts at this sample value */
+constexpr float compression_threshold = 0.8f;
+
+Isa DetectIsa() {
+#if defined(EP_KERNELS_SSE2)
+	return Isa::SSE2;
+#elif defined(EP_KERNELS_NEON)
+	return Isa::NEON;
+#else
+	return Isa::Scalar;
+#endif
+}
+
+std::atomic<Isa>& CurrentIsa() {
+	static std::atomic<Isa> isa(DetectIsa());
+	return isa;
+}
+
+/** Invokes the kernel with a FormatTag of the format */
+template <typename Kernel>
+void WithFormat(Format format, Kernel&& kernel) {
+	switch (format) {
+		case Format::S8:
+			kernel(FormatTag<Format::S8>());
+			return;
+		case Format::U8:
+			kernel(FormatTag<Format::U8>());
+			return;
+		case Format::S16:
+			kernel(FormatTag<Format::S16>());
+			return;
+		case Format::U16:
+			kernel(FormatTag<Format::U16>());
+			return;
+		case Format::S32:
+			kernel(FormatTag<Format::S32>());
+			return;
+		case Format::U32:
+			kernel(FormatTag<Format::U32>());
+			return;
+		case Format::F32:
+			kernel(FormatTag<Format::F32>());
+			return;
+	}
+}
+
+// All integer formats are converted by flipping the sign bit of unsigned
+// samples and scaling with a power of two. This is exact, so the vector
+// kernels produce the same floats as the scalar code.
+template <Format F>
+inline float LoadSample(const uint8_t* data, size_t index) {
+	switch (F) {
+		case Format::S8:
+			return reinterpret_cast<const int8_t*>(data)[index] * (1.0f / 128);
+		case Format::U8:
+			return (reinterpret_cast<const uint8_t*>(data)[index] - 128) * (1.0f / 128);
+		case Format::S16:
+			return reinterpret_cast<const int16_t*>(data)[index] * (1.0f / 32768);
+		case Format::U16:
+			return (reinterpret_cast<const uint16_t*>(data)[index] - 32768) * (1.0f / 32768);
+		case Format::S32:
+			return static_cast<float>(reinterpret_cast<const int32_t*>(data)[index]) * (1.0f / 2147483648.0f);
+		case Format::U32:
+			return static_cast<float>(static_cast<int32_t>(reinterpret_cast<const uint32_t*>(data)[index] ^ 0x80000000u)) * (1.0f / 2147483648.0f);
+		case Format::F32:
+			return reinterpret_cast<const float*>(data)[index];
+	}
+	return 0.0f;
+}
+
+/** Converts the frames [i, frames), used for the scalar code and the remainder of the vector kernels */
+template <Format F>
+inline void ToStereoFloatRow(const uint8_t* data, int channels, size_t i, size_t frames, float left_volume, float right_volume, float* out) {
+	for (; i < frames; ++i) {
+		float left = LoadSample<F>(data, i * channels);
+		float right = channels > 1 ? LoadSample<F>(data, i * channels + 1) : left;
+		out[i * 2] = left * left_volume;
+		out[i * 2 + 1] = right * right_volume;
+	}
+}
+
+inline void MixAddRow(float* mix, const float* samples, size_t i, size_t count, float volume) {
+	for (; i < count; ++i) {
+		mix[i] += samples[i] * volume;
+	}
+}
+
+inline void MixToS16Row(const float* mix, int16_t* out, size_t i, size_t count, bool compress, float compression) {
+	for (; i < count; ++i) {
+		float sample = mix[i];
+		if (compress) {
+			float magnitude = std::fabs(sample);
+			if (magnitude > compression_threshold) {
+				sample = std::copysign(compression_threshold + (magnitude - compression_threshold) * compression, sample);
+			}
+		}
+		sample = std::min(std::max(sample * 32768.0f, -32768.0f), 32767.0f);
+		out[i] = static_cast<int16_t>(sample);
+	}
+}
+
+#if defined(EP_KERNELS_SSE2)
+/** Loads 4 samples starting at index */
+template <Format F>
+inline __m128 LoadSSE2(const uint8_t* data, size_t index) {
+	__m128i v;
+	float scale = 1.0f;
+	switch (F) {
+		case Format::S8:
+		case Format::U8: {
+			int32_t raw;
+			std::memcpy(&raw, data + index, sizeof(raw));
+			v = _mm_cvtsi32_si128(raw);
+			if (F == Format::U8) {
+				v = _mm_xor_si128(v, _mm_set1_epi8(static_cast<char>(0x80)));
+			}
+			v = _mm_unpacklo_epi8(v, v);
+			v = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 24);
+			scale = 1.0f / 128;
+			break;
+		}
+		case Format::S16:
+		case Format::U16:
+			v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + index * 2));
+			if (F == Format::U16) {
+				v = _mm_xor_si128(v, _mm_set1_epi16(static_cast<short>(0x8000)));
+			}
+			v = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+			scale = 1.0f / 32768;
+			break;
+		case Format::S32:
+		case Format::U32:
+			v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index * 4));
+			if (F == Format::U32) {
+				v = _mm_xor_si128(v, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+			}
+			scale = 1.0f / 2147483648.0f;
+			break;
+		case Format::F32:
+			return _mm_loadu_ps(reinterpret_cast<const float*>(data) + index);
+	}
+	return _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(scale));
+}
+
+template <Format F>
+void ToStereoFloatSSE2(const uint8_t* data, int channels, size_t frames, float left_volume, float right_volume, float* out) {
+	const __m128 volume = _mm_setr_ps(left_volume, right_volume, left_volume, right_volume);
+	size_t i = 0;
+
+	if (channels == 2) {
+		for (; i + 2 <= frames; i += 2) {
+			_mm_storeu_ps(out + i * 2, _mm_mul_ps(LoadSSE2<F>(data, i * 2), volume));
+		}
+	} else if (channels == 1) {
+		for (; i + 4 <= frames; i += 4) {
+			__m128 v = LoadSSE2<F>(data, i);
+			_mm_storeu_ps(out + i * 2, _mm_mul_ps(_mm_unpacklo_ps(v, v), volume));
+			_mm_storeu_ps(out + i * 2 + 4, _mm_mul_ps(_mm_unpackhi_ps(v, v), volume));
+		}
+	}
+
+	ToStereoFloatRow<F>(data, channels, i, frames, left_volume, right_volume, out);
+}
+
+void MixAddSSE2(float* mix, const float* samples, size_t count, float volume) {
+	const __m128 vol = _mm_set1_ps(volume);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128 a = _mm_add_ps(_mm_loadu_ps(mix + i), _mm_mul_ps(_mm_loadu_ps(samples + i), vol));
+		__m128 b = _mm_add_ps(_mm_loadu_ps(mix + i + 4), _mm_mul_ps(_mm_loadu_ps(samples + i + 4), vol));
+		_mm_storeu_ps(mix + i, a);
+		_mm_storeu_ps(mix + i + 4, b);
+	}
+	MixAddRow(mix, samples, i, count, volume);
+}
+
+void MixToS16SSE2(const float* mix, int16_t* out, size_t count, bool compress, float compression) {
+	const __m128 sign_mask = _mm_set1_ps(-0.0f);
+	const __m128 threshold = _mm_set1_ps(compression_threshold);
+	const __m128 factor = _mm_set1_ps(compression);
+	const __m128 scale = _mm_set1_ps(32768.0f);
+	const __m128 min = _mm_set1_ps(-32768.0f);
+	const __m128 max = _mm_set1_ps(32767.0f);
+
+	auto convert = [&](__m128 sample) {
+		if (compress) {
+			__m128 sign = _mm_and_ps(sample, sign_mask);
+			__m128 magnitude = _mm_andnot_ps(sign_mask, sample);
+			__m128 compressed = _mm_add_ps(threshold, _mm_mul_ps(_mm_sub_ps(magnitude, threshold), factor));
+			__m128 above = _mm_cmpgt_ps(magnitude, threshold);
+			magnitude = _mm_or_ps(_mm_and_ps(above, compressed), _mm_andnot_ps(above, magnitude));
+			sample = _mm_or_ps(magnitude, sign);
+		}
+		sample = _mm_min_ps(_mm_max_ps(_mm_mul_ps(sample, scale), min), max);
+		return _mm_cvttps_epi32(sample);
+	};
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i a = convert(_mm_loadu_ps(mix + i));
+		__m128i b = convert(_mm_loadu_ps(mix + i + 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+	}
+	MixToS16Row(mix, out, i, count, compress, compression);
+}
+#endif
+
+#if defined(EP_KERNELS_NEON)
+/** Loads 4 samples starting at index */
+template <Format F>
+inline float32x4_t LoadNEON(const uint8_t* data, size_t index) {
+	int32x4_t v;
+	float scale = 1.0f;
+	switch (F) {
+		case Format::S8:
+		case Format::U8: {
+			uint32_t raw;
+			std::memcpy(&raw, data + index, sizeof(raw));
+			if (F == Format::U8) {
+				raw ^= 0x80808080u;
+			}
+			int16x8_t wide = vmovl_s8(vreinterpret_s8_u32(vdup_n_u32(raw)));
+			v = vmovl_s16(vget_low_s16(wide));
+			scale = 1.0f / 128;
+			break;
+		}
+		case Format::S16:
+		case Format::U16: {
+			uint16x4_t raw = vld1_u16(reinterpret_cast<const uint16_t*>(data) + index);
+			if (F == Format::U16) {
+				raw = veor_u16(raw, vdup_n_u16(0x8000));
+			}
+			v = vmovl_s16(vreinterpret_s16_u16(raw));
+			scale = 1.0f / 32768;
+			break;
+		}
+		case Format::S32:
+		case Format::U32: {
+			uint32x4_t raw = vld1q_u32(reinterpret_cast<const uint32_t*>(data) + index);
+			if (F == Format::U32) {
+				raw = veorq_u32(raw, vdupq_n_u32(0x80000000u));
+			}
+			v = vreinterpretq_s32_u32(raw);
+			scale = 1.0f / 2147483648.0f;
+			break;
+		}
+		case Format::F32:
+			return vld1q_f32(reinterpret_cast<const float*>(data) + index);
+	}
+	return vmulq_n_f32(vcvtq_f32_s32(v), scale);
+}
+
+template <Format F>
+void ToStereoFloatNEON(const uint8_t* data, int channels, size_t frames, float left_volume, float right_volume, float* out) {
+	const float volume_lanes[] = { left_volume, right_volume, left_volume, right_volume };
+	const float32x4_t volume = vld1q_f32(volume_lanes);
+	size_t i = 0;
+
+	if (channels == 2) {
+		for (; i + 2 <= frames; i += 2) {
+			vst1q_f32(out + i * 2, vmulq_f32(LoadNEON<F>(data, i * 2), volume));
+		}
+	} else if (channels == 1) {
+		for (; i + 4 <= frames; i += 4) {
+			float32x4_t v = LoadNEON<F>(data, i);
+			float32x4x2_t dup = vzipq_f32(v, v);
+			vst1q_f32(out + i * 2, vmulq_f32(dup.val[0], volume));
+			vst1q_f32(out + i * 2 + 4, vmulq_f32(dup.val[1], volume));
+		}
+	}
+
+	ToStereoFloatRow<F>(data, channels, i, frames, left_volume, right_volume, out);
+}
+
+void MixAddNEON(float* mix, const float* samples, size_t count, float volume) {
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		float32x4_t a = vaddq_f32(vld1q_f32(mix + i), vmulq_n_f32(vld1q_f32(samples + i), volume));
+		float32x4_t b = vaddq_f32(vld1q_f32(mix + i + 4), vmulq_n_f32(vld1q_f32(samples + i + 4), volume));
+		vst1q_f32(mix + i, a);
+		vst1q_f32(mix + i + 4, b);
+	}
+	MixAddRow(mix, samples, i, count, volume);
+}
+
+void MixToS16NEON(const float* mix, int16_t* out, size_t count, bool compress, float compression) {
+	const uint32x4_t sign_mask = vdupq_n_u32(0x80000000u);
+	const float32x4_t threshold = vdupq_n_f32(compression_threshold);
+	const float32x4_t min = vdupq_n_f32(-32768.0f);
+	const float32x4_t max = vdupq_n_f32(32767.0f);
+
+	auto convert = [&](float32x4_t sample) {
+		if (compress) {
+			uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(sample), sign_mask);
+			float32x4_t magnitude = vabsq_f32(sample);
+			float32x4_t compressed = vaddq_f32(threshold, vmulq_n_f32(vsubq_f32(magnitude, threshold), compression));
+			magnitude = vbslq_f32(vcgtq_f32(magnitude, threshold), compressed, magnitude);
+			sample = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(magnitude), sign));
+		}
+		sample = vminq_f32(vmaxq_f32(vmulq_n_f32(sample, 32768.0f), min), max);
+		return vcvtq_s32_f32(sample);
+	};
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		int32x4_t a = convert(vld1q_f32(mix + i));
+		int32x4_t b = convert(vld1q_f32(mix + i + 4));
+		vst1q_s16(out + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+	}
+	MixToS16Row(mix, out, i, count, compress, compression);
+}
+#endif
+
+} // anonymous namespace
+
+Isa GetIsa() {
+	return CurrentIsa().load(std::memory_order_relaxed);
+}
+
+bool SetIsa(Isa isa) {
+	if (!IsSupported(isa)) {
+		return false;
+	}
+
+	CurrentIsa().store(isa, std::memory_order_relaxed);
+	return true;
+}
+
+bool IsSupported(Isa isa) {
+	switch (isa) {
+		case Isa::Scalar:
+			return true;
+		case Isa::SSE2:
+#if defined(EP_KERNELS_SSE2)
+			return true;
+#else
+			return false;
+#endif
+		case Isa::NEON:
+#if defined(EP_KERNELS_NEON)
+			return true;
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+const char* GetIsaName(Isa isa) {
+	switch (isa) {
+		case Isa::Scalar:
+			return "Scalar";
+		case Isa::SSE2:
+			return "SSE2";
+		case Isa::NEON:
+			return "NEON";
+	}
+	return "Unknown";
+}
+
+void ToStereoFloat(const uint8_t* data, AudioDecoderBase::Format format, int channels, size_t frames, float left_volume, float right_volume, float* out) {
+	const Isa isa = GetIsa();
+	WithFormat(format, [&](auto tag) {
+		constexpr Format F = decltype(tag)::value;
+		switch (isa) {
+#if defined(EP_KERNELS_SSE2)
+			case Isa::SSE2:
+				ToStereoFloatSSE2<F>(data, channels, frames, left_volume, right_volume, out);
+				return;
+#endif
+#if defined(EP_KERNELS_NEON)
+			case Isa::NEON:
+				ToStereoFloatNEON<F>(data, channels, frames, left_volume, right_volume, out);
+				return;
+#endif
+			default:
+				ToStereoFloatRow<F>(data, channels, 0, frames, left_volume, right_volume, out);
+				return;
+		}
+	});
+}
+
+void MixAdd(float* mix, const float* samples, size_t count, float volume) {
+	switch (GetIsa()) {
+#if defined(EP_KERNELS_SSE2)
+		case Isa::SSE2:
+			MixAddSSE2(mix, samples, count, volume);
+			return;
+#endif
+#if defined(EP_KERNELS_NEON)
+		case Isa::NEON:
+			MixAddNEON(mix, samples, count, volume);
+			return;
+#endif
+		default:
+			MixAddRow(mix, samples, 0, count, volume);
+			return;
+	}
+}
+
+void MixToS16(const float* mix, int16_t* out, size_t count, float total_volume) {
+	const bool compress = total_volume > 1.0f;
+	const float compression = compress ? (1.0f - compression_threshold) / (total_volume - compression_threshold) : 1.0f;
+
+	switch (GetIsa()) {
+#if defined(EP_KERNELS_SSE2)
+		case Isa::SSE2:
+			MixToS16SSE2(mix, out, count, compress, compression);
+			return;
+#endif
+#if defined(EP_KERNELS_NEON)
+		case Isa::NEON:
+			MixToS16NEON(mix, out, count, compress, compression);
+			return;
+#endif
+		default:
+			MixToS16Row(mix, out, 0, count, compress, compression);
+			return;
+	}
+}
+
+} // namespace AudioKernels
@@ -0,0 +1,105 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_KERNELS_H
+#define EP_AUDIO_KERNELS_H
+
+// Headers
+#include <cstddef>
+#include <cstdint>
+#include "audio_decoder_base.h"
+
+/**
+ * Sample loops of the GenericAudio mixer.
+ *
+ * The fastest implementation supported by the CPU is selected on first use,
+ * SetIsa can override this for testing and benchmarks.
+ */
+namespace AudioKernels {
+
+/** Instruction set used by the kernels */
+enum class Isa {
+	Scalar,
+	SSE2,
+	NEON
+};
+
+/**
+ * @return instruction set used by the kernels
+ */
+Isa GetIsa();
+
+/**
+ * Overrides the instruction set used by the kernels.
+ *
+ * @param isa instruction set
+ * @return false when the isa is not supported by the build
+ */
+bool SetIsa(Isa isa);
+
+/**
+ * @param isa instruction set
+ * @return whether the isa is supported by the build
+ */
+bool IsSupported(Isa isa);
+
+/**
+ * @param isa instruction set
+ * @return name of the instruction set
+ */
+const char* GetIsaName(Isa isa);
+
+/**
+ * Converts decoded samples to interleaved stereo floats in the range [-1, 1]
+ * and applies the volume.
+ * Mono samples are used for both sides, additional channels are ignored.
+ *
+ * @param data decoded samples
+ * @param format format of the samples
+ * @param channels number of channels
+ * @param frames number of frames (samples per channel)
+ * @param left_volume volume of the left side
+ * @param right_volume volume of the right side
+ * @param out destination, receives frames * 2 samples
+ */
+void ToStereoFloat(const uint8_t* data, AudioDecoderBase::Format format, int channels, size_t frames, float left_volume, float right_volume, float* out);
+
+/**
+ * Adds samples multiplied with a volume to the mixer.
+ *
+ * @param mix mixer samples
+ * @param samples samples to add
+ * @param count number of samples
+ * @param volume volume of the samples
+ */
+void MixAdd(float* mix, const float* samples, size_t count, float volume);
+
+/**
+ * Converts mixed samples to signed 16 bit with saturation.
+ * When the summed volume of the channels exceeds 1 samples above the
+ * threshold of 0.8 are compressed into the remaining range.
+ *
+ * @param mix mixer samples
+ * @param out destination
+ * @param count number of samples
+ * @param total_volume summed volume of all mixed channels
+ */
+void MixToS16(const float* mix, int16_t* out, size_t count, float total_volume);
+
+} // namespace AudioKernels
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_RING_BUFFER_H
+#define EP_AUDIO_RING_BUFFER_H
+
+// Headers
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+/**
+ * Lock-free single-producer/single-consumer ring buffer of samples.
+ *
+ * One thread may call Write and WriteAvailable while another thread calls
+ * Read and ReadAvailable. Resize and Clear require that no other thread
+ * accesses the buffer.
+ */
+class AudioRingBuffer {
+public:
+	AudioRingBuffer() = default;
+
+	/**
+	 * Creates a ring buffer.
+	 *
+	 * @param capacity minimum number of samples, rounded up to a power of two
+	 */
+	explicit AudioRingBuffer(size_t capacity);
+
+	AudioRingBuffer(const AudioRingBuffer&) = delete;
+	AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+	/**
+	 * Changes the capacity and discards all samples.
+	 *
+	 * @param capacity minimum number of samples, rounded up to a power of two
+	 */
+	void Resize(size_t capacity);
+
+	/** Discards all samples */
+	void Clear();
+
+	/** @return maximum number of samples the buffer holds */
+	size_t Capacity() const;
+
+	/** @return number of samples that can be read */
+	size_t ReadAvailable() const;
+
+	/** @return number of samples that can be written */
+	size_t WriteAvailable() const;
+
+	/**
+	 * Appends samples, samples that do not fit are dropped.
+	 *
+	 * @param data samples to append
+	 * @param count number of samples
+	 * @return number of samples written
+	 */
+	size_t Write(const float* data, size_t count);
+
+	/**
+	 * Removes samples from the front.
+	 *
+	 * @param data destination of the samples
+	 * @param count maximum number of samples
+	 * @return number of samples read
+	 */
+	size_t Read(float* data, size_t count);
+
+private:
+	std::vector<float> buffer;
+	size_t mask = 0;
+	// Positions grow monotonically and wrap around through the mask
+	std::atomic<size_t> read_pos = { 0 };
+	std::atomic<size_t> write_pos = { 0 };
+};
+
+inline AudioRingBuffer::AudioRingBuffer(size_t capacity) {
+	Resize(capacity);
+}
+
+inline void AudioRingBuffer::Resize(size_t capacity) {
+	size_t size = 1;
+	while (size < capacity) {
+		size *= 2;
+	}
+	buffer.assign(capacity > 0 ? size : 0, 0.0f);
+	mask = buffer.empty() ? 0 : size - 1;
+	Clear();
+}
+
+inline void AudioRingBuffer::Clear() {
+	read_pos.store(0, std::memory_order_relaxed);
+	write_pos.store(0, std::memory_order_relaxed);
+}
+
+inline size_t AudioRingBuffer::Capacity() const {
+	return buffer.size();
+}
+
+inline size_t AudioRingBuffer::ReadAvailable() const {
+	return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_relaxed);
+}
+
+inline size_t AudioRingBuffer::WriteAvailable() const {
+	return buffer.size() - (write_pos.load(std::memory_order_relaxed) - read_pos.load(std::memory_order_acquire));
+}
+
+inline size_t AudioRingBuffer::Write(const float* data, size_t count) {
+	const size_t pos = write_pos.load(std::memory_order_relaxed);
+	count = std::min(count, WriteAvailable());
+	if (count == 0) {
+		return 0;
+	}
+
+	const size_t start = pos & mask;
+	const size_t first = std::min(count, buffer.size() - start);
+	std::memcpy(buffer.data() + start, data, first * sizeof(float));
+	std::memcpy(buffer.data(), data + first, (count - first) * sizeof(float));
+
+	write_pos.store(pos + count, std::memory_order_release);
+	return count;
+}
+
+inline size_t AudioRingBuffer::Read(float* data, size_t count) {
+	const size_t pos = read_pos.load(std::memory_order_relaxed);
+	count = std::min(count, ReadAvailable());
+	if (count == 0) {
+		return 0;
+	}
+
+	const size_t start = pos & mask;
+	const size_t first = std::min(count, buffer.size() - start);
+	std::memcpy(data, buffer.data() + start, first * sizeof(float));
+	std::memcpy(data + first, buffer.data(), (count - first) * sizeof(float));
+
+	read_pos.store(pos + count, std::memory_order_release);
+	return count;
+}
+
+#endif
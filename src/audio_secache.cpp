@@ -16,54 +16,79 @@
  */
 
 // Headers
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <map>
 #include <memory>
 #include <set>
+#include <tuple>
 #include "audio_resampler.h"
 #include "audio_secache.h"
 #include "game_clock.h"
 #include "filefinder.h"
 #include "output.h"
 
-using namespace std::chrono_literals;
-
 namespace {
 	typedef std::map<std::string, AudioSeRef> cache_type;
+	/** Name, frequency, format, channels and pitch of a converted SE */
+	typedef std::tuple<std::string, int, AudioDecoder::Format, int, int> converted_key;
+	typedef std::map<converted_key, AudioSeRef> converted_cache_type;
 
 	cache_type cache;
+	converted_cache_type converted_cache;
 
-	constexpr int cache_limit = 3 * 1024 * 1024;
-	int cache_size = 0;
+	/** Memory limit of all cached samples, least recently used samples are freed first */
+	constexpr size_t cache_limit = 8 * 1024 * 1024;
+	/** Larger samples are resampled while playing instead of being cached converted */
+	constexpr size_t convert_limit = 1024 * 1024;
+	size_t cache_size = 0;
 
 	void FreeCacheMemory() {
-		auto cur_time = Game_Clock::GetFrameTime();
+		if (cache_size <= cache_limit) {
+			return;
+		}
 
-		for (auto it = cache.begin(); it != cache.end(); ) {
-			if (it->second.use_count() > 1) {
-				// SE is currently playing
-				++it;
-				continue;
+		// Samples that are currently playing are in use by a decoder
+		std::vector<AudioSeData*> unused;
+		for (auto& entry: cache) {
+			if (entry.second.use_count() == 1) {
+				unused.push_back(entry.second.get());
 			}
-
-			if (cache_size <= cache_limit && cur_time - it->second->last_access < 3s) {
-				// Below memory limit and last access < 3s
-				++it;
-				continue;
+		}
+		for (auto& entry: converted_cache) {
+			if (entry.second.use_count() == 1) {
+				unused.push_back(entry.second.get());
 			}
+		}
 
-#ifdef CACHE_DEBUG
-			Output::Debug("SE: Freeing memory of {}", it->first);
-#endif
-
-			cache_size -= it->second->buffer.size();
+		std::sort(unused.begin(), unused.end(), [](const AudioSeData* a, const AudioSeData* b) {
+			return a->last_access < b->last_access;
+		});
 
-			it = cache.erase(it);
+		std::set<const AudioSeData*> freed;
+		for (auto* se: unused) {
+			if (cache_size <= cache_limit) {
+				break;
+			}
+			cache_size -= se->buffer.size();
+			freed.insert(se);
 		}
 
+		auto free_entries = [&](auto& entries) {
+			for (auto it = entries.begin(); it != entries.end(); ) {
+				if (freed.count(it->second.get()) > 0) {
+					it = entries.erase(it);
+				} else {
+					++it;
+				}
+			}
+		};
+		free_entries(cache);
+		free_entries(converted_cache);
+
 #ifdef CACHE_DEBUG
-		Output::Debug("SE cache size: {}", cache_size / 1024.0 / 1024);
+		Output::Debug("SE cache size: {} ({} freed)", cache_size / 1024.0 / 1024, freed.size());
 #endif
 	}
 }
@@ -160,6 +185,7 @@ std::unique_ptr<AudioDecoderBase> AudioSeCache::CreateSeDecoder() {
 
 	audio_decoder->GetFormat(se->frequency, se->format, se->channels);
 	se->buffer = audio_decoder->DecodeAll();
+	se->last_access = Game_Clock::GetFrameTime();
 
 	cache.insert(std::make_pair(name, se));
 
@@ -180,6 +206,57 @@ std::unique_ptr<AudioDecoderBase> AudioSeCache::CreateSeDecoder() {
 	return dec;
 }
 
+std::unique_ptr<AudioDecoderBase> AudioSeCache::CreateSeDecoder(int frequency, AudioDecoder::Format format, int channels, int pitch) {
+#ifdef USE_AUDIO_RESAMPLER
+	converted_key key(name, frequency, format, channels, pitch);
+
+	AudioSeRef se;
+	auto it = converted_cache.find(key);
+	if (it != converted_cache.end()) {
+		se = it->second;
+		se->last_access = Game_Clock::GetFrameTime();
+
+		// Keeps the source alive for conversions to other pitches
+		auto source = cache.find(name);
+		if (source != cache.end()) {
+			source->second->last_access = Game_Clock::GetFrameTime();
+		}
+	} else {
+		auto dec = CreateSeDecoder();
+		dec->SetPitch(pitch);
+		dec->SetFormat(frequency, format, channels);
+
+		if (GetSeData()->buffer.size() > convert_limit) {
+			return dec;
+		}
+
+		se = std::make_shared<AudioSeData>();
+		dec->GetFormat(se->frequency, se->format, se->channels);
+		se->buffer = dec->DecodeAll();
+		se->last_access = Game_Clock::GetFrameTime();
+
+		converted_cache.insert(std::make_pair(std::move(key), se));
+		cache_size += se->buffer.size();
+
+#ifdef CACHE_DEBUG
+		Output::Debug("SE cache size (Convert): {}", cache_size / 1024.0 / 1024.0);
+#endif
+
+		FreeCacheMemory();
+	}
+
+	std::unique_ptr<AudioDecoderBase> dec = std::make_unique<AudioSeDecoder>(se);
+	Filesystem_Stream::InputStream is;
+	dec->Open(std::move(is));
+	return dec;
+#else
+	auto dec = CreateSeDecoder();
+	dec->SetPitch(pitch);
+	dec->SetFormat(frequency, format, channels);
+	return dec;
+#endif
+}
+
 AudioSeRef AudioSeCache::GetSeData() const {
 	auto it = cache.find(name);
 	assert(it != cache.end());
@@ -187,9 +264,14 @@ AudioSeRef AudioSeCache::GetSeData() const {
 	return it->second;
 };
 
+size_t AudioSeCache::GetCacheSize() {
+	return cache_size;
+}
+
 void AudioSeCache::Clear() {
 	cache_size = 0;
 	cache.clear();
+	converted_cache.clear();
 }
 
 std::string_view AudioSeCache::GetName() const {
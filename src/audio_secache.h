@@ -70,8 +70,10 @@ private:
  * AudioSeCache provides an interface for accessing sound effects.
  * It also provides an automatic cache management, any SE is only decoded
  * once, otherwise returned from the cache.
- * The cache is flushed from recently (>10 seconds by default) unused
- * samples when it reaches the memory limit (5 MB by default).
+ * Samples converted to the output format and pitch of the mixer are cached
+ * as well, so playing them again does not resample.
+ * When the cache reaches the memory limit (8 MB) the least recently used
+ * samples that are not playing are freed.
  * Uses an internal AudioDecoder for handling the decoding.
  */
 class AudioSeCache {
@@ -125,6 +127,19 @@ public:
 	 */
 	std::unique_ptr<AudioDecoderBase> CreateSeDecoder();
 
+	/**
+	 * Like CreateSeDecoder but the sample is converted to the requested
+	 * format and pitch once and cached. When the sample cannot be converted
+	 * the returned decoder converts while decoding.
+	 *
+	 * @param frequency Output frequency
+	 * @param format Output format
+	 * @param channels Output channels
+	 * @param pitch Pitch multiplier in percent
+	 * @return Decoded sound effect in the requested format
+	 */
+	std::unique_ptr<AudioDecoderBase> CreateSeDecoder(int frequency, AudioDecoder::Format format, int channels, int pitch);
+
 	/**
 	 * Returns the SE sample data handled by this SeCache.
 	 *
@@ -137,6 +152,11 @@ public:
 	 */
 	std::string_view GetName() const;
 
+	/**
+	 * @return memory used by all cached samples in bytes
+	 */
+	static size_t GetCacheSize();
+
 	static void Clear();
 private:
 	std::unique_ptr<AudioDecoderBase> audio_decoder;
@@ -115,6 +115,24 @@ int Background::Scale(int x) {
 	return x > 0 ? x / 64 : -(-x / 64);
 }
 
+bool Background::GetDamageState(DamageState& state) const {
+	if (tone_effect != Tone()) {
+		// The tone is applied in-place to the whole screen, this cannot be clipped
+		return false;
+	}
+
+	if (!bg_bitmap && !fg_bitmap) {
+		return true;
+	}
+
+	state.rect = Rect(0, 0, Player::screen_width, Player::screen_height);
+	state.Hash(bg_bitmap.get()).Hash(bg_bitmap ? bg_bitmap->GetRevision() : 0u)
+		.Hash(fg_bitmap.get()).Hash(fg_bitmap ? fg_bitmap->GetRevision() : 0u)
+		.Hash(Scale(bg_x)).Hash(Scale(bg_y)).Hash(Scale(fg_x)).Hash(Scale(fg_y))
+		.Hash(Main_Data::game_screen->GetShakeOffsetX()).Hash(Main_Data::game_screen->GetShakeOffsetY());
+	return true;
+}
+
 void Background::Draw(Bitmap& dst) {
 	Rect dst_rect = dst.GetRect();
 
@@ -0,0 +1,442 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "battle_simulator.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <fmt/ostream.h>
+#include <lcf/data.h>
+#include "autobattle.h"
+#include "enemyai.h"
+#include "game_actor.h"
+#include "game_actors.h"
+#include "game_battle.h"
+#include "game_battlealgorithm.h"
+#include "game_enemy.h"
+#include "game_enemyparty.h"
+#include "game_party.h"
+#include "game_switches.h"
+#include "main_data.h"
+#include "output.h"
+#include "rand.h"
+#include "scene_battle.h"
+#include "system.h"
+
+// Worker processes for Config::jobs
+#ifdef SYSTEM_DESKTOP_LINUX_BSD_MACOS
+#  define EP_BATTLE_SIMULATOR_FORK
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+namespace BattleSimulator {
+
+namespace {
+
+struct SavedState {
+	std::vector<lcf::rpg::SaveActor> actors;
+	Game_Switches::Switches_t switches;
+};
+
+SavedState SaveState() {
+	SavedState state;
+	for (auto* actor: Main_Data::game_party->GetActors()) {
+		state.actors.push_back(actor->GetSaveData());
+	}
+	state.switches = Main_Data::game_switches->GetData();
+	return state;
+}
+
+void RestoreState(const SavedState& state) {
+	auto actors = Main_Data::game_party->GetActors();
+	for (size_t i = 0; i < actors.size(); ++i) {
+		actors[i]->SetSaveData(state.actors[i]);
+	}
+	Main_Data::game_switches->SetData(state.switches);
+}
+
+// Game_Battle::Init without the battle events and the spriteset
+void BeginBattle(int troop_id) {
+	Game_Battle::battle_running = true;
+	Main_Data::game_party->ResetTurns();
+
+	Main_Data::game_enemyparty->ResetBattle(troop_id);
+	Main_Data::game_actors->ResetBattle();
+
+	for (auto* actor: Main_Data::game_party->GetActors()) {
+		actor->ResetEquipmentStates(true);
+	}
+}
+
+void EndBattle() {
+	Game_Battle::battle_running = false;
+
+	Main_Data::game_actors->ResetBattle();
+	Main_Data::game_enemyparty->ResetBattle(0);
+}
+
+// The algorithms in the same order as in Scene_Battle::Start, indexed by the
+// algorithm id of the actors and the enemies
+struct Algorithms {
+	std::vector<std::unique_ptr<AutoBattle::AlgorithmBase>> autobattle;
+	std::vector<std::unique_ptr<EnemyAi::AlgorithmBase>> enemyai;
+	int default_autobattle = 0;
+	int default_enemyai = 0;
+};
+
+template <typename T>
+int FindAlgorithm(const std::vector<std::unique_ptr<T>>& algos, const std::string& name, int db_default) {
+	if (name.empty()) {
+		return db_default == -1 ? 0 : db_default;
+	}
+	for (auto& algo: algos) {
+		if (algo->GetName() == name) {
+			return algo->GetId();
+		}
+	}
+	return 0;
+}
+
+Algorithms CreateAlgorithms(const Config& config) {
+	Algorithms algos;
+	algos.autobattle.push_back(AutoBattle::CreateAlgorithm(AutoBattle::RpgRtCompat::name));
+	algos.autobattle.push_back(AutoBattle::CreateAlgorithm(AutoBattle::RpgRtImproved::name));
+	algos.autobattle.push_back(AutoBattle::CreateAlgorithm(AutoBattle::AttackOnly::name));
+	algos.enemyai.push_back(EnemyAi::CreateAlgorithm(EnemyAi::RpgRtCompat::name));
+	algos.enemyai.push_back(EnemyAi::CreateAlgorithm(EnemyAi::RpgRtImproved::name));
+
+	algos.default_autobattle = FindAlgorithm(algos.autobattle, config.autobattle_algo, lcf::Data::system.easyrpg_default_actorai);
+	algos.default_enemyai = FindAlgorithm(algos.enemyai, config.enemyai_algo, lcf::Data::system.easyrpg_default_enemyai);
+	return algos;
+}
+
+// Same actions as Scene_Battle_Rpg2k::SelectNextActor in auto battle and
+// Scene_Battle_Rpg2k::CreateEnemyActions
+void CreateActions(std::vector<Game_Battler*>& actions, Algorithms& algos) {
+	actions.clear();
+
+	for (auto* actor: Main_Data::game_party->GetActors()) {
+		actions.push_back(actor);
+
+		if (!actor->CanAct()) {
+			actor->SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::None>(actor));
+			continue;
+		}
+
+		Game_Battler* random_target = nullptr;
+		switch (actor->GetSignificantRestriction()) {
+			case lcf::rpg::State::Restriction_attack_ally:
+				random_target = Main_Data::game_party->GetRandomActiveBattler();
+				break;
+			case lcf::rpg::State::Restriction_attack_enemy:
+				random_target = Main_Data::game_enemyparty->GetRandomActiveBattler();
+				break;
+			default:
+				break;
+		}
+
+		if (random_target) {
+			actor->SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::Normal>(actor, random_target));
+		} else if (actor->GetActorAi() == -1) {
+			algos.autobattle[algos.default_autobattle]->SetAutoBattleAction(*actor);
+		} else {
+			algos.autobattle[actor->GetActorAi()]->SetAutoBattleAction(*actor);
+		}
+	}
+
+	for (auto* enemy: Main_Data::game_enemyparty->GetEnemies()) {
+		if (enemy->IsHidden()) {
+			continue;
+		}
+
+		if (!EnemyAi::SetStateRestrictedAction(*enemy)) {
+			if (enemy->GetEnemyAi() == -1) {
+				algos.enemyai[algos.default_enemyai]->SetEnemyAiAction(*enemy);
+			} else {
+				algos.enemyai[enemy->GetEnemyAi()]->SetEnemyAiAction(*enemy);
+			}
+		}
+		if (enemy->GetBattleAlgorithm() == nullptr) {
+			// Enemy without any usable action
+			enemy->SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::None>(enemy));
+		}
+		actions.push_back(enemy);
+	}
+
+	// Same order as in Scene_Battle_Rpg2k::CreateExecutionOrder
+	for (auto* battler: actions) {
+		int battle_order = battler->GetAgi() + Rand::GetRandomNumber(0, battler->GetAgi() / 4 + 3);
+		if (battler->GetBattleAlgorithm()->GetType() == Game_BattleAlgorithm::Type::Normal && battler->HasPreemptiveAttack()) {
+			battle_order += 9999;
+		}
+		battler->SetBattleOrderAgi(battle_order);
+	}
+	std::sort(actions.begin(), actions.end(),
+			[](Game_Battler* l, Game_Battler* r) {
+			return l->GetBattleOrderAgi() > r->GetBattleOrderAgi();
+			});
+}
+
+// Runs the action like Scene_Battle_Rpg2k::ProcessBattleAction without the
+// messages, animations and waits. Returns the number of executed targets.
+int ExecuteAction(Game_Battler& battler) {
+	Scene_Battle::PrepareBattleAction(&battler);
+	auto action = battler.GetBattleAlgorithm();
+
+	battler.NextBattleTurn();
+	battler.BattleStateHeal();
+	battler.ApplyConditions();
+
+	int executed = 0;
+	if (action->GetType() != Game_BattleAlgorithm::Type::None) {
+		action->Start();
+		action->ReflectTargets();
+
+		do {
+			if (action->IsCurrentTargetValid()) {
+				action->Execute();
+				action->ApplyAll();
+				++executed;
+			}
+		} while (action->RepeatNext(true) || action->TargetNext());
+
+		action->ProcessPostActionSwitches();
+	}
+	return executed;
+}
+
+BattleResult RunBattle(int max_turns, Algorithms& algos, Stats& stats) {
+	std::vector<Game_Battler*> actions;
+
+	for (int turn = 0; ; ++turn) {
+		if (Game_Battle::CheckLose()) {
+			return BattleResult::Defeat;
+		}
+		if (Game_Battle::CheckWin()) {
+			return BattleResult::Victory;
+		}
+		if (turn == max_turns) {
+			return BattleResult::Abort;
+		}
+
+		Main_Data::game_party->IncTurns();
+		++stats.turns;
+
+		CreateActions(actions, algos);
+		for (auto* battler: actions) {
+			// Removes the actions of battlers who were killed or removed from the battle
+			if (battler->Exists() && !Game_Battle::CheckLose() && !Game_Battle::CheckWin()) {
+				stats.actions += ExecuteAction(*battler);
+			}
+			battler->SetBattleAlgorithm(nullptr);
+		}
+	}
+}
+
+// Runs the battles first to first + count - 1 of the configuration
+Stats RunBattles(const Config& config, int first, int count) {
+	auto algos = CreateAlgorithms(config);
+
+	const auto state = SaveState();
+
+	Stats stats;
+	for (int i = first; i < first + count; ++i) {
+		// Seeded directly, SeedRandomNumberGenerator logs every call
+		Rand::GetRNG().seed(static_cast<uint32_t>(config.seed) + i);
+
+		BeginBattle(config.troop_id);
+		switch (RunBattle(config.max_turns, algos, stats)) {
+			case BattleResult::Victory:
+				++stats.victories;
+				break;
+			case BattleResult::Defeat:
+				++stats.defeats;
+				break;
+			default:
+				++stats.aborted;
+				break;
+		}
+		++stats.battles;
+		EndBattle();
+
+		RestoreState(state);
+	}
+	return stats;
+}
+
+#ifdef EP_BATTLE_SIMULATOR_FORK
+void AddStats(Stats& stats, const Stats& other) {
+	stats.battles += other.battles;
+	stats.victories += other.victories;
+	stats.defeats += other.defeats;
+	stats.aborted += other.aborted;
+	stats.turns += other.turns;
+	stats.actions += other.actions;
+}
+
+// The counters a worker sends to the parent process
+using WorkerResult = std::array<int64_t, 6>;
+
+bool WriteResult(int fd, const Stats& stats) {
+	const WorkerResult result = {{ stats.battles, stats.victories, stats.defeats, stats.aborted, stats.turns, stats.actions }};
+	const auto* data = reinterpret_cast<const char*>(result.data());
+	size_t written = 0;
+	while (written < sizeof(result)) {
+		auto res = write(fd, data + written, sizeof(result) - written);
+		if (res < 0 && errno == EINTR) {
+			continue;
+		}
+		if (res <= 0) {
+			return false;
+		}
+		written += res;
+	}
+	return true;
+}
+
+bool ReadResult(int fd, Stats& stats) {
+	WorkerResult result;
+	auto* data = reinterpret_cast<char*>(result.data());
+	size_t read_bytes = 0;
+	while (read_bytes < sizeof(result)) {
+		auto res = read(fd, data + read_bytes, sizeof(result) - read_bytes);
+		if (res < 0 && errno == EINTR) {
+			continue;
+		}
+		if (res <= 0) {
+			return false;
+		}
+		read_bytes += res;
+	}
+
+	stats.battles = static_cast<int>(result[0]);
+	stats.victories = static_cast<int>(result[1]);
+	stats.defeats = static_cast<int>(result[2]);
+	stats.aborted = static_cast<int>(result[3]);
+	stats.turns = result[4];
+	stats.actions = result[5];
+	return true;
+}
+
+// Splits the battles across forked worker processes. Every worker owns a copy
+// of the global game state, so the battles do not interfere. The battles use
+// the same seeds as in a single process, the merged result is identical.
+Stats RunJobs(const Config& config) {
+	struct Worker {
+		pid_t pid;
+		int fd;
+	};
+	std::vector<Worker> workers;
+
+	Stats stats;
+	const int jobs = std::min(config.jobs, config.num_battles);
+	int first = 0;
+	for (int job = 0; job < jobs; ++job) {
+		const int count = config.num_battles / jobs + (job < config.num_battles % jobs ? 1 : 0);
+
+		int fds[2];
+		pid_t pid = -1;
+		if (pipe(fds) == 0) {
+			pid = fork();
+			if (pid == -1) {
+				close(fds[0]);
+				close(fds[1]);
+			}
+		}
+
+		if (pid == 0) {
+			close(fds[0]);
+			const bool success = WriteResult(fds[1], RunBattles(config, first, count));
+			// Skips the destructors and the atexit handlers of the parent
+			_exit(success ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
+
+		if (pid == -1) {
+			Output::Warning("BattleSimulator: Cannot start a worker process, running battles {}-{} in the main process", first, first + count - 1);
+			AddStats(stats, RunBattles(config, first, count));
+		} else {
+			close(fds[1]);
+			workers.push_back({ pid, fds[0] });
+		}
+		first += count;
+	}
+
+	for (auto& worker: workers) {
+		Stats result;
+		const bool success = ReadResult(worker.fd, result);
+		close(worker.fd);
+
+		int status = 0;
+		while (waitpid(worker.pid, &status, 0) == -1 && errno == EINTR) {}
+
+		if (success && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS) {
+			AddStats(stats, result);
+		} else {
+			Output::Warning("BattleSimulator: Worker process {} failed, its battles are missing", worker.pid);
+		}
+	}
+	return stats;
+}
+#endif
+
+} // anonymous namespace
+
+Stats Run(const Config& config) {
+	Stats stats;
+	const auto begin = Game_Clock::now();
+
+#ifdef EP_BATTLE_SIMULATOR_FORK
+	if (config.jobs > 1 && config.num_battles > 1) {
+		stats = RunJobs(config);
+	} else
+#endif
+	{
+		stats = RunBattles(config, 0, config.num_battles);
+	}
+
+	stats.seed = config.seed;
+	stats.time = Game_Clock::now() - begin;
+	return stats;
+}
+
+void Stats::Print(std::ostream& os) const {
+	const auto total = std::chrono::duration<double>(time).count();
+	fmt::print(os, "Battle simulation: {} battles in {:.3f}s ({:.1f} battles/s)\n",
+		battles, total, total > 0.0 ? battles / total : 0.0);
+	fmt::print(os, "{:<16}{:>10}\n", "seed", seed);
+
+	auto percent = [this](int count) {
+		return battles > 0 ? 100.0 * count / battles : 0.0;
+	};
+	auto average = [this](int64_t count) {
+		return battles > 0 ? static_cast<double>(count) / battles : 0.0;
+	};
+
+	fmt::print(os, "{:<16}{:>10}{:>9.1f}%\n", "victories", victories, percent(victories));
+	fmt::print(os, "{:<16}{:>10}{:>9.1f}%\n", "defeats", defeats, percent(defeats));
+	fmt::print(os, "{:<16}{:>10}{:>9.1f}%\n", "aborted", aborted, percent(aborted));
+	fmt::print(os, "{:<16}{:>10.1f}\n", "turns/battle", average(turns));
+	fmt::print(os, "{:<16}{:>10.1f}\n", "actions/battle", average(actions));
+}
+
+} // namespace BattleSimulator
@@ -0,0 +1,93 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BATTLE_SIMULATOR_H
+#define EP_BATTLE_SIMULATOR_H
+
+#include "game_clock.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * Runs battles of the current party against a troop without a scene,
+ * graphics or audio. The actions are selected like in the RPG Maker 2000
+ * battle scene when auto battle is chosen for the whole party, including the
+ * per battler AI and the attacks of confused and provoked actors. Troop
+ * battle events, first strikes and escapes are not simulated.
+ * Used by the --simulate-battles mode.
+ *
+ * The battle rules operate on the global parties and the global random
+ * number generator, so a process runs one battle at a time. Every battle
+ * uses its own seed, which allows splitting the battles across forked
+ * worker processes on Linux, BSD and macOS.
+ */
+namespace BattleSimulator {
+
+struct Config {
+	/** Monster party to fight against */
+	int troop_id = 0;
+	/** Amount of battles to run */
+	int num_battles = 0;
+	/** Seed of the first battle, battle i uses seed + i */
+	int32_t seed = 0;
+	/** Battles lasting longer are aborted */
+	int max_turns = 100;
+	/** Worker processes the battles are split across, ignored when the platform cannot fork */
+	int jobs = 1;
+	/** Auto battle algorithm of the actors without an own AI, empty uses the database default */
+	std::string autobattle_algo;
+	/** AI algorithm of the enemies without an own AI, empty uses the database default */
+	std::string enemyai_algo;
+};
+
+struct Stats {
+	using duration = Game_Clock::duration;
+
+	/** Seed of the first battle, the same as --seed of the run */
+	int32_t seed = 0;
+	int battles = 0;
+	int victories = 0;
+	int defeats = 0;
+	/** Battles aborted after Config::max_turns */
+	int aborted = 0;
+	int64_t turns = 0;
+	/** Executed battle actions, each target of an action counts */
+	int64_t actions = 0;
+	/** Wall clock time spent in the battles */
+	duration time = {};
+
+	/**
+	 * Writes a human readable summary.
+	 *
+	 * @param os stream to write to
+	 */
+	void Print(std::ostream& os) const;
+};
+
+/**
+ * Runs the battles. The party and the switches are restored after every
+ * battle, so all battles start from the same state.
+ *
+ * @param config battles to run
+ * @return outcome and timing of the battles
+ */
+Stats Run(const Config& config);
+
+} // namespace BattleSimulator
+
+#endif
@@ -20,12 +20,14 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <unordered_map>
 
 #include "utils.h"
 #include "cache.h"
 #include "bitmap.h"
+#include "bitmap_kernels.h"
 #include "filefinder.h"
 #include "options.h"
 #include <lcf/data.h>
@@ -33,6 +35,7 @@
 #include "image_xyz.h"
 #include "image_bmp.h"
 #include "image_png.h"
+#include "instrumentation.h"
 #include "transform.h"
 #include "font.h"
 #include "output.h"
@@ -78,6 +81,17 @@ BitmapRef Bitmap::Create(void *pixels, int width, int height, int pitch, const D
 	return std::make_shared<Bitmap>(pixels, width, height, pitch, format);
 }
 
+uint64_t Bitmap::NextSerial() {
+	// Bitmaps are also created by the prefetch workers
+	static std::atomic<uint64_t> counter{ 0 };
+	return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+uint64_t Bitmap::NextRevision() {
+	static std::atomic<uint64_t> counter{ 0 };
+	return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 Bitmap::Bitmap(int width, int height, bool transparent) {
 	format = (transparent ? pixel_format : opaque_pixel_format);
 	pixman_format = find_format(format);
@@ -91,6 +105,8 @@ Bitmap::Bitmap(void *pixels, int width, int height, int pitch, const DynamicForm
 }
 
 Bitmap::Bitmap(Filesystem_Stream::InputStream stream, bool transparent, uint32_t flags) {
+	Instrumentation::Scope iscope("Image decode");
+
 	format = (transparent ? pixel_format : opaque_pixel_format);
 	pixman_format = find_format(format);
 
@@ -204,28 +220,11 @@ ImageOpacity Bitmap::ComputeImageOpacity() const {
 		return ImageOpacity::Opaque;
 	}
 
-	bool all_opaque = true;
-	bool all_transp = true;
-	bool alpha_1bit = true;
-
 	auto* p = reinterpret_cast<const uint32_t*>(pixels());
 	const auto mask = format.rgba_to_uint32_t(0, 0, 0, 0xFF);
 
 	int n = GetSize() / sizeof(uint32_t);
-	for (int i = 0; i < n; ++i ) {
-		auto px = p[i] & mask;
-		bool transp = (px == 0);
-		bool opaque = (px == mask);
-		all_transp &= transp;
-		all_opaque &= opaque;
-		alpha_1bit &= (transp | opaque);
-	}
-
-	return
-		all_transp ? ImageOpacity::Transparent :
-		all_opaque ? ImageOpacity::Opaque :
-		alpha_1bit ? ImageOpacity::Alpha_1Bit :
-		ImageOpacity::Alpha_8Bit;
+	return BitmapKernels::ComputeOpacity(p, n, 1, n, mask);
 }
 
 ImageOpacity Bitmap::ComputeImageOpacity(Rect rect) const {
@@ -233,10 +232,6 @@ ImageOpacity Bitmap::ComputeImageOpacity(Rect rect) const {
 		return ImageOpacity::Opaque;
 	}
 
-	bool all_opaque = true;
-	bool all_transp = true;
-	bool alpha_1bit = true;
-
 	const auto full_rect = GetRect();
 	rect = full_rect.GetSubRect(rect);
 
@@ -244,24 +239,7 @@ ImageOpacity Bitmap::ComputeImageOpacity(Rect rect) const {
 	const int stride = pitch() / sizeof(uint32_t);
 	const auto mask = format.rgba_to_uint32_t(0, 0, 0, 0xFF);
 
-	int xend = (rect.x + rect.width);
-	int yend = (rect.y + rect.height);
-	for (int y = rect.y * stride; y < yend * stride; y += stride) {
-		for (int x = rect.x; x < xend; ++x) {
-			auto px = p[x + y] & mask;
-			bool transp = (px == 0);
-			bool opaque = (px == mask);
-			all_transp &= transp;
-			all_opaque &= opaque;
-			alpha_1bit &= (transp | opaque);
-		}
-	}
-
-	return
-		all_transp ? ImageOpacity::Transparent :
-		all_opaque ? ImageOpacity::Opaque :
-		alpha_1bit ? ImageOpacity::Alpha_1Bit :
-		ImageOpacity::Alpha_8Bit;
+	return BitmapKernels::ComputeOpacity(p + rect.y * stride + rect.x, rect.width, rect.height, stride, mask);
 }
 
 void Bitmap::CheckPixels(uint32_t flags) {
@@ -313,6 +291,8 @@ Color Bitmap::GetColorAt(int x, int y) const {
 }
 
 void Bitmap::HueChangeBlit(int x, int y, Bitmap const& src, Rect const& src_rect_, double hue_) {
+	revision = NextRevision();
+
 	Rect dst_rect(x, y, 0, 0), src_rect = src_rect_;
 
 	if (!Rect::AdjustRectangles(src_rect, dst_rect, src.GetRect()))
@@ -639,6 +619,8 @@ namespace {
 } // anonymous namespace
 
 void Bitmap::Blit(int x, int y, Bitmap const& src, Rect const& src_rect, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	revision = NextRevision();
+
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -655,6 +637,8 @@ void Bitmap::Blit(int x, int y, Bitmap const& src, Rect const& src_rect, Opacity
 }
 
 void Bitmap::BlitFast(int x, int y, Bitmap const & src, Rect const & src_rect, Opacity const & opacity) {
+	revision = NextRevision();
+
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -679,6 +663,8 @@ void Bitmap::TiledBlit(Rect const& src_rect, Bitmap const& src, Rect const& dst_
 }
 
 void Bitmap::TiledBlit(int ox, int oy, Rect const& src_rect, Bitmap const& src, Rect const& dst_rect, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	revision = NextRevision();
+
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -707,6 +693,8 @@ void Bitmap::StretchBlit(Bitmap const&  src, Rect const& src_rect, Opacity const
 }
 
 void Bitmap::StretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	revision = NextRevision();
+
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -731,6 +719,8 @@ void Bitmap::StretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& sr
 }
 
 void Bitmap::WaverBlit(int x, int y, double zoom_x, double zoom_y, Bitmap const& src, Rect const& src_rect, int depth, double phase, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	revision = NextRevision();
+
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -776,6 +766,8 @@ static pixman_color_t PixmanColor(const Color &color) {
 }
 
 void Bitmap::Fill(const Color &color) {
+	revision = NextRevision();
+
 	pixman_color_t pcolor = PixmanColor(color);
 
 	pixman_box32_t box = { 0, 0, width(), height() };
@@ -784,6 +776,8 @@ void Bitmap::Fill(const Color &color) {
 }
 
 void Bitmap::FillRect(Rect const& dst_rect, const Color &color) {
+	revision = NextRevision();
+
 	pixman_color_t pcolor = PixmanColor(color);
 
 	auto timage = PixmanImagePtr{pixman_image_create_solid_fill(&pcolor)};
@@ -797,6 +791,14 @@ void Bitmap::FillRect(Rect const& dst_rect, const Color &color) {
 }
 
 void Bitmap::Clear() {
+	if (clipped) {
+		// memset ignores the clip region
+		ClearRect(GetRect());
+		return;
+	}
+
+	revision = NextRevision();
+
 	if (!pixels()) {
 		// Happens when height or width of bitmap are 0
 		return;
@@ -806,6 +808,8 @@ void Bitmap::Clear() {
 }
 
 void Bitmap::ClearRect(Rect const& dst_rect) {
+	revision = NextRevision();
+
 	pixman_color_t pcolor = {};
 	pixman_box32_t box = {
 		dst_rect.x,
@@ -820,6 +824,26 @@ void Bitmap::ClearRect(Rect const& dst_rect) {
 	pixman_image_fill_boxes(PIXMAN_OP_CLEAR, bitmap.get(), &pcolor, 1, &box);
 }
 
+void Bitmap::SetClipRects(const std::vector<Rect>& rects) {
+	std::vector<pixman_box32_t> boxes;
+	boxes.reserve(rects.size());
+	for (const auto& rect: rects) {
+		boxes.push_back({ rect.x, rect.y, rect.x + rect.width, rect.y + rect.height });
+	}
+
+	pixman_region32_t region;
+	pixman_region32_init_rects(&region, boxes.data(), static_cast<int>(boxes.size()));
+	pixman_image_set_clip_region32(bitmap.get(), &region);
+	pixman_region32_fini(&region);
+
+	clipped = true;
+}
+
+void Bitmap::ResetClip() {
+	pixman_image_set_clip_region32(bitmap.get(), nullptr);
+	clipped = false;
+}
+
 // Hard light lookup table mapping source color to destination color
 // FIXME: Replace this with std::array<std::array<uint8_t,256>,256> when we have C++17
 struct HardLightTable {
@@ -844,29 +868,6 @@ static constexpr HardLightTable make_hard_light_lookup() {
 constexpr auto hard_light = make_hard_light_lookup();
 
 
-// Saturation Tone Inline: Changes a pixel saturation
-static inline void saturation_tone(uint32_t &src_pixel, const int saturation, const int rs, const int gs, const int bs, const int as) {
-	// Algorithm from OpenPDN (MIT license)
-	// Transformation in Y'CbCr color space
-	uint8_t r = (src_pixel >> rs) & 0xFF;
-	uint8_t g = (src_pixel >> gs) & 0xFF;
-	uint8_t b = (src_pixel >> bs) & 0xFF;
-	uint8_t a = (src_pixel >> as) & 0xFF;
-
-	// Y' = 0.299 R' + 0.587 G' + 0.114 B'
-	uint8_t lum = (7471 * b + 38470 * g + 19595 * r) >> 16;
-
-	// Scale Cb/Cr by scale factor "sat"
-	int red = ((lum * 1024 + (r - lum) * saturation) >> 10);
-	red = red > 255 ? 255 : red < 0 ? 0 : red;
-	int green = ((lum * 1024 + (g - lum) * saturation) >> 10);
-	green = green > 255 ? 255 : green < 0 ? 0 : green;
-	int blue = ((lum * 1024 + (b - lum) * saturation) >> 10);
-	blue = blue > 255 ? 255 : blue < 0 ? 0 : blue;
-
-	src_pixel = ((uint32_t)red << rs) | ((uint32_t)green << gs) | ((uint32_t)blue << bs) | ((uint32_t)a << as);
-}
-
 // Color Tone Inline: Changes color of a pixel by hard light table
 static inline void color_tone(uint32_t &src_pixel, const Tone& tone, const int rs, const int gs, const int bs, const int as) {
 	src_pixel = ((uint32_t)hard_light.table[tone.red][(src_pixel >> rs) & 0xFF] << rs)
@@ -884,6 +885,8 @@ static inline void color_tone_alpha(uint32_t &src_pixel, const Tone& tone, const
 }
 
 void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Tone &tone, Opacity const& opacity) {
+	revision = NextRevision();
+
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -935,73 +938,16 @@ void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, con
 	const bool apply_sat = tone.gray != 128;
 	const bool apply_tone = (tone.red != 128 || tone.green != 128 || tone.blue != 128);
 
-	// If Saturation + Color:
-	if (apply_sat && apply_tone) {
-		int sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
-
-		if (src_opacity == ImageOpacity::Opaque) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-					color_tone(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		} else if (src_opacity == ImageOpacity::Alpha_1Bit) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					uint8_t a = (uint8_t)((pixels[j] >> as) & 0xFF);
-					if (a == 0)
-						continue;
-
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-					color_tone(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		} else { // 8 Bit Alpha
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					uint8_t a = (uint8_t)((pixels[j] >> as) & 0xFF);
-					if (a == 0) {
-						continue;
-					}
-
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-					color_tone_alpha(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		}
-	}
-
-	// If Only Saturation:
-	else if (apply_sat) {
+	// Saturation: Transparent pixels are skipped unless the image is opaque
+	if (apply_sat) {
 		int sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
 
-		if (src_opacity == ImageOpacity::Opaque) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-				}
-			}
-		} else { // Any kind of alpha
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					uint8_t a = (uint8_t)((pixels[j] >> as) & 0xFF);
-					if (a == 0)
-						continue;
-
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-				}
-			}
-		}
+		BitmapKernels::SaturationTone(pixels + next_row, limit_width, limit_height, next_row,
+			sat, rs, gs, bs, as, src_opacity != ImageOpacity::Opaque);
 	}
 
-	// If Only Color:
-	else if (apply_tone) {
+	// Color:
+	if (apply_tone) {
 		if (src_opacity == ImageOpacity::Opaque) {
 			for (uint16_t i = 0; i < limit_height; ++i) {
 				pixels += next_row;
@@ -1039,6 +985,8 @@ void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, con
 }
 
 void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Color& color, Opacity const& opacity) {
+	revision = NextRevision();
+
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -1069,6 +1017,8 @@ void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, co
 }
 
 void Bitmap::FlipBlit(int x, int y, Bitmap const& src, Rect const& src_rect, bool horizontal, bool vertical, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
+	revision = NextRevision();
+
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -1097,6 +1047,8 @@ void Bitmap::FlipBlit(int x, int y, Bitmap const& src, Rect const& src_rect, boo
 }
 
 void Bitmap::Flip(bool horizontal, bool vertical) {
+	revision = NextRevision();
+
 	if (!horizontal && !vertical) {
 		return;
 	}
@@ -1121,6 +1073,8 @@ void Bitmap::Flip(bool horizontal, bool vertical) {
 }
 
 void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my, Color const& color) {
+	revision = NextRevision();
+
 	pixman_color_t tcolor = {
 		static_cast<uint16_t>(color.red << 8),
 		static_cast<uint16_t>(color.green << 8),
@@ -1138,6 +1092,8 @@ void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my
 }
 
 void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my, Bitmap const& src, int sx, int sy) {
+	revision = NextRevision();
+
 	pixman_image_composite32(PIXMAN_OP_OVER,
 							 src.bitmap.get(), mask.bitmap.get(), bitmap.get(),
 							 sx, sy,
@@ -1147,6 +1103,8 @@ void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my
 }
 
 void Bitmap::Blit2x(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect) {
+	revision = NextRevision();
+
 	Transform xform = Transform::Scale(0.5, 0.5);
 
 	pixman_image_set_transform(src.bitmap.get(), &xform.matrix);
@@ -1193,6 +1151,8 @@ void Bitmap::RotateZoomOpacityBlit(int x, int y, int ox, int oy,
 		Bitmap const& src, Rect const& src_rect,
 		double angle, double zoom_x, double zoom_y, Opacity const& opacity, Bitmap::BlendMode blend_mode)
 {
+	revision = NextRevision();
+
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -1298,6 +1258,8 @@ pixman_op_t Bitmap::GetOperator(pixman_image_t* mask, Bitmap::BlendMode blend_mo
 }
 
 void Bitmap::EdgeMirrorBlit(int x, int y, Bitmap const& src, Rect const& src_rect, bool mirror_x, bool mirror_y, Opacity const& opacity) {
+	revision = NextRevision();
+
 	if (opacity.IsTransparent())
 		return;
 
@@ -246,6 +246,38 @@ public:
 
 	void CheckPixels(uint32_t flags);
 
+	/**
+	 * Returns a number identifying this bitmap. Unlike the address it is
+	 * never reused by another bitmap during the runtime of the Player.
+	 *
+	 * @return unique serial number
+	 */
+	uint64_t GetSerial() const;
+
+	/**
+	 * Returns a number that changes with every drawing operation on this
+	 * bitmap. Used to detect content changes without comparing pixels.
+	 * Revisions come from a global counter, no two bitmaps ever share one,
+	 * even when a bitmap is allocated at the address of a freed one.
+	 * Writes through pixels() are not counted.
+	 *
+	 * @return current revision
+	 */
+	uint64_t GetRevision() const;
+
+	/**
+	 * Restricts all following drawing operations to the union of the passed
+	 * rectangles. An empty list discards all drawing operations.
+	 *
+	 * @param rects rectangles drawing is limited to
+	 */
+	void SetClipRects(const std::vector<Rect>& rects);
+
+	/**
+	 * Removes the clip region set by SetClipRects.
+	 */
+	void ResetClip();
+
 	/**
 	 * @param x x-coordinate
 	 * @param y y-coordinate
@@ -630,6 +662,18 @@ protected:
 	PixmanImagePtr bitmap;
 	pixman_format_code_t pixman_format;
 
+	/** Unique number of the bitmap */
+	uint64_t serial = NextSerial();
+
+	/** Renewed by every drawing operation */
+	uint64_t revision = NextRevision();
+
+	/** Whether a clip region is set */
+	bool clipped = false;
+
+	static uint64_t NextSerial();
+	static uint64_t NextRevision();
+
 	void Init(int width, int height, void* data, int pitch = 0, bool destroy = true);
 	void ConvertImage(int& width, int& height, void*& pixels, bool transparent, uint32_t flags);
 
@@ -723,4 +767,12 @@ inline int Bitmap::GetOriginalBpp() const {
 	return original_bpp;
 }
 
+inline uint64_t Bitmap::GetSerial() const {
+	return serial;
+}
+
+inline uint64_t Bitmap::GetRevision() const {
+	return revision;
+}
+
 #endif
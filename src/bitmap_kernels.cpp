@@ -0,0 +1,465 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <atomic>
+#include "bitmap_kernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EP_KERNELS_SSE2
+#  include <emmintrin.h>
+#endif
+
+// AVX2 is not part of any baseline, the kernels are compiled for it and
+// only used when the CPU reports support at runtime
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define EP_KERNELS_AVX2
+#  define EP_TARGET_AVX2 __attribute__((target("avx2")))
+#  include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define EP_KERNELS_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace BitmapKernels {
+
+namespace {
+
+// Coefficients of Y' = 0.299 R' + 0.587 G' + 0.114 B' in 16.16 fixed point
+constexpr int lum_r = 19595;
+constexpr int lum_g = 38470;
+constexpr int lum_b = 7471;
+
+Isa DetectIsa() {
+#if defined(EP_KERNELS_AVX2)
+	if (IsSupported(Isa::AVX2)) {
+		return Isa::AVX2;
+	}
+#endif
+#if defined(EP_KERNELS_SSE2)
+	return Isa::SSE2;
+#elif defined(EP_KERNELS_NEON)
+	return Isa::NEON;
+#else
+	return Isa::Scalar;
+#endif
+}
+
+std::atomic<Isa>& CurrentIsa() {
+	static std::atomic<Isa> isa(DetectIsa());
+	return isa;
+}
+
+ImageOpacity MakeOpacity(bool all_transp, bool all_opaque, bool alpha_1bit) {
+	return
+		all_transp ? ImageOpacity::Transparent :
+		all_opaque ? ImageOpacity::Opaque :
+		alpha_1bit ? ImageOpacity::Alpha_1Bit :
+		ImageOpacity::Alpha_8Bit;
+}
+
+/** Classifies the pixels [x, width) of a row, used for the scalar code and the remainder of the vector kernels */
+inline void ComputeOpacityRow(const uint32_t* row, int x, int width, uint32_t alpha_mask, bool& all_transp, bool& all_opaque, bool& alpha_1bit) {
+	for (; x < width; ++x) {
+		auto px = row[x] & alpha_mask;
+		bool transp = (px == 0);
+		bool opaque = (px == alpha_mask);
+		all_transp &= transp;
+		all_opaque &= opaque;
+		alpha_1bit &= (transp | opaque);
+	}
+}
+
+ImageOpacity ComputeOpacityScalar(const uint32_t* pixels, int width, int height, int stride, uint32_t alpha_mask) {
+	bool all_transp = true;
+	bool all_opaque = true;
+	bool alpha_1bit = true;
+
+	for (int y = 0; y < height; ++y) {
+		ComputeOpacityRow(pixels + y * stride, 0, width, alpha_mask, all_transp, all_opaque, alpha_1bit);
+
+		// A pixel with partial alpha was found, the result cannot change anymore
+		if (!alpha_1bit) {
+			return ImageOpacity::Alpha_8Bit;
+		}
+	}
+
+	return MakeOpacity(all_transp, all_opaque, alpha_1bit);
+}
+
+/** Saturation of the pixels [x, width) of a row, used for the scalar code and the remainder of the vector kernels */
+inline void SaturationToneRow(uint32_t* row, int x, int width, int saturation, int rs, int gs, int bs, int as, bool skip_transparent) {
+	// Algorithm from OpenPDN (MIT license)
+	// Transformation in Y'CbCr color space
+	for (; x < width; ++x) {
+		uint32_t& src_pixel = row[x];
+
+		uint8_t r = (src_pixel >> rs) & 0xFF;
+		uint8_t g = (src_pixel >> gs) & 0xFF;
+		uint8_t b = (src_pixel >> bs) & 0xFF;
+		uint8_t a = (src_pixel >> as) & 0xFF;
+
+		if (skip_transparent && a == 0) {
+			continue;
+		}
+
+		uint8_t lum = (lum_b * b + lum_g * g + lum_r * r) >> 16;
+
+		// Scale Cb/Cr by scale factor "sat"
+		int red = ((lum * 1024 + (r - lum) * saturation) >> 10);
+		red = red > 255 ? 255 : red < 0 ? 0 : red;
+		int green = ((lum * 1024 + (g - lum) * saturation) >> 10);
+		green = green > 255 ? 255 : green < 0 ? 0 : green;
+		int blue = ((lum * 1024 + (b - lum) * saturation) >> 10);
+		blue = blue > 255 ? 255 : blue < 0 ? 0 : blue;
+
+		src_pixel = ((uint32_t)red << rs) | ((uint32_t)green << gs) | ((uint32_t)blue << bs) | ((uint32_t)a << as);
+	}
+}
+
+void SaturationToneScalar(uint32_t* pixels, int width, int height, int stride, int saturation, int rs, int gs, int bs, int as, bool skip_transparent) {
+	for (int y = 0; y < height; ++y) {
+		SaturationToneRow(pixels + y * stride, 0, width, saturation, rs, gs, bs, as, skip_transparent);
+	}
+}
+
+// The vector kernels compute the luminance and the scaled channels with
+// 16 bit multiply-adds. Each 32 bit lane holds a pair of 16 bit values:
+//  lum   = madd(b | g << 16, lum_b | (lum_g / 2) << 16) + madd(g | r << 16, (lum_g / 2) | lum_r << 16)
+//  color = madd(lum | (c - lum) << 16, 1024 | saturation << 16) >> 10
+// This matches the scalar code exactly because all intermediate values fit.
+static_assert(lum_g % 2 == 0 && lum_g / 2 < 0x8000, "luminance coefficient does not fit a 16 bit multiply");
+
+#if defined(EP_KERNELS_SSE2)
+ImageOpacity ComputeOpacitySSE2(const uint32_t* pixels, int width, int height, int stride, uint32_t alpha_mask) {
+	const __m128i mask = _mm_set1_epi32(static_cast<int>(alpha_mask));
+	const __m128i zero = _mm_setzero_si128();
+	__m128i all_transp_v = _mm_set1_epi32(-1);
+	__m128i all_opaque_v = all_transp_v;
+	__m128i alpha_1bit_v = all_transp_v;
+
+	bool all_transp = true;
+	bool all_opaque = true;
+	bool alpha_1bit = true;
+
+	for (int y = 0; y < height; ++y) {
+		const uint32_t* row = pixels + y * stride;
+		int x = 0;
+		for (; x + 4 <= width; x += 4) {
+			__m128i px = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x)), mask);
+			__m128i transp = _mm_cmpeq_epi32(px, zero);
+			__m128i opaque = _mm_cmpeq_epi32(px, mask);
+			all_transp_v = _mm_and_si128(all_transp_v, transp);
+			all_opaque_v = _mm_and_si128(all_opaque_v, opaque);
+			alpha_1bit_v = _mm_and_si128(alpha_1bit_v, _mm_or_si128(transp, opaque));
+		}
+		ComputeOpacityRow(row, x, width, alpha_mask, all_transp, all_opaque, alpha_1bit);
+
+		if (!alpha_1bit || _mm_movemask_epi8(alpha_1bit_v) != 0xFFFF) {
+			return ImageOpacity::Alpha_8Bit;
+		}
+	}
+
+	all_transp &= _mm_movemask_epi8(all_transp_v) == 0xFFFF;
+	all_opaque &= _mm_movemask_epi8(all_opaque_v) == 0xFFFF;
+
+	return MakeOpacity(all_transp, all_opaque, alpha_1bit);
+}
+
+void SaturationToneSSE2(uint32_t* pixels, int width, int height, int stride, int saturation, int rs, int gs, int bs, int as, bool skip_transparent) {
+	const __m128i shift_r = _mm_cvtsi32_si128(rs);
+	const __m128i shift_g = _mm_cvtsi32_si128(gs);
+	const __m128i shift_b = _mm_cvtsi32_si128(bs);
+	const __m128i byte = _mm_set1_epi32(0xFF);
+	const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFFu << as));
+	const __m128i coef_bg = _mm_set1_epi32(((lum_g / 2) << 16) | lum_b);
+	const __m128i coef_gr = _mm_set1_epi32((lum_r << 16) | (lum_g / 2));
+	const __m128i coef_sat = _mm_set1_epi32((saturation << 16) | 1024);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i max = _mm_set1_epi16(255);
+
+	for (int y = 0; y < height; ++y) {
+		uint32_t* row = pixels + y * stride;
+		int x = 0;
+		for (; x + 4 <= width; x += 4) {
+			__m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+			__m128i r = _mm_and_si128(_mm_srl_epi32(px, shift_r), byte);
+			__m128i g = _mm_and_si128(_mm_srl_epi32(px, shift_g), byte);
+			__m128i b = _mm_and_si128(_mm_srl_epi32(px, shift_b), byte);
+
+			__m128i lum = _mm_add_epi32(
+				_mm_madd_epi16(_mm_or_si128(b, _mm_slli_epi32(g, 16)), coef_bg),
+				_mm_madd_epi16(_mm_or_si128(g, _mm_slli_epi32(r, 16)), coef_gr));
+			lum = _mm_srli_epi32(lum, 16);
+
+			r = _mm_srai_epi32(_mm_madd_epi16(_mm_or_si128(lum, _mm_slli_epi32(_mm_sub_epi32(r, lum), 16)), coef_sat), 10);
+			g = _mm_srai_epi32(_mm_madd_epi16(_mm_or_si128(lum, _mm_slli_epi32(_mm_sub_epi32(g, lum), 16)), coef_sat), 10);
+			b = _mm_srai_epi32(_mm_madd_epi16(_mm_or_si128(lum, _mm_slli_epi32(_mm_sub_epi32(b, lum), 16)), coef_sat), 10);
+
+			// Clamp to [0, 255] in 16 bit
+			__m128i rg = _mm_min_epi16(_mm_max_epi16(_mm_packs_epi32(r, g), zero), max);
+			__m128i bb = _mm_min_epi16(_mm_max_epi16(_mm_packs_epi32(b, b), zero), max);
+			r = _mm_unpacklo_epi16(rg, zero);
+			g = _mm_unpackhi_epi16(rg, zero);
+			b = _mm_unpacklo_epi16(bb, zero);
+
+			__m128i alpha = _mm_and_si128(px, alpha_mask);
+			__m128i res = _mm_or_si128(
+				_mm_or_si128(_mm_sll_epi32(r, shift_r), _mm_sll_epi32(g, shift_g)),
+				_mm_or_si128(_mm_sll_epi32(b, shift_b), alpha));
+
+			if (skip_transparent) {
+				__m128i transp = _mm_cmpeq_epi32(alpha, zero);
+				res = _mm_or_si128(_mm_and_si128(transp, px), _mm_andnot_si128(transp, res));
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), res);
+		}
+		SaturationToneRow(row, x, width, saturation, rs, gs, bs, as, skip_transparent);
+	}
+}
+#endif
+
+#if defined(EP_KERNELS_AVX2)
+EP_TARGET_AVX2 ImageOpacity ComputeOpacityAVX2(const uint32_t* pixels, int width, int height, int stride, uint32_t alpha_mask) {
+	const __m256i mask = _mm256_set1_epi32(static_cast<int>(alpha_mask));
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i all_transp_v = _mm256_set1_epi32(-1);
+	__m256i all_opaque_v = all_transp_v;
+	__m256i alpha_1bit_v = all_transp_v;
+
+	bool all_transp = true;
+	bool all_opaque = true;
+	bool alpha_1bit = true;
+
+	for (int y = 0; y < height; ++y) {
+		const uint32_t* row = pixels + y * stride;
+		int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			__m256i px = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x)), mask);
+			__m256i transp = _mm256_cmpeq_epi32(px, zero);
+			__m256i opaque = _mm256_cmpeq_epi32(px, mask);
+			all_transp_v = _mm256_and_si256(all_transp_v, transp);
+			all_opaque_v = _mm256_and_si256(all_opaque_v, opaque);
+			alpha_1bit_v = _mm256_and_si256(alpha_1bit_v, _mm256_or_si256(transp, opaque));
+		}
+		ComputeOpacityRow(row, x, width, alpha_mask, all_transp, all_opaque, alpha_1bit);
+
+		if (!alpha_1bit || _mm256_movemask_epi8(alpha_1bit_v) != -1) {
+			return ImageOpacity::Alpha_8Bit;
+		}
+	}
+
+	all_transp &= _mm256_movemask_epi8(all_transp_v) == -1;
+	all_opaque &= _mm256_movemask_epi8(all_opaque_v) == -1;
+
+	return MakeOpacity(all_transp, all_opaque, alpha_1bit);
+}
+
+EP_TARGET_AVX2 void SaturationToneAVX2(uint32_t* pixels, int width, int height, int stride, int saturation, int rs, int gs, int bs, int as, bool skip_transparent) {
+	const __m128i shift_r = _mm_cvtsi32_si128(rs);
+	const __m128i shift_g = _mm_cvtsi32_si128(gs);
+	const __m128i shift_b = _mm_cvtsi32_si128(bs);
+	const __m256i byte = _mm256_set1_epi32(0xFF);
+	const __m256i alpha_mask = _mm256_set1_epi32(static_cast<int>(0xFFu << as));
+	const __m256i coef_bg = _mm256_set1_epi32(((lum_g / 2) << 16) | lum_b);
+	const __m256i coef_gr = _mm256_set1_epi32((lum_r << 16) | (lum_g / 2));
+	const __m256i coef_sat = _mm256_set1_epi32((saturation << 16) | 1024);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i max = _mm256_set1_epi16(255);
+
+	for (int y = 0; y < height; ++y) {
+		uint32_t* row = pixels + y * stride;
+		int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			__m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x));
+			__m256i r = _mm256_and_si256(_mm256_srl_epi32(px, shift_r), byte);
+			__m256i g = _mm256_and_si256(_mm256_srl_epi32(px, shift_g), byte);
+			__m256i b = _mm256_and_si256(_mm256_srl_epi32(px, shift_b), byte);
+
+			__m256i lum = _mm256_add_epi32(
+				_mm256_madd_epi16(_mm256_or_si256(b, _mm256_slli_epi32(g, 16)), coef_bg),
+				_mm256_madd_epi16(_mm256_or_si256(g, _mm256_slli_epi32(r, 16)), coef_gr));
+			lum = _mm256_srli_epi32(lum, 16);
+
+			r = _mm256_srai_epi32(_mm256_madd_epi16(_mm256_or_si256(lum, _mm256_slli_epi32(_mm256_sub_epi32(r, lum), 16)), coef_sat), 10);
+			g = _mm256_srai_epi32(_mm256_madd_epi16(_mm256_or_si256(lum, _mm256_slli_epi32(_mm256_sub_epi32(g, lum), 16)), coef_sat), 10);
+			b = _mm256_srai_epi32(_mm256_madd_epi16(_mm256_or_si256(lum, _mm256_slli_epi32(_mm256_sub_epi32(b, lum), 16)), coef_sat), 10);
+
+			// Clamp to [0, 255] in 16 bit, pack and unpack both work per 128 bit lane
+			__m256i rg = _mm256_min_epi16(_mm256_max_epi16(_mm256_packs_epi32(r, g), zero), max);
+			__m256i bb = _mm256_min_epi16(_mm256_max_epi16(_mm256_packs_epi32(b, b), zero), max);
+			r = _mm256_unpacklo_epi16(rg, zero);
+			g = _mm256_unpackhi_epi16(rg, zero);
+			b = _mm256_unpacklo_epi16(bb, zero);
+
+			__m256i alpha = _mm256_and_si256(px, alpha_mask);
+			__m256i res = _mm256_or_si256(
+				_mm256_or_si256(_mm256_sll_epi32(r, shift_r), _mm256_sll_epi32(g, shift_g)),
+				_mm256_or_si256(_mm256_sll_epi32(b, shift_b), alpha));
+
+			if (skip_transparent) {
+				__m256i transp = _mm256_cmpeq_epi32(alpha, zero);
+				res = _mm256_blendv_epi8(res, px, transp);
+			}
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(row + x), res);
+		}
+		SaturationToneRow(row, x, width, saturation, rs, gs, bs, as, skip_transparent);
+	}
+}
+#endif
+
+#if defined(EP_KERNELS_NEON)
+inline bool AllSet(uint32x4_t v) {
+	uint32x2_t m = vand_u32(vget_low_u32(v), vget_high_u32(v));
+	return (vget_lane_u32(m, 0) & vget_lane_u32(m, 1)) == 0xFFFFFFFF;
+}
+
+ImageOpacity ComputeOpacityNEON(const uint32_t* pixels, int width, int height, int stride, uint32_t alpha_mask) {
+	const uint32x4_t mask = vdupq_n_u32(alpha_mask);
+	const uint32x4_t zero = vdupq_n_u32(0);
+	uint32x4_t all_transp_v = vdupq_n_u32(0xFFFFFFFF);
+	uint32x4_t all_opaque_v = all_transp_v;
+	uint32x4_t alpha_1bit_v = all_transp_v;
+
+	bool all_transp = true;
+	bool all_opaque = true;
+	bool alpha_1bit = true;
+
+	for (int y = 0; y < height; ++y) {
+		const uint32_t* row = pixels + y * stride;
+		int x = 0;
+		for (; x + 4 <= width; x += 4) {
+			uint32x4_t px = vandq_u32(vld1q_u32(row + x), mask);
+			uint32x4_t transp = vceqq_u32(px, zero);
+			uint32x4_t opaque = vceqq_u32(px, mask);
+			all_transp_v = vandq_u32(all_transp_v, transp);
+			all_opaque_v = vandq_u32(all_opaque_v, opaque);
+			alpha_1bit_v = vandq_u32(alpha_1bit_v, vorrq_u32(transp, opaque));
+		}
+		ComputeOpacityRow(row, x, width, alpha_mask, all_transp, all_opaque, alpha_1bit);
+
+		if (!alpha_1bit || !AllSet(alpha_1bit_v)) {
+			return ImageOpacity::Alpha_8Bit;
+		}
+	}
+
+	all_transp &= AllSet(all_transp_v);
+	all_opaque &= AllSet(all_opaque_v);
+
+	return MakeOpacity(all_transp, all_opaque, alpha_1bit);
+}
+#endif
+
+} // anonymous namespace
+
+Isa GetIsa() {
+	return CurrentIsa().load(std::memory_order_relaxed);
+}
+
+bool SetIsa(Isa isa) {
+	if (!IsSupported(isa)) {
+		return false;
+	}
+
+	CurrentIsa().store(isa, std::memory_order_relaxed);
+	return true;
+}
+
+bool IsSupported(Isa isa) {
+	switch (isa) {
+		case Isa::Scalar:
+			return true;
+		case Isa::SSE2:
+#if defined(EP_KERNELS_SSE2)
+			return true;
+#else
+			return false;
+#endif
+		case Isa::AVX2:
+#if defined(EP_KERNELS_AVX2)
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2");
+#else
+			return false;
+#endif
+		case Isa::NEON:
+#if defined(EP_KERNELS_NEON)
+			return true;
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+const char* GetIsaName(Isa isa) {
+	switch (isa) {
+		case Isa::Scalar:
+			return "Scalar";
+		case Isa::SSE2:
+			return "SSE2";
+		case Isa::AVX2:
+			return "AVX2";
+		case Isa::NEON:
+			return "NEON";
+	}
+	return "Unknown";
+}
+
+ImageOpacity ComputeOpacity(const uint32_t* pixels, int width, int height, int stride, uint32_t alpha_mask) {
+	switch (GetIsa()) {
+#if defined(EP_KERNELS_AVX2)
+		case Isa::AVX2:
+			return ComputeOpacityAVX2(pixels, width, height, stride, alpha_mask);
+#endif
+#if defined(EP_KERNELS_SSE2)
+		case Isa::SSE2:
+			return ComputeOpacitySSE2(pixels, width, height, stride, alpha_mask);
+#endif
+#if defined(EP_KERNELS_NEON)
+		case Isa::NEON:
+			return ComputeOpacityNEON(pixels, width, height, stride, alpha_mask);
+#endif
+		default:
+			return ComputeOpacityScalar(pixels, width, height, stride, alpha_mask);
+	}
+}
+
+void SaturationTone(uint32_t* pixels, int width, int height, int stride, int saturation, int rs, int gs, int bs, int as, bool skip_transparent) {
+	switch (GetIsa()) {
+#if defined(EP_KERNELS_AVX2)
+		case Isa::AVX2:
+			SaturationToneAVX2(pixels, width, height, stride, saturation, rs, gs, bs, as, skip_transparent);
+			return;
+#endif
+#if defined(EP_KERNELS_SSE2)
+		case Isa::SSE2:
+			SaturationToneSSE2(pixels, width, height, stride, saturation, rs, gs, bs, as, skip_transparent);
+			return;
+#endif
+		default:
+			// No NEON kernel yet
+			SaturationToneScalar(pixels, width, height, stride, saturation, rs, gs, bs, as, skip_transparent);
+			return;
+	}
+}
+
+} // namespace BitmapKernels
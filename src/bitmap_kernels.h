@@ -0,0 +1,97 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BITMAP_KERNELS_H
+#define EP_BITMAP_KERNELS_H
+
+// Headers
+#include <cstdint>
+#include "opacity.h"
+
+/**
+ * Pixel loops of the Bitmap class that are not handled by pixman.
+ *
+ * All kernels operate on 32 bit pixels and produce the same result on every
+ * instruction set. The fastest implementation supported by the CPU is
+ * selected on first use, SetIsa can override this for testing and benchmarks.
+ */
+namespace BitmapKernels {
+
+/** Instruction set used by the kernels */
+enum class Isa {
+	Scalar,
+	SSE2,
+	AVX2,
+	NEON
+};
+
+/**
+ * @return instruction set used by the kernels
+ */
+Isa GetIsa();
+
+/**
+ * Overrides the instruction set used by the kernels.
+ *
+ * @param isa instruction set
+ * @return false when the isa is not supported by the build or the CPU
+ */
+bool SetIsa(Isa isa);
+
+/**
+ * @param isa instruction set
+ * @return whether the isa is supported by the build and the CPU
+ */
+bool IsSupported(Isa isa);
+
+/**
+ * @param isa instruction set
+ * @return name of the instruction set
+ */
+const char* GetIsaName(Isa isa);
+
+/**
+ * Classifies the alpha channel of a pixel region.
+ *
+ * @param pixels first pixel of the region
+ * @param width width of the region in pixels
+ * @param height height of the region in pixels
+ * @param stride distance between rows in pixels
+ * @param alpha_mask mask of the alpha channel
+ * @return opacity of the region
+ */
+ImageOpacity ComputeOpacity(const uint32_t* pixels, int width, int height, int stride, uint32_t alpha_mask);
+
+/**
+ * Scales the saturation of a pixel region in place.
+ *
+ * @param pixels first pixel of the region
+ * @param width width of the region in pixels
+ * @param height height of the region in pixels
+ * @param stride distance between rows in pixels
+ * @param saturation saturation factor, 1024 keeps the saturation
+ * @param rs shift of the red channel
+ * @param gs shift of the green channel
+ * @param bs shift of the blue channel
+ * @param as shift of the alpha channel
+ * @param skip_transparent do not modify pixels with an alpha of 0
+ */
+void SaturationTone(uint32_t* pixels, int width, int height, int stride, int saturation, int rs, int gs, int bs, int as, bool skip_transparent);
+
+} // namespace BitmapKernels
+
+#endif
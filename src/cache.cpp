@@ -20,10 +20,13 @@
 #  pragma warning(disable: 4003)
 #endif
 
-#include <map>
-#include <tuple>
-#include <chrono>
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <chrono>
+#include <future>
+#include <list>
+#include <unordered_map>
 
 #include "async_handler.h"
 #include "cache.h"
@@ -34,11 +37,9 @@
 #include "output.h"
 #include "player.h"
 #include <lcf/data.h>
-#include "game_clock.h"
+#include "thread_pool.h"
 #include "translation.h"
 
-using namespace std::chrono_literals;
-
 namespace {
 	std::string MakeHashKey(std::string_view folder_name, std::string_view filename, bool transparent, uint32_t extra_flags = 0) {
 		return fmt::format("{}:{}:{}:{}", folder_name, filename, transparent, extra_flags);
@@ -62,6 +63,15 @@ namespace {
 		return id;
 	}
 
+	std::string MakeEffectHashKey(std::string_view id, bool transparent, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend) {
+		return fmt::format("{}:{}:{},{},{},{}:{}:{}:{},{},{},{}:{},{},{},{}",
+			id, transparent,
+			rect.x, rect.y, rect.width, rect.height,
+			flip_x, flip_y,
+			tone.red, tone.green, tone.blue, tone.gray,
+			blend.red, blend.green, blend.blue, blend.alpha);
+	}
+
 	const char* NameFromTileHash(std::string_view key) {
 		int offset = sizeof(int) + 1;
 		if (static_cast<int>(key.size()) < offset) {
@@ -70,76 +80,137 @@ namespace {
 		return key.data() + offset;
 	}
 
+	using key_type = std::string;
+
 	struct CacheItem {
+		key_type key;
 		BitmapRef bitmap;
-		Game_Clock::time_point last_access;
 	};
 
-	using key_type = std::string;
-	std::unordered_map<key_type, CacheItem> cache;
+	using lru_type = std::list<CacheItem>;
 
-	using tile_key_type = std::string;
-	std::unordered_map<tile_key_type, std::weak_ptr<Bitmap>> cache_tiles;
+	struct CacheEntry {
+		Cache::Category category;
+		lru_type::iterator it;
+	};
 
-	// rect, flip_x, flip_y, tone, blend
-	using effect_key_type = std::tuple<std::string, bool, Rect, bool, bool, Tone, Color>;
-	std::map<effect_key_type, std::weak_ptr<Bitmap>> cache_effects;
+	struct CacheCategory {
+		/** Cached bitmaps, most recently used first */
+		lru_type lru;
+		Cache::Stats stats;
+	};
 
-	std::string system_name;
+	constexpr size_t num_categories = static_cast<size_t>(Cache::Category::END);
+
+	// In KiB, can be overwritten by the user config
+	constexpr size_t default_budgets[num_categories] = {
+		2048, // Charset
+		2048, // Chipset
+		512, // Tile
+		2048, // Panorama
+		4096, // Picture
+		1024, // SpriteEffect
+		4096 // Other
+	};
 
-	std::string system2_name;
+	constexpr const char* category_names[num_categories] = {
+		"Charset",
+		"Chipset",
+		"Tile",
+		"Panorama",
+		"Picture",
+		"SpriteEffect",
+		"Other"
+	};
 
-	constexpr int cache_limit = 10 * 1024 * 1024;
-	size_t cache_size = 0;
+	std::unordered_map<key_type, CacheEntry> cache;
 
-	void FreeBitmapMemory() {
-		auto cur_ticks = Game_Clock::GetFrameTime();
+	std::array<CacheCategory, num_categories> categories = []() {
+		std::array<CacheCategory, num_categories> c;
+		for (size_t i = 0; i < num_categories; ++i) {
+			c[i].stats.budget = default_budgets[i] * 1024;
+		}
+		return c;
+	}();
 
-		for (auto it = cache.begin(); it != cache.end();) {
-			if (it->second.bitmap.use_count() != 1) {
-				// Bitmap is referenced
-				++it;
-				continue;
-			}
+	CacheCategory& GetCategory(Cache::Category category) {
+		return categories[static_cast<size_t>(category)];
+	}
 
-			auto last_access = cur_ticks - it->second.last_access;
-			bool cache_exhausted = cache_size > cache_limit;
-			if (cache_exhausted) {
-				if (last_access <= 50ms) {
-					// Used during the last 3 frames, must be important, keep it.
-					++it;
-					continue;
-				}
-			} else if (last_access <= 3s) {
-				++it;
+	/**
+	 * Frees the least recently used bitmaps until the category fits into its budget.
+	 * Bitmaps still referenced elsewhere cannot be freed, they are moved to the front
+	 * because they are in use.
+	 */
+	void FreeBitmapMemory(CacheCategory& cat) {
+		auto& stats = cat.stats;
+
+		for (size_t checked = cat.lru.size(); stats.size > stats.budget && checked > 0; --checked) {
+			auto it = std::prev(cat.lru.end());
+
+			if (it->bitmap.use_count() != 1) {
+				// Bitmap is referenced
+				cat.lru.splice(cat.lru.begin(), cat.lru, it);
 				continue;
 			}
 
 #ifdef CACHE_DEBUG
-			Output::Debug("Freeing memory of {}/{}", std::get<0>(i.first), std::get<1>(i.first));
+			Output::Debug("Freeing memory of {}", it->key);
 #endif
 
-			cache_size -= it->second.bitmap->GetSize();
+			stats.size -= it->bitmap->GetSize();
+			--stats.items;
+			++stats.evictions;
 
-			it = cache.erase(it);
+			cache.erase(it->key);
+			cat.lru.erase(it);
 		}
 
 #ifdef CACHE_DEBUG
-		Output::Debug("Bitmap cache size: {}", cache_size / 1024.0 / 1024);
+		Output::Debug("Bitmap cache size: {}", stats.size / 1024.0 / 1024);
 #endif
 	}
 
-	BitmapRef AddToCache(const std::string& key, BitmapRef bmp) {
-		if (bmp) {
-			cache_size += bmp->GetSize();
+	BitmapRef FindInCache(Cache::Category category, const key_type& key) {
+		auto& cat = GetCategory(category);
+
+		auto it = cache.find(key);
+		if (it == cache.end()) {
+			++cat.stats.misses;
+			return nullptr;
+		}
+
+		auto& entry_cat = GetCategory(it->second.category);
+		entry_cat.lru.splice(entry_cat.lru.begin(), entry_cat.lru, it->second.it);
+		++entry_cat.stats.hits;
+
+		return it->second.it->bitmap;
+	}
+
+	BitmapRef AddToCache(Cache::Category category, const key_type& key, BitmapRef bmp) {
+		assert(bmp);
+		assert(cache.find(key) == cache.end());
+
+		auto& cat = GetCategory(category);
+
+		cat.lru.push_front({key, bmp});
+		cache[key] = {category, cat.lru.begin()};
+
+		cat.stats.size += bmp->GetSize();
+		++cat.stats.items;
 #ifdef CACHE_DEBUG
-			Output::Debug("Bitmap cache size (Add): {}", cache_size / 1024.0 / 1024.0);
+		Output::Debug("Bitmap cache size (Add): {}", cat.stats.size / 1024.0 / 1024.0);
 #endif
-		}
 
-		return (cache[key] = {bmp, Game_Clock::GetFrameTime()}).bitmap;
+		FreeBitmapMemory(cat);
+
+		return bmp;
 	}
 
+	std::string system_name;
+
+	std::string system2_name;
+
 	struct Material {
 		enum Type {
 			REND = -1,
@@ -180,24 +251,25 @@ namespace {
 		int min_height, max_height;
 		bool oob_check;
 		bool warn_missing;
+		Cache::Category category;
 	};
 	constexpr Spec spec[] = {
-		{ "Backdrop", DrawCheckerboard<Material::Backdrop>, false, 320, 320, 160, 240, true, true },
-		{ "Battle", DrawCheckerboard<Material::Battle>, true, 96, 480, 96, 480, true, true },
-		{ "CharSet", DrawCheckerboard<Material::Charset>, true, 288, 288, 256, 256, true, true },
-		{ "ChipSet", DrawCheckerboard<Material::Chipset>, true, 480, 480, 256, 256, true, true },
-		{ "FaceSet", DrawCheckerboard<Material::Faceset>, true, 192, 192, 192, 192, true, true},
-		{ "GameOver", DrawCheckerboard<Material::Gameover>, false, 320, 320, 240, 240, true, true },
-		{ "Monster", DrawCheckerboard<Material::Monster>, true, 16, 320, 16, 160, false, false },
-		{ "Panorama", DrawCheckerboard<Material::Panorama>, false, 80, 640, 80, 480, false, true },
-		{ "Picture", DrawCheckerboard<Material::Picture>, true, 1, 640, 1, 480, false, true },
-		{ "System", DummySystem, true, 160, 160, 80, 80, true, true },
-		{ "Title", DrawCheckerboard<Material::Title>, false, 320, 320, 240, 240, true, true },
-		{ "System2", DrawCheckerboard<Material::System2>, true, 80, 80, 96, 96, true, true },
-		{ "Battle2", DrawCheckerboard<Material::Battle2>, true, 640, 640, 640, 640, true, true },
-		{ "BattleCharSet", DrawCheckerboard<Material::Battlecharset>, true, 144, 144, 384, 384, true, false },
-		{ "BattleWeapon", DrawCheckerboard<Material::Battleweapon>, true, 192, 192, 512, 512, true, false },
-		{ "Frame", DrawCheckerboard<Material::Frame>, true, 320, 320, 240, 240, true, true },
+		{ "Backdrop", DrawCheckerboard<Material::Backdrop>, false, 320, 320, 160, 240, true, true, Cache::Category::Other },
+		{ "Battle", DrawCheckerboard<Material::Battle>, true, 96, 480, 96, 480, true, true, Cache::Category::Other },
+		{ "CharSet", DrawCheckerboard<Material::Charset>, true, 288, 288, 256, 256, true, true, Cache::Category::Charset },
+		{ "ChipSet", DrawCheckerboard<Material::Chipset>, true, 480, 480, 256, 256, true, true, Cache::Category::Chipset },
+		{ "FaceSet", DrawCheckerboard<Material::Faceset>, true, 192, 192, 192, 192, true, true, Cache::Category::Other },
+		{ "GameOver", DrawCheckerboard<Material::Gameover>, false, 320, 320, 240, 240, true, true, Cache::Category::Other },
+		{ "Monster", DrawCheckerboard<Material::Monster>, true, 16, 320, 16, 160, false, false, Cache::Category::Other },
+		{ "Panorama", DrawCheckerboard<Material::Panorama>, false, 80, 640, 80, 480, false, true, Cache::Category::Panorama },
+		{ "Picture", DrawCheckerboard<Material::Picture>, true, 1, 640, 1, 480, false, true, Cache::Category::Picture },
+		{ "System", DummySystem, true, 160, 160, 80, 80, true, true, Cache::Category::Other },
+		{ "Title", DrawCheckerboard<Material::Title>, false, 320, 320, 240, 240, true, true, Cache::Category::Other },
+		{ "System2", DrawCheckerboard<Material::System2>, true, 80, 80, 96, 96, true, true, Cache::Category::Other },
+		{ "Battle2", DrawCheckerboard<Material::Battle2>, true, 640, 640, 640, 640, true, true, Cache::Category::Other },
+		{ "BattleCharSet", DrawCheckerboard<Material::Battlecharset>, true, 144, 144, 384, 384, true, false, Cache::Category::Other },
+		{ "BattleWeapon", DrawCheckerboard<Material::Battleweapon>, true, 192, 192, 512, 512, true, false, Cache::Category::Other },
+		{ "Frame", DrawCheckerboard<Material::Frame>, true, 320, 320, 240, 240, true, true, Cache::Category::Other },
 	};
 
 	template<Material::Type T>
@@ -235,6 +307,107 @@ namespace {
 		return s.dummy_renderer();
 	}
 
+	template<Material::Type T>
+	uint32_t GetLoadFlags(uint32_t extra_flags) {
+		auto flags = Bitmap::Flag_ReadOnly | (
+				T == Material::Chipset ? Bitmap::Flag_Chipset :
+				T == Material::System ? Bitmap::Flag_System : 0);
+		return flags | extra_flags;
+	}
+
+	/**
+	 * Rejects images that failed to decode or that use a bit depth RPG_RT cannot load.
+	 *
+	 * @return bmp or nullptr when rejected
+	 */
+	BitmapRef ValidateBitmap(const Spec& s, std::string_view filename, BitmapRef bmp) {
+		if (!bmp) {
+			Output::Warning("Invalid image: {}/{}", s.directory, filename);
+		} else if (bmp->GetOriginalBpp() > 8) {
+			// FIXME: This HasActiveTranslation check will also load 32 bit images in the game directory when
+			// a translation is active and our API does not expose whether the asset was redirected or not.
+			if (!Player::HasEasyRpgExtensions() && !Player::IsPatchManiac() && !Tr::HasActiveTranslation()) {
+				Output::Warning("Image {}/{} has a bit depth of {} that is not supported by RPG_RT. Enable EasyRPG Extensions or Maniac Patch to load such images.", s.directory, filename, bmp->GetOriginalBpp());
+				bmp.reset();
+			}
+		}
+		return bmp;
+	}
+
+	struct PrefetchResult {
+		BitmapRef bitmap;
+		/** Messages of the decoder, written when the result is collected */
+		std::vector<Output::LogMessage> log;
+	};
+
+	struct PendingBitmap {
+		std::future<PrefetchResult> bitmap;
+		const Spec* spec;
+		std::string filename;
+	};
+
+	/** Bitmaps requested by Prefetch that are decoded by the prefetch pool */
+	std::unordered_map<key_type, PendingBitmap> pending;
+
+	ThreadPool& GetPrefetchPool() {
+		// Decoding is mostly bound by memory and IO, a few threads are sufficient
+		static ThreadPool pool(std::min(ThreadPool::GetDefaultNumThreads(), 2));
+		return pool;
+	}
+
+	/** Moves finished prefetch jobs into the cache, they are subject to the budgets from now on */
+	void CollectPrefetched() {
+		for (auto it = pending.begin(); it != pending.end();) {
+			auto& job = it->second;
+			if (job.bitmap.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				++it;
+				continue;
+			}
+
+			auto result = job.bitmap.get();
+			Output::WriteMessages(result.log);
+			auto bmp = ValidateBitmap(*job.spec, job.filename, std::move(result.bitmap));
+			if (!bmp) {
+				bmp = job.spec->dummy_renderer();
+			}
+			AddToCache(job.spec->category, it->first, std::move(bmp));
+
+			it = pending.erase(it);
+		}
+	}
+
+	template<Material::Type T>
+	void Prefetch(std::string_view filename, bool transparent, uint32_t extra_flags = 0) {
+		static_assert(Material::REND < T && T < Material::END, "Invalid material.");
+		const Spec& s = spec[T];
+
+		if (!Cache::IsPrefetchSupported() || filename.empty() || filename == CACHE_DEFAULT_BITMAP) {
+			return;
+		}
+
+		auto key = MakeHashKey(s.directory, filename, transparent, extra_flags);
+		if (cache.find(key) != cache.end() || pending.find(key) != pending.end()) {
+			return;
+		}
+
+		// Missing images are reported when they are actually requested
+		auto is = FileFinder::OpenImage(s.directory, filename);
+		if (!is) {
+			return;
+		}
+
+		auto bitmap = GetPrefetchPool().Submit([is = std::move(is), transparent, flags = GetLoadFlags<T>(extra_flags)]() mutable {
+			PrefetchResult result;
+			{
+				// Logging is not thread safe
+				Output::LogBuffer log(result.log);
+				result.bitmap = Bitmap::Create(std::move(is), transparent, flags);
+			}
+			return result;
+		});
+		pending.emplace(std::move(key), PendingBitmap{ std::move(bitmap), &s, ToString(filename) });
+	}
+
 	template<Material::Type T>
 	BitmapRef LoadBitmap(std::string_view filename, bool transparent, uint32_t extra_flags = 0) {
 		static_assert(Material::REND < T && T < Material::END, "Invalid material.");
@@ -245,20 +418,29 @@ namespace {
 		//auto* req = AsyncHandler::RequestFile(s.directory, filename);
 		//assert(req != nullptr && req->IsReady());
 
+		if (!pending.empty()) {
+			CollectPrefetched();
+		}
+
 		BitmapRef bmp;
 
 		const auto key = MakeHashKey(s.directory, filename, transparent, extra_flags);
-		auto it = cache.find(key);
-		if (it == cache.end()) {
+		bmp = FindInCache(s.category, key);
+		if (!bmp) {
 			if (filename == CACHE_DEFAULT_BITMAP) {
 				bmp = LoadDummyBitmap<T>(s.directory, filename, true);
 			}
 
-			if (!bmp) {
+			auto job = pending.find(key);
+			if (!bmp && job != pending.end()) {
+				// Wait for the prefetch job instead of decoding twice
+				auto result = job->second.bitmap.get();
+				Output::WriteMessages(result.log);
+				bmp = ValidateBitmap(s, filename, std::move(result.bitmap));
+				pending.erase(job);
+			} else if (!bmp) {
 				auto is = FileFinder::OpenImage(s.directory, filename);
 
-				FreeBitmapMemory();
-
 				if (!is) {
 					if (s.warn_missing) {
 						Output::Warning("Image not found: {}/{}", s.directory, filename);
@@ -267,24 +449,7 @@ namespace {
 						bmp = CreateEmpty<T>();
 					}
 				} else {
-					auto flags = Bitmap::Flag_ReadOnly | (
-							T == Material::Chipset ? Bitmap::Flag_Chipset :
-							T == Material::System ? Bitmap::Flag_System : 0);
-					flags |= extra_flags;
-
-					bmp = Bitmap::Create(std::move(is), transparent, flags);
-					if (!bmp) {
-						Output::Warning("Invalid image: {}/{}", s.directory, filename);
-					} else {
-						if (bmp->GetOriginalBpp() > 8) {
-							// FIXME: This HasActiveTranslation check will also load 32 bit images in the game directory when
-							// a translation is active and our API does not expose whether the asset was redirected or not.
-							if (!Player::HasEasyRpgExtensions() && !Player::IsPatchManiac() && !Tr::HasActiveTranslation()) {
-								Output::Warning("Image {}/{} has a bit depth of {} that is not supported by RPG_RT. Enable EasyRPG Extensions or Maniac Patch to load such images.", s.directory, filename, bmp->GetOriginalBpp());
-								bmp.reset();
-							}
-						}
-					}
+					bmp = ValidateBitmap(s, filename, Bitmap::Create(std::move(is), transparent, GetLoadFlags<T>(extra_flags)));
 				}
 			}
 
@@ -293,10 +458,7 @@ namespace {
 				bmp = LoadDummyBitmap<T>(s.directory, filename, transparent);
 			}
 
-			bmp = AddToCache(key, bmp);
-		} else {
-			it->second.last_access = Game_Clock::GetFrameTime();
-			bmp = it->second.bitmap;
+			bmp = AddToCache(s.category, key, bmp);
 		}
 
 		assert(bmp);
@@ -408,12 +570,32 @@ BitmapRef Cache::System(std::string_view file, bool bg_preserve_transparent_colo
 	return LoadBitmap<Material::System>(file, flags);
 }
 
+void Cache::PrefetchCharset(std::string_view file) {
+	Prefetch<Material::Charset>(file, spec[Material::Charset].transparent);
+}
+
+void Cache::PrefetchChipset(std::string_view file) {
+	Prefetch<Material::Chipset>(file, spec[Material::Chipset].transparent);
+}
+
+void Cache::PrefetchPanorama(std::string_view file) {
+	Prefetch<Material::Panorama>(file, spec[Material::Panorama].transparent);
+}
+
+void Cache::PrefetchPicture(std::string_view file, bool transparent) {
+	Prefetch<Material::Picture>(file, transparent);
+}
+
+bool Cache::IsPrefetchSupported() {
+	return GetPrefetchPool().GetNumThreads() > 0;
+}
+
 BitmapRef Cache::Exfont() {
 	const auto key = MakeHashKey("ExFont", "ExFont", false);
 
-	auto it = cache.find(key);
+	auto bmp = FindInCache(Category::Other, key);
 
-	if (it == cache.end()) {
+	if (!bmp) {
 		// Allow overwriting of built-in exfont with a custom ExFont image file
 		// exfont_custom is filled by Player::CreateGameObjects
 		BitmapRef exfont_img;
@@ -425,18 +607,16 @@ BitmapRef Cache::Exfont() {
 			exfont_img = Bitmap::Create(exfont_h, sizeof(exfont_h), true);
 		}
 
-		return AddToCache(key, exfont_img);
-	} else {
-		it->second.last_access = Game_Clock::GetFrameTime();
-		return it->second.bitmap;
+		return AddToCache(Category::Other, key, exfont_img);
 	}
+	return bmp;
 }
 
 BitmapRef Cache::Tile(std::string_view filename, int tile_id) {
 	const auto key = MakeTileHashKey(filename, tile_id);
-	auto it = cache_tiles.find(key);
+	auto tile = FindInCache(Category::Tile, key);
 
-	if (it == cache_tiles.end() || it->second.expired()) {
+	if (!tile) {
 		BitmapRef chipset = Cache::Chipset(filename);
 		Rect rect = Rect(0, 0, 16, 16);
 
@@ -463,10 +643,10 @@ BitmapRef Cache::Tile(std::string_view filename, int tile_id) {
 
 		auto bmp = Bitmap::Create(*chipset, rect);
 		bmp->SetId(fmt::format("{}/{}", chipset->GetId(), tile_id));
-		cache_tiles[key] = bmp;
 
-		return bmp;
-	} else { return it->second.lock(); }
+		return AddToCache(Category::Tile, key, bmp);
+	}
+	return tile;
 }
 
 BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend) {
@@ -476,22 +656,16 @@ BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, boo
 		// Log causes false positives when empty bitmaps or placeholder (checkerboard)
 		// bitmaps are used.
 		//Output::Debug("Bitmap has no ID. Please report a bug!");
-		id = fmt::format("{}", (void*)(src_bitmap.get()));
+		// The address is reused by later bitmaps while the effect can still be
+		// cached, the serial number is not.
+		id = fmt::format("#{}", src_bitmap->GetSerial());
 	}
 
-	const effect_key_type key {
-		id,
-		src_bitmap->GetTransparent(),
-		rect,
-		flip_x,
-		flip_y,
-		tone,
-		blend
-	};
+	const auto key = MakeEffectHashKey(id, src_bitmap->GetTransparent(), rect, flip_x, flip_y, tone, blend);
 
-	const auto it = cache_effects.find(key);
+	auto effect = FindInCache(Category::SpriteEffect, key);
 
-	if (it == cache_effects.end() || it->second.expired()) {
+	if (!effect) {
 		BitmapRef bitmap_effects;
 
 		auto create = [&rect] () -> BitmapRef {
@@ -525,25 +699,29 @@ BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, boo
 
 		assert(bitmap_effects && "Effect cache used but no effect applied!");
 
-		return(cache_effects[key] = bitmap_effects).lock();
-	} else { return it->second.lock(); }
+		return AddToCache(Category::SpriteEffect, key, bitmap_effects);
+	}
+	return effect;
 }
 
 void Cache::Clear() {
-	cache_effects.clear();
-	cache.clear();
-	cache_size = 0;
-
-	for (auto& kv : cache_tiles) {
-		auto& key = kv.first;
-		if (kv.second.expired()) {
+	for (auto& item : GetCategory(Category::Tile).lru) {
+		if (item.bitmap.use_count() == 1) {
 			continue;
 		}
 		Output::Debug("possible leak in cached tilemap {}/{}",
-				NameFromTileHash(key), IdFromTileHash(key));
+				NameFromTileHash(item.key), IdFromTileHash(item.key));
 	}
 
-	cache_tiles.clear();
+	// Running jobs finish in the background, their results are discarded
+	pending.clear();
+
+	cache.clear();
+	for (auto& cat : categories) {
+		cat.lru.clear();
+		cat.stats.size = 0;
+		cat.stats.items = 0;
+	}
 }
 
 void Cache::ClearAll() {
@@ -589,3 +767,39 @@ BitmapRef Cache::System2() {
 		return nullptr;
 	}
 }
+
+void Cache::SetBudget(Category category, size_t bytes) {
+	auto& cat = GetCategory(category);
+	cat.stats.budget = bytes;
+	FreeBitmapMemory(cat);
+}
+
+Cache::Stats Cache::GetStats(Category category) {
+	return GetCategory(category).stats;
+}
+
+void Cache::ResetStats() {
+	for (auto& cat : categories) {
+		cat.stats.hits = 0;
+		cat.stats.misses = 0;
+		cat.stats.evictions = 0;
+	}
+}
+
+const char* Cache::GetCategoryName(Category category) {
+	return category_names[static_cast<size_t>(category)];
+}
+
+std::string Cache::GetStatsReport() {
+	std::string report;
+	for (size_t i = 0; i < num_categories; ++i) {
+		const auto category = static_cast<Category>(i);
+		const auto& stats = GetStats(category);
+		report += fmt::format("{}: {} items, {:.1f}/{:.1f} MiB\n",
+			GetCategoryName(category), stats.items,
+			stats.size / 1024.0 / 1024.0, stats.budget / 1024.0 / 1024.0);
+		report += fmt::format(" Hit {} Miss {} Evict {}\n",
+			stats.hits, stats.misses, stats.evictions);
+	}
+	return report;
+}
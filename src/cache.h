@@ -58,6 +58,22 @@ namespace Cache {
 	BitmapRef Tile(std::string_view filename, int tile_id);
 	BitmapRef SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend);
 
+	/**
+	 * Starts decoding an image on a worker thread, a later request of the same
+	 * image waits for the result instead of decoding it again.
+	 * Does nothing when the image is cached already or the build has no
+	 * thread support.
+	 *
+	 * @param filename image to prefetch
+	 */
+	void PrefetchCharset(std::string_view filename);
+	void PrefetchChipset(std::string_view filename);
+	void PrefetchPanorama(std::string_view filename);
+	void PrefetchPicture(std::string_view filename, bool transparent);
+
+	/** @return whether Prefetch* decodes images in the background */
+	bool IsPrefetchSupported();
+
 	void Clear();
 	void ClearAll();
 
@@ -76,6 +92,53 @@ namespace Cache {
 	void SetSystemName(std::string filename);
 	void SetSystem2Name(std::string filename);
 
+	/** Kinds of cached bitmaps, each has its own memory budget */
+	enum class Category {
+		Charset,
+		Chipset,
+		Tile,
+		Panorama,
+		Picture,
+		SpriteEffect,
+		Other,
+		END
+	};
+
+	/** Usage counters of one category */
+	struct Stats {
+		/** Memory used by the cached bitmaps in bytes */
+		size_t size = 0;
+		/** Configured budget in bytes */
+		size_t budget = 0;
+		/** Number of cached bitmaps */
+		int items = 0;
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+	};
+
+	/**
+	 * Sets the memory budget of a category.
+	 * When a category exceeds its budget the least recently used bitmaps
+	 * that are not referenced outside of the cache are freed.
+	 *
+	 * @param category category to configure
+	 * @param bytes budget in bytes
+	 */
+	void SetBudget(Category category, size_t bytes);
+
+	/** @return usage counters of the category */
+	Stats GetStats(Category category);
+
+	/** Resets the hit, miss and eviction counters of all categories */
+	void ResetStats();
+
+	/** @return human readable name of the category */
+	const char* GetCategoryName(Category category);
+
+	/** @return a multiline usage report of all categories */
+	std::string GetStatsReport();
+
 	extern std::vector<uint8_t> exfont_custom;
 }
 
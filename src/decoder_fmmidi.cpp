@@ -20,15 +20,33 @@
 #ifdef WANT_FMMIDI
 
 // Headers
+#include <algorithm>
 #include <cstdio>
 #include <cassert>
 #include "audio_decoder.h"
 #include "output.h"
 #include "decoder_fmmidi.h"
+#include "thread_pool.h"
+
+#ifdef HAVE_THREADS
+namespace {
+	ThreadPool& GetSynthPool() {
+		// Dense songs rarely have more than a few busy channels
+		static ThreadPool pool(std::min(ThreadPool::GetDefaultNumThreads(), 3));
+		return pool;
+	}
+}
+#endif
 
 FmMidiDecoder::FmMidiDecoder() {
 	note_factory.reset(new midisynth::fm_note_factory());
 	synth.reset(new midisynth::synthesizer(note_factory.get()));
+#ifdef HAVE_THREADS
+	// Rendering in parallel only pays off with more than one core
+	if (std::thread::hardware_concurrency() > 1) {
+		synth->set_thread_pool(&GetSynthPool());
+	}
+#endif
 
 	load_programs();
 }
@@ -19,11 +19,44 @@
 #define EP_DRAWABLE_H
 
 #include <cstdint>
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <type_traits>
+#include "rect.h"
 
 class Bitmap;
 class Drawable;
 
+/**
+ * Describes what a drawable rendered during the last draw pass.
+ * Used by the graphics system to redraw only the parts of the screen that
+ * changed between two frames.
+ */
+struct DamageState {
+	/** Screen area touched by the drawable. Empty when nothing was drawn. */
+	Rect rect;
+
+	/** Hash of everything that affects the drawn pixels */
+	uint64_t key = 14695981039346656037ULL;
+
+	/**
+	 * Extends the rect to also cover the passed rect.
+	 *
+	 * @param r area to add
+	 */
+	void AddRect(const Rect& r);
+
+	/**
+	 * Mixes a value into the key.
+	 *
+	 * @param value trivially copyable value to add
+	 * @return *this
+	 */
+	template <typename T>
+	DamageState& Hash(const T& value);
+};
+
 template <typename T>
 static constexpr bool IsDrawable = std::is_base_of<Drawable,T>::value;
 
@@ -57,6 +90,17 @@ public:
 
 	virtual void Draw(Bitmap& dst) = 0;
 
+	/**
+	 * Reports the screen area and state of the last Draw() call.
+	 * Two equal states must produce the same pixels in the same area.
+	 * The default implementation does not support damage tracking.
+	 *
+	 * @param state receives the damage state
+	 * @return false when the drawable cannot describe its output, this
+	 *   forces a redraw of the whole screen
+	 */
+	virtual bool GetDamageState(DamageState& state) const;
+
 	Z_t GetZ() const;
 
 	void SetZ(Z_t z);
@@ -136,6 +180,40 @@ inline Drawable::Flags operator~(Drawable::Flags f) {
 	return static_cast<Drawable::Flags>(~static_cast<unsigned>(f));
 }
 
+inline void DamageState::AddRect(const Rect& r) {
+	if (r.IsEmpty()) {
+		return;
+	}
+	if (rect.IsEmpty()) {
+		rect = r;
+		return;
+	}
+
+	int x2 = std::max(rect.x + rect.width, r.x + r.width);
+	int y2 = std::max(rect.y + rect.height, r.y + r.height);
+	rect.x = std::min(rect.x, r.x);
+	rect.y = std::min(rect.y, r.y);
+	rect.width = x2 - rect.x;
+	rect.height = y2 - rect.y;
+}
+
+template <typename T>
+inline DamageState& DamageState::Hash(const T& value) {
+	static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be hashed");
+
+	// FNV-1a
+	unsigned char bytes[sizeof(T)];
+	std::memcpy(bytes, &value, sizeof(T));
+	for (auto b: bytes) {
+		key = (key ^ b) * 1099511628211ULL;
+	}
+	return *this;
+}
+
+inline bool Drawable::GetDamageState(DamageState&) const {
+	return false;
+}
+
 inline Drawable::Drawable(Z_t z, Flags flags)
 	: _z(z),
 	_flags(flags)
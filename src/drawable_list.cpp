@@ -18,6 +18,7 @@
 // Headers
 #include "drawable_list.h"
 #include "drawable_mgr.h"
+#include "instrumentation.h"
 #include <algorithm>
 #include <cassert>
 
@@ -90,7 +91,13 @@ void DrawableList::TakeFrom(DrawableList& other) noexcept {
 	other.SetClean();
 }
 
+uint32_t DrawableList::draw_pass = 0;
+
 void DrawableList::Draw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z) {
+	Instrumentation::Scope iscope("DrawableList::Draw");
+
+	++draw_pass;
+
 	if (IsDirty()) {
 		Sort();
 	} else {
@@ -111,3 +118,65 @@ void DrawableList::Draw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z) {
 	}
 }
 
+
+bool DrawableList::CollectDamage(std::vector<Rect>& damage) {
+	damage.clear();
+
+	if (IsDirty()) {
+		Sort();
+	}
+
+	next_damage_states.clear();
+	for (auto* drawable : _list) {
+		// Invisible drawables are recorded with an empty rect so that toggling
+		// the visibility does not shift the positions of the other drawables
+		DamageState state;
+		if (drawable->IsVisible() && !drawable->GetDamageState(state)) {
+			ResetDamage();
+			return false;
+		}
+		next_damage_states.push_back({ drawable, state });
+	}
+
+	const bool had_states = damage_states_valid;
+	std::swap(damage_states, next_damage_states);
+	damage_states_valid = true;
+
+	if (!had_states) {
+		return false;
+	}
+
+	auto add = [&](const Rect& rect) {
+		if (!rect.IsEmpty()) {
+			damage.push_back(rect);
+		}
+	};
+
+	// Drawables are compared by position in the sorted list, this way changes
+	// of the draw order are reported as damage, too.
+	const auto& old_states = next_damage_states;
+	const size_t count = std::max(old_states.size(), damage_states.size());
+	for (size_t i = 0; i < count; ++i) {
+		const DamageRecord* o = i < old_states.size() ? &old_states[i] : nullptr;
+		const DamageRecord* n = i < damage_states.size() ? &damage_states[i] : nullptr;
+
+		if (o && n && o->drawable == n->drawable &&
+				o->state.rect == n->state.rect && o->state.key == n->state.key) {
+			continue;
+		}
+
+		if (o) {
+			add(o->state.rect);
+		}
+		if (n) {
+			add(n->state.rect);
+		}
+	}
+
+	return true;
+}
+
+void DrawableList::ResetDamage() {
+	damage_states.clear();
+	damage_states_valid = false;
+}
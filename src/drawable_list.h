@@ -19,6 +19,7 @@
 #define EP_DRAWABLE_LIST_H
 
 #include "drawable.h"
+#include "rect.h"
 #include <memory>
 #include <vector>
 #include <limits>
@@ -131,9 +132,40 @@ class DrawableList {
 		 */
 		void Draw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z);
 
+		/**
+		 * Queries the damage state of every visible drawable and compares it
+		 * with the states recorded by the previous call.
+		 *
+		 * @param damage receives the screen areas that changed since the previous call
+		 * @return false when a drawable does not support damage tracking or when
+		 *   no states were recorded before. The whole screen must be redrawn then.
+		 */
+		bool CollectDamage(std::vector<Rect>& damage);
+
+		/** Forgets the recorded damage states. The next CollectDamage() reports a full redraw. */
+		void ResetDamage();
+
+		/**
+		 * Every call of Draw() starts a new draw pass. Drawables use this to
+		 * detect how often they were drawn in the current pass.
+		 *
+		 * @return id of the current draw pass
+		 */
+		static uint32_t GetDrawPass();
+
 	private:
+		struct DamageRecord {
+			const Drawable* drawable;
+			DamageState state;
+		};
+
 		std::vector<Drawable*> _list;
+		std::vector<DamageRecord> damage_states;
+		std::vector<DamageRecord> next_damage_states;
 		bool _dirty = false;
+		bool damage_states_valid = false;
+
+		static uint32_t draw_pass;
 
 		void SetClean();
 };
@@ -187,6 +219,10 @@ inline void DrawableList::SetClean() {
 	_dirty = false;
 }
 
+inline uint32_t DrawableList::GetDrawPass() {
+	return draw_pass;
+}
+
 inline void DrawableList::Draw(Bitmap& dst) {
 	Draw(dst, std::numeric_limits<Drawable::Z_t>::min(), std::numeric_limits<Drawable::Z_t>::max());
 }
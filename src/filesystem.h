@@ -46,7 +46,9 @@ public:
 	/** Features provided by the filesystem */
 	enum class Feature {
 		/** Filesystem supports Write operations */
-		Write = 1
+		Write = 1,
+		/** Paths are paths of the operating system and can be opened by another NativeFilesystem */
+		Native = 2
 	};
 
 	virtual ~Filesystem() = default;
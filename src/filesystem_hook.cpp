@@ -107,7 +107,8 @@ bool HookFilesystem::MakeDirectory(std::string_view dir, bool follow_symlinks) c
 }
 
 bool HookFilesystem::IsFeatureSupported(Feature f) const {
-	return GetParent().IsFeatureSupported(f);
+	// Reading through the parent directly would bypass the hooks
+	return f != Feature::Native && GetParent().IsFeatureSupported(f);
 }
 
 std::streambuf* HookFilesystem::CreateInputStreambuffer(std::string_view path, std::ios_base::openmode mode) const {
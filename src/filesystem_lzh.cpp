@@ -74,6 +74,54 @@ static LHAInputStreamType vio = {
 	nullptr // close not supported by istream interface
 };
 
+// Larger entries are decompressed while reading instead of at once
+constexpr size_t streaming_threshold = 64 * 1024;
+constexpr size_t streaming_window_size = 64 * 1024;
+
+namespace {
+	/** Decompresses an entry on demand */
+	class LzhStreamBuf : public Filesystem_Stream::InputStreamingStreamBuf {
+	public:
+		LzhStreamBuf(Filesystem_Stream::InputStream lzh_is, LHADecoderType* decoder_type, std::streamoff data_offset, size_t size)
+				: InputStreamingStreamBuf(static_cast<std::streamoff>(size), streaming_window_size), lzh_is(std::move(lzh_is)),
+				decoder_type(decoder_type), data_offset(data_offset), size(size) {
+			Restart();
+		}
+
+		~LzhStreamBuf() override {
+			if (decoder) {
+				lha_decoder_free(decoder);
+			}
+		}
+
+	protected:
+		bool Restart() override {
+			if (decoder) {
+				lha_decoder_free(decoder);
+			}
+
+			lzh_is.clear();
+			lzh_is.seekg(data_offset, std::ios_base::beg);
+			decoder = lha_decoder_new(decoder_type, vio_read_dec_func, &lzh_is, size);
+			return decoder != nullptr;
+		}
+
+		size_t Produce(char* buf, size_t len) override {
+			if (!decoder) {
+				return 0;
+			}
+			return lha_decoder_read(decoder, reinterpret_cast<uint8_t*>(buf), len);
+		}
+
+	private:
+		Filesystem_Stream::InputStream lzh_is;
+		LHADecoderType* decoder_type;
+		LHADecoder* decoder = nullptr;
+		std::streamoff data_offset;
+		size_t size;
+	};
+}
+
 LzhFilesystem::LzhFilesystem(std::string base_path, FilesystemView parent_fs, std::string_view enc) :
 	Filesystem(base_path, parent_fs) {
 	is = parent_fs.OpenInputStream(GetPath());
@@ -282,6 +330,16 @@ std::streambuf* LzhFilesystem::CreateInputStreambuffer(std::string_view path, st
 			return nullptr;
 		}
 
+		if (entry->uncompressed_size > streaming_threshold) {
+			// Every streamed entry uses its own handle on the archive
+			auto entry_is = GetParent().OpenInputStream(GetPath());
+			if (!entry_is) {
+				Output::Warning("LzhFS: Cannot reopen archive for {}", path_normalized);
+				return nullptr;
+			}
+			return new LzhStreamBuf(std::move(entry_is), decoder_type, entry->fileoffset, entry->uncompressed_size);
+		}
+
 		// Seek to the compressed data
 		is.clear();
 		is.seekg(entry->fileoffset, std::ios_base::beg);
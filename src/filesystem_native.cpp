@@ -153,7 +153,7 @@ bool NativeFilesystem::MakeDirectory(std::string_view path, bool follow_symlinks
 }
 
 bool NativeFilesystem::IsFeatureSupported(Feature f) const {
-	return f == Filesystem::Feature::Write;
+	return f == Filesystem::Feature::Write || f == Filesystem::Feature::Native;
 }
 
 std::string NativeFilesystem::Describe() const {
@@ -17,6 +17,7 @@
 
 #include "filesystem_stream.h"
 
+#include <algorithm>
 #include <utility>
 
 #ifdef USE_CUSTOM_FILEBUF
@@ -131,6 +132,85 @@ Filesystem_Stream::InputMemoryStreamBuf::InputMemoryStreamBuf(std::vector<uint8_
 
 }
 
+Filesystem_Stream::InputStreamingStreamBuf::InputStreamingStreamBuf(std::streamoff size, size_t window_size)
+		: std::streambuf(), window(window_size), size(size) {
+	setg(window.data(), window.data(), window.data());
+}
+
+bool Filesystem_Stream::InputStreamingStreamBuf::Skip(std::streamoff len) {
+	while (len > 0) {
+		auto chunk = static_cast<size_t>(std::min<std::streamoff>(len, window.size()));
+		if (Produce(window.data(), chunk) != chunk) {
+			return false;
+		}
+		len -= chunk;
+	}
+	return true;
+}
+
+Filesystem_Stream::InputStreamingStreamBuf::int_type Filesystem_Stream::InputStreamingStreamBuf::underflow() {
+	assert(gptr() == egptr());
+
+	const std::streamoff pos = window_offset + (egptr() - eback());
+	window_offset = pos;
+	setg(window.data(), window.data(), window.data());
+
+	if (pos >= size) {
+		return traits_type::eof();
+	}
+
+	// Apply pending seeks
+	if (pos < produced) {
+		if (!Restart()) {
+			return traits_type::eof();
+		}
+		produced = 0;
+	}
+	if (pos > produced) {
+		if (!Skip(pos - produced)) {
+			produced = size;
+			return traits_type::eof();
+		}
+		produced = pos;
+	}
+
+	auto len = static_cast<size_t>(std::min<std::streamoff>(size - pos, window.size()));
+	auto bytes_read = Produce(window.data(), len);
+	produced += bytes_read;
+	if (bytes_read == 0) {
+		return traits_type::eof();
+	}
+
+	setg(window.data(), window.data(), window.data() + bytes_read);
+
+	return traits_type::to_int_type(*gptr());
+}
+
+std::streambuf::pos_type Filesystem_Stream::InputStreamingStreamBuf::seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
+	std::streambuf::pos_type off;
+	if (dir == std::ios_base::beg) {
+		off = offset;
+	} else if (dir == std::ios_base::cur) {
+		off = window_offset + (gptr() - eback()) + offset;
+	} else {
+		off = size + offset;
+	}
+	return seekpos(off, mode);
+}
+
+std::streambuf::pos_type Filesystem_Stream::InputStreamingStreamBuf::seekpos(std::streambuf::pos_type pos, std::ios_base::openmode) {
+	std::streamoff off = Utils::Clamp<std::streamoff>(pos, 0, size);
+
+	if (off >= window_offset && off <= window_offset + (egptr() - eback())) {
+		setg(eback(), eback() + (off - window_offset), egptr());
+	} else {
+		// Outside of the window: The producer catches up on the next read
+		window_offset = off;
+		setg(window.data(), window.data(), window.data());
+	}
+	return off;
+}
+
 #ifdef USE_CUSTOM_FILEBUF
 
 Filesystem_Stream::FdStreamBuf::FdStreamBuf(int fd, bool is_read) : fd(fd), is_read(is_read) {
@@ -98,6 +98,60 @@ namespace Filesystem_Stream {
 		std::vector<uint8_t> buffer;
 	};
 
+	/**
+	 * Streambuf interface for data that is produced incrementally, e.g. by a decompressor.
+	 * Only a window of the data is kept in memory. Seeking is lazy: Forward seeks
+	 * skip data on the next read, seeks before the window restart the producer.
+	 */
+	class InputStreamingStreamBuf : public std::streambuf {
+	public:
+		/**
+		 * @param size total amount of bytes the producer provides
+		 * @param window_size amount of bytes kept in memory
+		 */
+		InputStreamingStreamBuf(std::streamoff size, size_t window_size);
+		InputStreamingStreamBuf(InputStreamingStreamBuf const& other) = delete;
+		InputStreamingStreamBuf const& operator=(InputStreamingStreamBuf const& other) = delete;
+
+	protected:
+		/**
+		 * Restarts the producer at the beginning of the data.
+		 *
+		 * @return whether the restart succeeded
+		 */
+		virtual bool Restart() = 0;
+
+		/**
+		 * Produces the next bytes of the data.
+		 *
+		 * @param buf buffer to write into
+		 * @param len maximum amount of bytes to produce
+		 * @return amount of bytes produced, 0 on error
+		 */
+		virtual size_t Produce(char* buf, size_t len) = 0;
+
+		/**
+		 * Discards the next bytes of the data.
+		 * The default implementation produces them into the window.
+		 *
+		 * @param len amount of bytes to skip
+		 * @return whether all bytes were skipped
+		 */
+		virtual bool Skip(std::streamoff len);
+
+		int_type underflow() override;
+		std::streambuf::pos_type seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
+		std::streambuf::pos_type seekpos(std::streambuf::pos_type pos, std::ios_base::openmode mode) override;
+
+	private:
+		std::vector<char> window;
+		/** Offset of the window in the data */
+		std::streamoff window_offset = 0;
+		/** Offset of the next byte the producer returns */
+		std::streamoff produced = 0;
+		std::streamoff size;
+	};
+
 #ifdef USE_CUSTOM_FILEBUF
 	class FdStreamBuf : public std::streambuf {
 	public:
@@ -37,6 +37,102 @@ constexpr uint32_t central_directory_entry = 0x02014b50;
 constexpr uint32_t local_header = 0x04034b50;
 constexpr uint32_t local_header_size = 30;
 
+// Larger entries are decompressed while reading instead of at once
+constexpr uint32_t streaming_threshold = 64 * 1024;
+constexpr size_t streaming_window_size = 64 * 1024;
+constexpr size_t streaming_input_size = 16 * 1024;
+
+namespace {
+	/** Reads a stored entry directly from the archive */
+	class ZipStoredStreamBuf : public Filesystem_Stream::InputStreamingStreamBuf {
+	public:
+		ZipStoredStreamBuf(Filesystem_Stream::InputStream zip_is, std::streamoff data_offset, uint32_t size)
+				: InputStreamingStreamBuf(size, streaming_window_size), zip_is(std::move(zip_is)), data_offset(data_offset) {
+			Restart();
+		}
+
+	protected:
+		bool Restart() override {
+			zip_is.clear();
+			zip_is.seekg(data_offset);
+			return !zip_is.fail();
+		}
+
+		size_t Produce(char* buf, size_t len) override {
+			return static_cast<size_t>(zip_is.read(buf, len).gcount());
+		}
+
+		bool Skip(std::streamoff len) override {
+			zip_is.seekg(len, std::ios_base::cur);
+			return !zip_is.fail();
+		}
+
+	private:
+		Filesystem_Stream::InputStream zip_is;
+		std::streamoff data_offset;
+	};
+
+	/** Inflates a deflated entry on demand */
+	class ZipDeflateStreamBuf : public Filesystem_Stream::InputStreamingStreamBuf {
+	public:
+		ZipDeflateStreamBuf(Filesystem_Stream::InputStream zip_is, std::streamoff data_offset, uint32_t compressed_size, uint32_t size, std::string name)
+				: InputStreamingStreamBuf(size, streaming_window_size), zip_is(std::move(zip_is)), data_offset(data_offset),
+				compressed_size(compressed_size), name(std::move(name)), input(streaming_input_size) {
+			inflateInit2(&zlib_stream, -MAX_WBITS);
+			Restart();
+		}
+
+		~ZipDeflateStreamBuf() override {
+			inflateEnd(&zlib_stream);
+		}
+
+	protected:
+		bool Restart() override {
+			zip_is.clear();
+			zip_is.seekg(data_offset);
+			compressed_remaining = compressed_size;
+			zlib_stream.avail_in = 0;
+			done = false;
+			return inflateReset(&zlib_stream) == Z_OK && !zip_is.fail();
+		}
+
+		size_t Produce(char* buf, size_t len) override {
+			zlib_stream.next_out = reinterpret_cast<Bytef*>(buf);
+			zlib_stream.avail_out = static_cast<uInt>(len);
+
+			while (zlib_stream.avail_out > 0 && !done) {
+				if (zlib_stream.avail_in == 0 && compressed_remaining > 0) {
+					auto chunk = std::min<size_t>(compressed_remaining, input.size());
+					auto bytes_read = static_cast<size_t>(zip_is.read(input.data(), chunk).gcount());
+					compressed_remaining -= bytes_read;
+					zlib_stream.next_in = reinterpret_cast<Bytef*>(input.data());
+					zlib_stream.avail_in = static_cast<uInt>(bytes_read);
+				}
+
+				int zlib_error = inflate(&zlib_stream, Z_NO_FLUSH);
+				if (zlib_error == Z_STREAM_END) {
+					done = true;
+				} else if (zlib_error != Z_OK) {
+					Output::Warning("ZipFS: zlib failed for {}: {} ({})", name, zlib_error, zlib_stream.msg ? zlib_stream.msg : "No error message");
+					done = true;
+				}
+			}
+
+			return len - zlib_stream.avail_out;
+		}
+
+	private:
+		Filesystem_Stream::InputStream zip_is;
+		std::streamoff data_offset;
+		uint32_t compressed_size;
+		uint32_t compressed_remaining = 0;
+		std::string name;
+		std::vector<char> input;
+		z_stream zlib_stream = {};
+		bool done = false;
+	};
+}
+
 static std::string normalize_path(std::string_view path) {
 	if (path == "." || path == "/" || path.empty()) {
 		return "";
@@ -394,7 +490,22 @@ std::streambuf* ZipFilesystem::CreateInputStreambuffer(std::string_view path, st
 				return nullptr;
 			}
 
-			zip_is.seekg(central_entry->fileoffset + local_entry.fileoffset);
+			const std::streamoff data_offset = central_entry->fileoffset + local_entry.fileoffset;
+			if (local_entry.uncompressed_size > streaming_threshold && (method == StorageMethod::Plain || method == StorageMethod::Deflate)) {
+				// Every streamed entry uses its own handle on the archive
+				auto entry_is = GetParent().OpenInputStream(GetPath());
+				if (!entry_is) {
+					Output::Warning("ZipFS: Cannot reopen archive for {}", path_normalized);
+					return nullptr;
+				}
+
+				if (method == StorageMethod::Plain) {
+					return new ZipStoredStreamBuf(std::move(entry_is), data_offset, local_entry.uncompressed_size);
+				}
+				return new ZipDeflateStreamBuf(std::move(entry_is), data_offset, local_entry.compressed_size, local_entry.uncompressed_size, path_normalized);
+			}
+
+			zip_is.seekg(data_offset);
 			if (method == StorageMethod::Plain) {
 				auto data = std::vector<uint8_t>(local_entry.uncompressed_size);
 				zip_is.read(reinterpret_cast<char*>(data.data()), data.size());
@@ -17,8 +17,10 @@
 
 // Headers
 #include <cstdint>
+#include <list>
 #include <map>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <iterator>
 
@@ -164,6 +166,32 @@ namespace {
 	private:
 		void SetSize(int height, bool create);
 
+		/**
+		 * Looks up a rendered glyph of the current size in the glyph cache.
+		 *
+		 * @param glyph glyph index
+		 * @return cached glyph or nullptr when not rendered yet
+		 */
+		const GlyphRet* FindGlyph(char32_t glyph) const;
+
+		/**
+		 * Adds a rendered glyph of the current size to the glyph cache.
+		 * The least recently used glyph is dropped when the cache is full.
+		 *
+		 * @param glyph glyph index
+		 * @param gret rendered glyph
+		 */
+		void AddGlyph(char32_t glyph, const GlyphRet& gret) const;
+
+		/** Rendered glyphs, most recently used in front */
+		struct GlyphCacheItem {
+			uint64_t key;
+			GlyphRet gret;
+		};
+		using glyph_lru_type = std::list<GlyphCacheItem>;
+		mutable glyph_lru_type glyph_lru;
+		mutable std::unordered_map<uint64_t, glyph_lru_type::iterator> glyph_cache;
+
 		FT_Face face = nullptr;
 		std::vector<uint8_t> ft_buffer;
 		// Freetype uses the baseline as 0 and the built-in fonts the top
@@ -221,6 +249,16 @@ namespace {
 	constexpr int cache_limit = 3;
 	size_t cache_size = 0;
 
+	// Rendered glyphs kept per font, a 12px glyph uses around 500 byte
+	constexpr size_t glyph_cache_limit = 512;
+
+	constexpr uint64_t glyph_cache_key(int size, char32_t glyph) {
+		return (static_cast<uint64_t>(static_cast<uint32_t>(size)) << 32) | glyph;
+	}
+
+	// Shaped texts kept per font, enough for the items of large menus
+	constexpr size_t shape_cache_limit = 256;
+
 	using namespace std::chrono_literals;
 
 	void FreeFontMemory() {
@@ -354,6 +392,10 @@ Rect FTFont::vGetSize(char32_t glyph) const {
 		}
 	}
 
+	if (auto* cached = FindGlyph(glyph_index)) {
+		return {0, 0, cached->advance.x, cached->advance.y};
+	}
+
 	auto load_glyph = [&](auto flags) {
 		if (FT_Load_Glyph(face, glyph_index, flags) != FT_Err_Ok) {
 			Output::Debug("Couldn't load FreeType character {:#x}", uint32_t(glyph));
@@ -418,6 +460,10 @@ Font::GlyphRet FTFont::vRenderShaped(char32_t glyph) const {
 		}
 	}
 
+	if (auto* cached = FindGlyph(glyph)) {
+		return *cached;
+	}
+
 	auto render_glyph = [&](auto flags, auto mode) {
 		if (FT_Load_Glyph(face, glyph, flags) != FT_Err_Ok) {
 			Output::Debug("Couldn't load FreeType character {:#x}", uint32_t(glyph));
@@ -439,7 +485,7 @@ Font::GlyphRet FTFont::vRenderShaped(char32_t glyph) const {
 
 		// When it is a color font check if the glyph is a color glyph
 		// If it is not then rerender the glyph monochrome
-		// FIXME: This is inefficient
+		// This is only done once per glyph because of the glyph cache
 		if (face->glyph->bitmap.pixel_mode != FT_PIXEL_MODE_BGRA) {
 			render_glyph(FT_LOAD_MONOCHROME | FT_LOAD_TARGET_MONO, FT_RENDER_MODE_MONO);
 		}
@@ -466,7 +512,9 @@ Font::GlyphRet FTFont::vRenderShaped(char32_t glyph) const {
 	bool has_color = false;
 
 	if (ft_bitmap->pixel_mode == FT_PIXEL_MODE_BGRA) {
-		bm = Bitmap::Create(ft_bitmap->buffer, width, height, 0, format_B8G8R8A8_a().format());
+		// The FreeType buffer is reused by the next glyph, the cached glyph needs a copy
+		auto ft_bm = Bitmap::Create(ft_bitmap->buffer, width, height, 0, format_B8G8R8A8_a().format());
+		bm = Bitmap::Create(*ft_bm, ft_bm->GetRect());
 		has_color = true;
 	} else {
 		bm = Bitmap::Create(width, height);
@@ -494,7 +542,32 @@ Font::GlyphRet FTFont::vRenderShaped(char32_t glyph) const {
 		advance.x = 6;
 	}
 
-	return { bm, advance, offset, has_color };
+	GlyphRet gret = { bm, advance, offset, has_color };
+	AddGlyph(glyph, gret);
+
+	return gret;
+}
+
+const Font::GlyphRet* FTFont::FindGlyph(char32_t glyph) const {
+	auto it = glyph_cache.find(glyph_cache_key(current_style.size, glyph));
+	if (it == glyph_cache.end()) {
+		return nullptr;
+	}
+
+	glyph_lru.splice(glyph_lru.begin(), glyph_lru, it->second);
+	return &it->second->gret;
+}
+
+void FTFont::AddGlyph(char32_t glyph, const GlyphRet& gret) const {
+	const uint64_t key = glyph_cache_key(current_style.size, glyph);
+
+	glyph_lru.push_front({key, gret});
+	glyph_cache[key] = glyph_lru.begin();
+
+	if (glyph_lru.size() > glyph_cache_limit) {
+		glyph_cache.erase(glyph_lru.back().key);
+		glyph_lru.pop_back();
+	}
 }
 
 bool FTFont::vCanShape() const {
@@ -902,11 +975,37 @@ bool Font::CanShape() const {
 std::vector<Font::ShapeRet> Font::Shape(std::u32string_view text) const {
 	assert(vCanShape());
 
-	return vShape(text);
+	// The result depends on the font size, the letter spacing is applied later
+	std::u32string key;
+	key.reserve(text.size() + 1);
+	key += static_cast<char32_t>(current_style.size);
+	key += text;
+
+	auto it = shape_cache.find(key);
+	if (it != shape_cache.end()) {
+		shape_lru.splice(shape_lru.begin(), shape_lru, it->second);
+		return it->second->shape;
+	}
+
+	auto shape = vShape(text);
+
+	shape_lru.push_front({std::move(key), shape});
+	shape_cache[shape_lru.front().key] = shape_lru.begin();
+
+	if (shape_lru.size() > shape_cache_limit) {
+		shape_cache.erase(shape_lru.back().key);
+		shape_lru.pop_back();
+	}
+
+	return shape;
 }
 
 void Font::SetFallbackFont(FontRef fallback_font) {
 	this->fallback_font = fallback_font;
+
+	// Glyphs missing in the font were measured with the old fallback font
+	shape_cache.clear();
+	shape_lru.clear();
 }
 
 bool Font::IsStyleApplied() const {
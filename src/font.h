@@ -25,7 +25,10 @@
 #include "memory_management.h"
 #include "rect.h"
 #include "string_view.h"
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <lcf/scope_guard.h>
 
 class Color;
@@ -180,6 +183,7 @@ class Font {
 	/**
 	 * Shapes the passed text and returns new codepoints and positioning information.
 	 * This method will abort when shaping is not supported.
+	 * The results of recently shaped texts are cached.
 	 *
 	 * @see CanShape()
 	 * @param text Text to shape
@@ -265,6 +269,17 @@ class Font {
 
 private:
 	bool RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys, int color, const GlyphRet& gret) const;
+
+	/** Shaped texts, most recently used in front */
+	struct ShapeCacheItem {
+		/** Font size followed by the text */
+		std::u32string key;
+		std::vector<ShapeRet> shape;
+	};
+	using shape_lru_type = std::list<ShapeCacheItem>;
+	mutable shape_lru_type shape_lru;
+	/** Keys are views of the key in shape_lru */
+	mutable std::unordered_map<std::u32string_view, shape_lru_type::iterator> shape_cache;
 };
 
 #endif
@@ -15,6 +15,7 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <sstream>
 
 #include "fps_overlay.h"
@@ -24,11 +25,16 @@
 #include "input.h"
 #include "font.h"
 #include "drawable_mgr.h"
+#include "player.h"
+#include "instrumentation.h"
 
 using namespace std::chrono_literals;
 
 static constexpr auto refresh_frequency = 1s;
 
+// Amount of scopes listed in the timing breakdown
+static constexpr int max_timings = 6;
+
 FpsOverlay::FpsOverlay() :
 	Drawable(Priority_Overlay + 100, Drawable::Flags::Global)
 {
@@ -43,6 +49,29 @@ void FpsOverlay::UpdateText() {
 	fps_dirty = true;
 }
 
+void FpsOverlay::UpdateTimings(Game_Clock::time_point since) {
+	int frames = Game_Clock::GetFrame() - last_refresh_frame;
+	last_refresh_frame = Game_Clock::GetFrame();
+
+	if (!Instrumentation::IsRecording()) {
+		if (!timings_text.empty()) {
+			timings_text.clear();
+			timings_dirty = true;
+		}
+		return;
+	}
+
+	timings_text.clear();
+	for (auto& t: Instrumentation::GetMainThreadTimings(since)) {
+		if (static_cast<int>(timings_text.size()) >= max_timings) {
+			break;
+		}
+		auto ms = std::chrono::duration<double, std::milli>(t.time).count() / std::max(frames, 1);
+		timings_text.push_back(fmt::format("{} {:.2f}ms", t.name, ms));
+	}
+	timings_dirty = true;
+}
+
 bool FpsOverlay::Update() {
 	int mod = static_cast<int>(Game_Clock::GetGameSpeedFactor());
 	if (mod != last_speed_mod) {
@@ -55,6 +84,7 @@ bool FpsOverlay::Update() {
 	if (dt < refresh_frequency) {
 		return false;
 	}
+	UpdateTimings(last_refresh_time);
 	last_refresh_time = now;
 
 	UpdateText();
@@ -62,6 +92,25 @@ bool FpsOverlay::Update() {
 	return true;
 }
 
+bool FpsOverlay::GetDamageState(DamageState& state) const {
+	if (draw_fps && fps_bitmap) {
+		state.AddRect(Rect(1, 2, fps_rect.width, fps_rect.height));
+		state.Hash(fps_bitmap.get()).Hash(fps_bitmap->GetRevision()).Hash(fps_rect);
+
+		if (!timings_rect.IsEmpty() && timings_bitmap) {
+			state.AddRect(Rect(1, 2 + fps_rect.height + 1, timings_rect.width, timings_rect.height));
+			state.Hash(timings_bitmap.get()).Hash(timings_bitmap->GetRevision()).Hash(timings_rect);
+		}
+	}
+
+	if (last_speed_mod > 1 && speedup_bitmap) {
+		state.AddRect(Rect(Player::screen_width - speedup_rect.width - 1, 2, speedup_rect.width, speedup_rect.height));
+		state.Hash(speedup_bitmap.get()).Hash(speedup_bitmap->GetRevision()).Hash(speedup_rect);
+	}
+
+	return true;
+}
+
 void FpsOverlay::Draw(Bitmap& dst) {
 	if (draw_fps) {
 		if (fps_dirty) {
@@ -82,6 +131,35 @@ void FpsOverlay::Draw(Bitmap& dst) {
 		}
 
 		dst.Blit(1, 2, *fps_bitmap, fps_rect, 255);
+
+		if (timings_dirty) {
+			int width = 0;
+			int line_height = 0;
+			for (auto& line: timings_text) {
+				Rect rect = Text::GetSize(*Font::DefaultBitmapFont(), line);
+				width = std::max(width, rect.width + 1);
+				line_height = std::max(line_height, rect.height - 1);
+			}
+
+			timings_rect = Rect(0, 0, width, line_height * static_cast<int>(timings_text.size()));
+
+			if (!timings_rect.IsEmpty()) {
+				if (!timings_bitmap || timings_bitmap->GetWidth() < timings_rect.width || timings_bitmap->GetHeight() < timings_rect.height) {
+					timings_bitmap = Bitmap::Create(timings_rect.width, timings_rect.height, true);
+				}
+				timings_bitmap->Clear();
+				timings_bitmap->FillRect(timings_rect, Color(0, 0, 0, 128));
+				for (size_t i = 0; i < timings_text.size(); ++i) {
+					Text::Draw(*timings_bitmap, 1, static_cast<int>(i) * line_height, *Font::DefaultBitmapFont(), Color(255, 255, 255, 255), timings_text[i]);
+				}
+			}
+
+			timings_dirty = false;
+		}
+
+		if (!timings_rect.IsEmpty()) {
+			dst.Blit(1, 2 + fps_rect.height + 1, *timings_bitmap, timings_rect, 255);
+		}
 	}
 
 	// Always drawn when speedup is on independent of FPS
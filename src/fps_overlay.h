@@ -20,6 +20,7 @@
 
 #include <deque>
 #include <string>
+#include <vector>
 #include "drawable.h"
 #include "memory_management.h"
 #include "rect.h"
@@ -28,6 +29,8 @@
 /**
  * FpsOverlay class.
  * Shows current FPS and the speedup indicator.
+ * When instrumentation recording is enabled the time spent per frame in the
+ * named instrumentation scopes is shown below the FPS.
  */
 class FpsOverlay : public Drawable {
 public:
@@ -35,6 +38,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamageState(DamageState& state) const override;
+
 	/**
 	 * Update the fps overlay.
 	 *
@@ -58,20 +63,26 @@ public:
 
 private:
 	void UpdateText();
+	void UpdateTimings(Game_Clock::time_point since);
 
 	BitmapRef fps_bitmap;
 	BitmapRef speedup_bitmap;
+	BitmapRef timings_bitmap;
 	Game_Clock::time_point last_refresh_time;
+	int last_refresh_frame = 0;
 
 	/** Rect to draw on screen */
 	Rect fps_rect;
 	Rect speedup_rect;
+	Rect timings_rect;
 
 	std::string text;
+	std::vector<std::string> timings_text;
 
 	int last_speed_mod = 1;
 	bool speedup_dirty = true;
 	bool fps_dirty = true;
+	bool timings_dirty = false;
 	bool draw_fps = true;
 };
 
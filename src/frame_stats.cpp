@@ -0,0 +1,91 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "frame_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <fmt/ostream.h>
+
+void FrameStats::Reserve(int num_frames) {
+	update_times.reserve(num_frames);
+	draw_times.reserve(num_frames);
+}
+
+void FrameStats::Add(duration update, duration draw) {
+	update_times.push_back(update);
+	draw_times.push_back(draw);
+}
+
+FrameStats::duration FrameStats::Percentile(std::vector<duration> values, double p) {
+	if (values.empty()) {
+		return duration();
+	}
+
+	p = std::clamp(p, 0.0, 100.0);
+	auto rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+	rank = std::max<size_t>(rank, 1) - 1;
+
+	std::nth_element(values.begin(), values.begin() + rank, values.end());
+	return values[rank];
+}
+
+FrameStats::duration FrameStats::GetUpdatePercentile(double p) const {
+	return Percentile(update_times, p);
+}
+
+FrameStats::duration FrameStats::GetDrawPercentile(double p) const {
+	return Percentile(draw_times, p);
+}
+
+FrameStats::duration FrameStats::GetTotalPercentile(double p) const {
+	std::vector<duration> total(update_times.size());
+	std::transform(update_times.begin(), update_times.end(), draw_times.begin(), total.begin(), std::plus<>());
+	return Percentile(std::move(total), p);
+}
+
+FrameStats::duration FrameStats::GetTotalTime() const {
+	duration total = {};
+	for (size_t i = 0; i < update_times.size(); ++i) {
+		total += update_times[i] + draw_times[i];
+	}
+	return total;
+}
+
+void FrameStats::Print(std::ostream& os) const {
+	auto ms = [](duration d) {
+		return std::chrono::duration<double, std::milli>(d).count();
+	};
+
+	const auto total = std::chrono::duration<double>(GetTotalTime()).count();
+	fmt::print(os, "Benchmark: {} frames in {:.3f}s ({:.1f} fps)\n",
+		GetNumFrames(), total, total > 0.0 ? GetNumFrames() / total : 0.0);
+
+	constexpr double percentiles[] = { 0, 50, 90, 95, 99, 100 };
+	fmt::print(os, "{:<8}{:>10}{:>10}{:>10}{:>10}{:>10}{:>10}\n", "ms", "min", "p50", "p90", "p95", "p99", "max");
+
+	auto row = [&](const char* name, auto&& fn) {
+		fmt::print(os, "{:<8}", name);
+		for (auto p: percentiles) {
+			fmt::print(os, "{:>10.3f}", ms(fn(p)));
+		}
+		fmt::print(os, "\n");
+	};
+	row("update", [this](double p) { return GetUpdatePercentile(p); });
+	row("draw", [this](double p) { return GetDrawPercentile(p); });
+	row("total", [this](double p) { return GetTotalPercentile(p); });
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_FRAME_STATS_H
+#define EP_FRAME_STATS_H
+
+#include "game_clock.h"
+#include <ostream>
+#include <vector>
+
+/**
+ * Collects per-frame update and draw timings and reports percentiles.
+ * Used by the --benchmark-frames mode.
+ */
+class FrameStats {
+public:
+	using duration = Game_Clock::duration;
+
+	/**
+	 * Preallocates storage for the given amount of frames.
+	 *
+	 * @param num_frames expected amount of frames
+	 */
+	void Reserve(int num_frames);
+
+	/**
+	 * Records the timing of one frame.
+	 *
+	 * @param update time spent in the scene update
+	 * @param draw time spent rendering the frame
+	 */
+	void Add(duration update, duration draw);
+
+	/** @return amount of recorded frames */
+	int GetNumFrames() const;
+
+	/**
+	 * @param p percentile in range [0, 100]
+	 * @return update time of the given percentile
+	 */
+	duration GetUpdatePercentile(double p) const;
+
+	/**
+	 * @param p percentile in range [0, 100]
+	 * @return draw time of the given percentile
+	 */
+	duration GetDrawPercentile(double p) const;
+
+	/**
+	 * @param p percentile in range [0, 100]
+	 * @return update + draw time of the given percentile
+	 */
+	duration GetTotalPercentile(double p) const;
+
+	/** @return sum of all update and draw times */
+	duration GetTotalTime() const;
+
+	/**
+	 * Writes a human readable summary table.
+	 *
+	 * @param os stream to write to
+	 */
+	void Print(std::ostream& os) const;
+
+	/**
+	 * Computes a percentile using the nearest-rank method.
+	 *
+	 * @param values samples, will be sorted
+	 * @param p percentile in range [0, 100]
+	 * @return the percentile or 0 when values is empty
+	 */
+	static duration Percentile(std::vector<duration> values, double p);
+
+private:
+	std::vector<duration> update_times;
+	std::vector<duration> draw_times;
+};
+
+inline int FrameStats::GetNumFrames() const {
+	return static_cast<int>(update_times.size());
+}
+
+#endif
@@ -136,6 +136,7 @@ void Game_Actor::SetSaveData(lcf::rpg::SaveActor save) {
 	}
 
 	data = std::move(save);
+	InvalidateBattleStats();
 
 	if (Player::IsRPG2k()) {
 		data.two_weapon = dbActor->two_weapon;
@@ -348,6 +349,7 @@ int Game_Actor::SetEquipment(int equip_type, int new_item_id) {
 	}
 
 	data.equipped[equip_type - 1] = (short)new_item_id;
+	InvalidateBattleStats();
 
 	AdjustEquipmentStates(old_item, false, false);
 	AdjustEquipmentStates(new_item, true, false);
@@ -785,6 +787,7 @@ void Game_Actor::ChangeExp(int exp, PendingMessage* pm) {
 
 void Game_Actor::SetLevel(int _level) {
 	data.level = Utils::Clamp(_level, 1, GetMaxLevel());
+	InvalidateBattleStats();
 	// Ensure current HP/SP remain clamped if new Max HP/SP is less.
 	SetHp(GetHp());
 	SetSp(GetSp());
@@ -1019,6 +1022,7 @@ void Game_Actor::ChangeClass(int new_class_id,
 	data.agility_mod = 0;
 
 	data.class_id = new_class_id;
+	InvalidateBattleStats();
 	data.changed_battle_commands = true; // Any change counts as a battle commands change.
 
 	// The class settings are not applied when the actor has a class on startup
@@ -1152,21 +1156,25 @@ int Game_Actor::SetSp(int sp) {
 void Game_Actor::SetBaseAtk(int atk) {
 	int new_attack_mod = data.attack_mod + (atk - GetBaseAtk());
 	data.attack_mod = ClampStatMod(new_attack_mod, this);
+	InvalidateBattleStats();
 }
 
 void Game_Actor::SetBaseDef(int def) {
 	int new_defense_mod = data.defense_mod + (def - GetBaseDef());
 	data.defense_mod = ClampStatMod(new_defense_mod, this);
+	InvalidateBattleStats();
 }
 
 void Game_Actor::SetBaseSpi(int spi) {
 	int new_spirit_mod = data.spirit_mod + (spi - GetBaseSpi());
 	data.spirit_mod = ClampStatMod(new_spirit_mod, this);
+	InvalidateBattleStats();
 }
 
 void Game_Actor::SetBaseAgi(int agi) {
 	int new_agility_mod = data.agility_mod + (agi - GetBaseAgi());
 	data.agility_mod = ClampStatMod(new_agility_mod, this);
+	InvalidateBattleStats();
 }
 
 Game_Actor::RowType Game_Actor::GetBattleRow() const {
@@ -1302,6 +1310,7 @@ void Game_Actor::RemoveInvalidData() {
 	if (GetStates().size() > lcf::Data::states.size()) {
 		Output::Warning("Actor {}: State array contains invalid states ({} > {})", GetId(), GetStates().size(), lcf::Data::states.size());
 		GetStates().resize(lcf::Data::states.size());
+		InvalidateBattleStats();
 	}
 
 	// Remove invalid levels
@@ -44,6 +44,9 @@
 #include "algo.h"
 #include "rand.h"
 
+// Verifies the cached battle stats against a recalculation on every access
+//#define EP_DEBUG_BATTLER_STATS
+
 Game_Battler::Game_Battler() {
 }
 
@@ -328,6 +331,10 @@ int Game_Battler::CalculateSkillHpCost(int skill_id) const {
 bool Game_Battler::AddState(int state_id, bool allow_battle_states) {
 	auto was_added = State::Add(state_id, GetStates(), GetPermanentStates(), allow_battle_states);
 
+	// Add can change the states even when it fails: Lower priority and immune
+	// states are removed before the new state removes itself
+	InvalidateBattleStats();
+
 	if (!was_added) {
 		return was_added;
 	}
@@ -389,6 +396,8 @@ bool RemoveStates(Game_Battler& battler, F&& f) {
 	bool is_dead = check_dead();
 	bool was_removed = f();
 	if (was_removed) {
+		battler.InvalidateBattleStats();
+
 		if (is_dead != check_dead()) {
 			// Was revived
 			battler.SetHp(1);
@@ -560,21 +569,67 @@ int Game_Battler::CalcValueAfterAgiStates(int value) const {
 }
 
 int Game_Battler::GetAtk(Weapon weapon) const {
+	if (weapon == WeaponAll) {
+		return GetBattleStats().atk;
+	}
 	return AdjustParam(GetBaseAtk(weapon), atk_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_attack);
 }
 
 int Game_Battler::GetDef(Weapon weapon) const {
+	if (weapon == WeaponAll) {
+		return GetBattleStats().def;
+	}
 	return AdjustParam(GetBaseDef(weapon), def_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_defense);
 }
 
 int Game_Battler::GetSpi(Weapon weapon) const {
+	if (weapon == WeaponAll) {
+		return GetBattleStats().spi;
+	}
 	return AdjustParam(GetBaseSpi(weapon), spi_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_spirit);
 }
 
 int Game_Battler::GetAgi(Weapon weapon) const {
+	if (weapon == WeaponAll) {
+		return GetBattleStats().agi;
+	}
 	return AdjustParam(GetBaseAgi(weapon), agi_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_agility);
 }
 
+Game_Battler::BattleStats Game_Battler::CalcBattleStats() const {
+	const auto states = GetInflictedStates();
+	const auto maxval = MaxStatBattleValue();
+
+	BattleStats stats;
+	stats.atk = AdjustParam(GetBaseAtk(), atk_modifier, maxval, states, &lcf::rpg::State::affect_attack);
+	stats.def = AdjustParam(GetBaseDef(), def_modifier, maxval, states, &lcf::rpg::State::affect_defense);
+	stats.spi = AdjustParam(GetBaseSpi(), spi_modifier, maxval, states, &lcf::rpg::State::affect_spirit);
+	stats.agi = AdjustParam(GetBaseAgi(), agi_modifier, maxval, states, &lcf::rpg::State::affect_agility);
+	stats.valid = true;
+	return stats;
+}
+
+const Game_Battler::BattleStats& Game_Battler::GetBattleStats() const {
+	if (!battle_stats.valid) {
+		battle_stats = CalcBattleStats();
+		return battle_stats;
+	}
+
+#ifdef EP_DEBUG_BATTLER_STATS
+	const auto stats = CalcBattleStats();
+	if (stats.atk != battle_stats.atk || stats.def != battle_stats.def
+			|| stats.spi != battle_stats.spi || stats.agi != battle_stats.agi) {
+		Output::Warning("Battler {}: Outdated stats {}/{}/{}/{}, expected {}/{}/{}/{}",
+			GetName(), battle_stats.atk, battle_stats.def, battle_stats.spi, battle_stats.agi,
+			stats.atk, stats.def, stats.spi, stats.agi);
+		assert(false && "Battle stats not invalidated!");
+		battle_stats = stats;
+	}
+#endif
+
+	return battle_stats;
+}
+
 int Game_Battler::GetDisplayX() const {
 	int shake_x = 0;
 	if (Main_Data::game_screen) {
@@ -657,6 +712,7 @@ void Game_Battler::ResetBattle() {
 	def_modifier = 0;
 	spi_modifier = 0;
 	agi_modifier = 0;
+	InvalidateBattleStats();
 	frame_counter = Rand::GetRandomNumber(0, 63);
 	battle_combo_command_id = -1;
 	battle_combo_times = 1;
@@ -382,6 +382,13 @@ public:
 	 */
 	int GetAgi(Weapon weapon = Game_Battler::WeaponAll) const;
 
+	/**
+	 * Marks the cached attack, defense, spirit and agility as outdated.
+	 * Must be called whenever a value they are derived from changes
+	 * (level, class, equipment, base stats, states or modifiers).
+	 */
+	void InvalidateBattleStats();
+
 	/**
 	 * Gets the maximum HP for the current level.
 	 *
@@ -940,6 +947,23 @@ public:
 	const std::vector<lcf::rpg::State*> GetInflictedStatesOrderedByPriority() const;
 
 protected:
+	/** Stats for all weapons, calculated on first access after an invalidation */
+	struct BattleStats {
+		int atk = 0;
+		int def = 0;
+		int spi = 0;
+		int agi = 0;
+		bool valid = false;
+	};
+
+	/** @return cached stats, recalculated when outdated */
+	const BattleStats& GetBattleStats() const;
+
+	/** @return freshly calculated stats */
+	BattleStats CalcBattleStats() const;
+
+	mutable BattleStats battle_stats;
+
 	/** Gauge for RPG2k3 Battle */
 	int gauge = 0;
 
@@ -1003,18 +1027,26 @@ inline bool Game_Battler::Exists() const {
 
 inline void Game_Battler::SetAtkModifier(int modifier) {
 	atk_modifier = modifier;
+	InvalidateBattleStats();
 }
 
 inline void Game_Battler::SetDefModifier(int modifier) {
 	def_modifier = modifier;
+	InvalidateBattleStats();
 }
 
 inline void Game_Battler::SetSpiModifier(int modifier) {
 	spi_modifier = modifier;
+	InvalidateBattleStats();
 }
 
 inline void Game_Battler::SetAgiModifier(int modifier) {
 	agi_modifier = modifier;
+	InvalidateBattleStats();
+}
+
+inline void Game_Battler::InvalidateBattleStats() {
+	battle_stats.valid = false;
 }
 
 inline bool Game_Battler::IsCharged() const {
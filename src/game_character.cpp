@@ -18,6 +18,7 @@
 // Headers
 #include "audio.h"
 #include "game_character.h"
+#include "game_event.h"
 #include "game_map.h"
 #include "game_player.h"
 #include "game_switches.h"
@@ -31,10 +32,10 @@
 #include "util_macro.h"
 #include "output.h"
 #include "rand.h"
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 #include <limits>
-#include <unordered_set>
 
 Game_Character::Game_Character(Type type, lcf::rpg::SaveMapEventBase* d) :
 	_type(type), _data(d)
@@ -791,52 +792,74 @@ void Game_Character::CancelMoveRoute() {
 	SetMoveRouteFinished(false);
 }
 
-struct SearchNode {
-	int x = 0;
-	int y = 0;
-	int cost = 0;
-	int direction = 0;
-
-	int id = 0;
-	int parent_id = -1;
-	int parent_x = -1;
-	int parent_y = -1;
-
-	friend bool operator==(const SearchNode& n1, const SearchNode& n2)
-	{
-		return n1.x == n2.x && n1.y == n2.y;
-	}
-
-	bool operator()(SearchNode const& a, SearchNode const& b)
-	{
-		return a.id > b.id;
-	}
-};
-
-struct SearchNodeHash {
-	size_t operator()(const SearchNode &p) const {
-		return (p.x ^ (p.y + (p.y >> 12)));
-	}
-};
+namespace {
+	/** Per tile state of a route search */
+	struct SearchTile {
+		/** Search generation that discovered this tile */
+		uint32_t generation = 0;
+		/** Tile index this tile was discovered from, -1 for the start tile */
+		int parent = -1;
+		/** Discovery id, only used for debug output */
+		int id = 0;
+		/** Direction of the step from the parent to this tile */
+		int direction = -1;
+	};
+
+	/**
+	 * Buffers of the route search. They are sized to the current map and reused
+	 * between searches. A tile is only considered discovered when its generation
+	 * matches the current search, so no clearing is needed between calls.
+	 */
+	struct SearchBuffers {
+		std::vector<SearchTile> tiles;
+		std::vector<int> queue;
+		std::vector<int> path;
+		uint32_t generation = 0;
+
+		void Prepare(int num_tiles) {
+			if (static_cast<int>(tiles.size()) != num_tiles) {
+				tiles.assign(num_tiles, {});
+				generation = 0;
+			}
+			if (++generation == 0) {
+				std::fill(tiles.begin(), tiles.end(), SearchTile());
+				generation = 1;
+			}
+			queue.clear();
+			path.clear();
+		}
+	};
+
+	SearchBuffers search_buffers;
+
+	struct SearchStep {
+		int dx;
+		int dy;
+		int direction;
+	};
+
+	// The order determines which route is picked when several have the same length
+	constexpr SearchStep search_steps[] = {
+		{ 1, 0, Game_Character::Right },
+		{ 0, -1, Game_Character::Up },
+		{ -1, 0, Game_Character::Left },
+		{ 0, 1, Game_Character::Down },
+		{ -1, 1, Game_Character::DownLeft },
+		{ 1, -1, Game_Character::UpRight },
+		{ -1, -1, Game_Character::UpLeft },
+		{ 1, 1, Game_Character::DownRight }
+	};
+}
 
 bool Game_Character::CalculateMoveRoute(const CalculateMoveRouteArgs& args) {
 	CancelMoveRoute();
 
 	// Set up helper variables:
-	SearchNode start = {GetX(), GetY(), 0, -1};
-	if ((start.x == args.dest_x && start.y == args.dest_y) || args.steps_max == 0) {
+	const int start_x = GetX();
+	const int start_y = GetY();
+	if ((start_x == args.dest_x && start_y == args.dest_y) || args.steps_max == 0) {
 		return true;
 	}
-	std::vector<SearchNode> queue;
-	std::unordered_map<int, SearchNode> graph;
-	std::map<std::pair<int, int>, SearchNode> graph_by_coord;
-	queue.push_back(start);
-	int id = 0;
-	int idd = 0;
-	int steps_taken = 0;
-	SearchNode closest_node = {args.dest_x, args.dest_y, std::numeric_limits<int>::max(), -1}; // Initialize with a very high cost.
-	int closest_distance = std::numeric_limits<int>::max(); // Initialize with a very high distance.
-	std::unordered_set<SearchNode, SearchNodeHash> seen;
 
 	int steps_max = args.steps_max;
 	if (steps_max == -1) {
@@ -847,248 +870,190 @@ bool Game_Character::CalculateMoveRoute(const CalculateMoveRouteArgs& args) {
 		Output::Debug("Game_Interpreter::CommandSearchPath: "
 			"start search, character x{} y{}, to x{}, y{}, "
 			"ignored event ids count: {}",
-			start.x, start.y, args.dest_x, args.dest_y, args.event_id_ignore_list.size());
+			start_x, start_y, args.dest_x, args.dest_y, args.event_id_ignore_list.size());
 	}
 
-	bool loops_horizontal = Game_Map::LoopHorizontal();
-	bool loops_vertical = Game_Map::LoopVertical();
-	std::vector<SearchNode> neighbour;
-	neighbour.reserve(8);
-	while (!queue.empty() && steps_taken < args.search_max) {
-		SearchNode n = queue[0];
-		queue.erase(queue.begin());
+	if (!Game_Map::IsValid(start_x, start_y)) {
+		return false;
+	}
+
+	const int width = Game_Map::GetTilesX();
+	const int height = Game_Map::GetTilesY();
+	const bool loops_horizontal = Game_Map::LoopHorizontal();
+	const bool loops_vertical = Game_Map::LoopVertical();
+
+	auto& buffers = search_buffers;
+	buffers.Prepare(width * height);
+	auto& tiles = buffers.tiles;
+	auto& queue = buffers.queue;
+	const auto generation = buffers.generation;
+
+	// Breadth-first search. The start tile counts as discovered so it is never entered again.
+	const int start = start_y * width + start_x;
+	tiles[start] = { generation, -1, 0, -1 };
+	queue.push_back(start);
+
+	size_t queue_head = 0;
+	int idd = 0;
+	int steps_taken = 0;
+	int closest = -1;
+	int closest_distance = std::numeric_limits<int>::max();
+	const int num_steps = args.allow_diagonal ? 8 : 4;
+
+	while (queue_head < queue.size() && steps_taken < args.search_max) {
+		const int n = queue[queue_head++];
+		const int nx = n % width;
+		const int ny = n / width;
 		steps_taken++;
-		graph[n.id] = n;
-		graph_by_coord.insert({{n.x, n.y}, n});
 
-		if (n.x == args.dest_x && n.y == args.dest_y) {
+		if (nx == args.dest_x && ny == args.dest_y) {
 			// Reached the destination.
-			closest_node = n;
+			closest = n;
 			closest_distance = 0;
 			break;	// Exit the loop to build final route.
 		}
-		else {
-			neighbour.clear();
-			SearchNode nn = {n.x + 1, n.y, n.cost + 1, 1}; // Right
-			neighbour.push_back(nn);
-			nn = {n.x, n.y - 1, n.cost + 1, 0}; // Up
-			neighbour.push_back(nn);
-			nn = {n.x - 1, n.y, n.cost + 1, 3}; // Left
-			neighbour.push_back(nn);
-			nn = {n.x, n.y + 1, n.cost + 1, 2}; // Down
-			neighbour.push_back(nn);
-
-			if (args.allow_diagonal) {
-				nn = {n.x - 1, n.y + 1, n.cost + 1, 6}; // Down Left
-				neighbour.push_back(nn);
-				nn = {n.x + 1, n.y - 1, n.cost + 1, 4}; // Up Right
-				neighbour.push_back(nn);
-				nn = {n.x - 1, n.y - 1, n.cost + 1, 7}; // Up Left
-				neighbour.push_back(nn);
-				nn = {n.x + 1, n.y + 1, n.cost + 1, 5}; // Down Right
-				neighbour.push_back(nn);
+
+		for (int i = 0; i < num_steps; ++i) {
+			const auto& step = search_steps[i];
+			idd++;
+
+			int ax = nx + step.dx;
+			int ay = ny + step.dy;
+
+			// Adjust neighbor coordinates for map looping
+			if (loops_horizontal) {
+				if (ax >= width)
+					ax -= width;
+				else if (ax < 0)
+					ax += width;
 			}
 
-			for (SearchNode a : neighbour) {
-				idd++;
-				a.parent_x = n.x;
-				a.parent_y = n.y;
-				a.id = idd;
-				a.parent_id = n.id;
-
-				// Adjust neighbor coordinates for map looping
-				if (loops_horizontal) {
-					if (a.x >= Game_Map::GetTilesX())
-						a.x -= Game_Map::GetTilesX();
-					else if (a.x < 0)
-						a.x += Game_Map::GetTilesX();
-				}
+			if (loops_vertical) {
+				if (ay >= height)
+					ay -= height;
+				else if (ay < 0)
+					ay += height;
+			}
 
-				if (loops_vertical) {
-					if (a.y >= Game_Map::GetTilesY())
-						a.y -= Game_Map::GetTilesY();
-					else if (a.y < 0)
-						a.y += Game_Map::GetTilesY();
-				}
+			if (ax < 0 || ax >= width || ay < 0 || ay >= height) {
+				// Never passable
+				continue;
+			}
 
-				auto check = seen.find(a);
-				if (check != seen.end()) {
-					SearchNode old_entry = graph[(*check).id];
-					if (a.cost < old_entry.cost) {
-						// Found a shorter path to previous node, update & reinsert:
-						if (args.debug_print) {
-							Output::Debug("Game_Interpreter::CommandSearchPath: "
-								"found shorter path to x:{} y:{}"
-								"from x:{} y:{} direction: {}",
-								a.x, a.y, n.x, n.y, a.direction);
-						}
-						graph.erase(old_entry.id);
-						old_entry.cost = a.cost;
-						old_entry.parent_id = n.id;
-						old_entry.parent_x = n.x;
-						old_entry.parent_y = n.y;
-						old_entry.direction = a.direction;
-						graph[old_entry.id] = old_entry;
-					}
-					continue;
-				} else if (a.x == start.x && a.y == start.y) {
-					continue;
-				}
-				bool added = false;
-				if (CheckWay(n.x, n.y, a.x, a.y, true, args.event_id_ignore_list) ||
-						(a.x == args.dest_x && a.y == args.dest_y &&
-						CheckWay(n.x, n.y, a.x, a.y, false, {}))) {
-					if (a.direction == 4) {
-						if (CheckWay(n.x, n.y, n.x + 1, n.y,
-									true, args.event_id_ignore_list) ||
-								CheckWay(n.x, n.y, n.x, n.y - 1,
-									true, args.event_id_ignore_list)) {
-							added = true;
-							queue.push_back(a);
-							seen.insert(a);
-						}
-					}
-					else if (a.direction == 5) {
-						if (CheckWay(n.x, n.y, n.x + 1, n.y,
-									true, args.event_id_ignore_list) ||
-								CheckWay(n.x, n.y, n.x, n.y + 1,
-									true, args.event_id_ignore_list)) {
-							added = true;
-							queue.push_back(a);
-							seen.insert(a);
-						}
-					}
-					else if (a.direction == 6) {
-						if (CheckWay(n.x, n.y, n.x - 1, n.y,
-									true, args.event_id_ignore_list) ||
-								CheckWay(n.x, n.y, n.x, n.y + 1,
-									true, args.event_id_ignore_list)) {
-							added = true;
-							queue.push_back(a);
-							seen.insert(a);
-						}
-					}
-					else if (a.direction == 7) {
-						if (CheckWay(n.x, n.y, n.x - 1, n.y,
-									true, args.event_id_ignore_list) ||
-								CheckWay(n.x, n.y, n.x, n.y - 1,
-									true, args.event_id_ignore_list)) {
-							added = true;
-							queue.push_back(a);
-							seen.insert(a);
-						}
-					}
-					else {
-						added = true;
-						queue.push_back(a);
-						seen.insert(a);
-					}
-				}
-				if (added && args.debug_print) {
-					Output::Debug("Game_Interpreter::CommandSearchPath: "
-						"discovered id:{} x:{} y:{} parentX:{} parentY:{}"
-						"parentID:{} direction: {}",
-					queue[queue.size() - 1].id,
-					queue[queue.size() - 1].x, queue[queue.size() - 1].y,
-					queue[queue.size() - 1].parent_x,
-					queue[queue.size() - 1].parent_y,
-					queue[queue.size() - 1].parent_id,
-					queue[queue.size() - 1].direction);
-				}
+			const int a = ay * width + ax;
+			if (tiles[a].generation == generation) {
+				// Already discovered. The tiles are visited in order of distance, so
+				// the previous route to this tile cannot be longer.
+				continue;
+			}
+
+			bool passable = CheckWay(nx, ny, ax, ay, true, args.event_id_ignore_list) ||
+				(ax == args.dest_x && ay == args.dest_y && CheckWay(nx, ny, ax, ay, false, {}));
+
+			if (passable && step.dx != 0 && step.dy != 0) {
+				// Diagonal steps require that one of the adjacent straight steps is possible
+				passable = CheckWay(nx, ny, nx + step.dx, ny, true, args.event_id_ignore_list) ||
+					CheckWay(nx, ny, nx, ny + step.dy, true, args.event_id_ignore_list);
+			}
+
+			if (!passable) {
+				continue;
+			}
+
+			tiles[a] = { generation, n, idd, step.direction };
+			queue.push_back(a);
+
+			if (args.debug_print) {
+				Output::Debug("Game_Interpreter::CommandSearchPath: "
+					"discovered id:{} x:{} y:{} parentX:{} parentY:{}"
+					"parentID:{} direction: {}",
+					idd, ax, ay, nx, ny, tiles[n].id, step.direction);
 			}
 		}
-		id++;
+
 		// Calculate the Manhattan distance between the current node and the destination
-		int manhattan_dist = abs(args.dest_x - n.x) + abs(args.dest_y - n.y);
+		int manhattan_dist = abs(args.dest_x - nx) + abs(args.dest_y - ny);
 
 		// Check if this node is closer to the destination
 		if (manhattan_dist < closest_distance) {
-			closest_node = n;
+			closest = n;
 			closest_distance = manhattan_dist;
 			if (args.debug_print) {
 				Output::Debug("Game_Interpreter::CommandSearchPath: "
 						"new closest node at x:{} y:{} id:{}",
-					closest_node.x, closest_node.y,
-					closest_node.id);
+					nx, ny, tiles[n].id);
 			}
 		}
 	}
 
-	// Check if a path to the closest node was found.
-	if (closest_distance != std::numeric_limits<int>::max()) {
-		// Build a route to the closest reachable node.
-		if (args.debug_print) {
-			Output::Debug("Game_Interpreter::CommandSearchPath: "
-					"trying to return route from x:{} y:{} to "
-					"x:{} y:{} (id:{})",
-				start.x, start.y, closest_node.x, closest_node.y,
-				closest_node.id);
-		}
-		std::vector<SearchNode> list_move;
-
-		SearchNode node = closest_node;
-		while (static_cast<int>(list_move.size()) < steps_max) {
-			list_move.push_back(node);
-			if (graph_by_coord.find({node.parent_x,
-					node.parent_y}) == graph_by_coord.end())
-				break;
-			SearchNode node2 = graph_by_coord[
-				{node.parent_x, node.parent_y}
-			];
-			if (args.debug_print) {
-				Output::Debug(
-					"Game_Interpreter::CommandSearchPath: "
-					"found parent leading to x:{} y:{}, "
-					"it's at x:{} y:{} dir:{}",
-					node.x, node.y,
-					node2.x, node2.y, node2.direction);
-			}
-			node = node2;
-		}
-
-		std::reverse(list_move.rbegin(), list_move.rend());
-
-		std::string debug_output_path("");
-		if (list_move.size() > 0) {
-			lcf::rpg::MoveRoute route;
-			route.skippable = args.skip_when_failed;
-			route.repeat = false;
-
-			for (SearchNode node2 : list_move) {
-				if (node2.direction >= 0) {
-					lcf::rpg::MoveCommand cmd;
-					cmd.command_id = node2.direction;
-					route.move_commands.push_back(cmd);
-					if (args.debug_print >= 1) {
-						if (debug_output_path.length() > 0)
-							debug_output_path += ",";
-						std::ostringstream dirnum;
-						dirnum << node2.direction;
-						debug_output_path += std::string(dirnum.str());
-					}
-				}
-			}
+	// No path to the destination, return failure.
+	if (closest < 0) {
+		return false;
+	}
 
-			lcf::rpg::MoveCommand cmd;
-			cmd.command_id = 23;
-			route.move_commands.push_back(cmd);
+	// Build a route to the closest reachable node.
+	if (args.debug_print) {
+		Output::Debug("Game_Interpreter::CommandSearchPath: "
+				"trying to return route from x:{} y:{} to "
+				"x:{} y:{} (id:{})",
+			start_x, start_y, closest % width, closest / width,
+			tiles[closest].id);
+	}
 
-			ForceMoveRoute(route, args.frequency);
+	auto& path = buffers.path;
+	int node = closest;
+	while (static_cast<int>(path.size()) < steps_max) {
+		path.push_back(node);
+		const int parent = tiles[node].parent;
+		if (parent < 0) {
+			break;
 		}
 		if (args.debug_print) {
 			Output::Debug(
 				"Game_Interpreter::CommandSearchPath: "
-				"setting route {} for character x{} y{}",
-				" (ignored event ids count: {})",
-				debug_output_path, start.x, start.y,
-				args.event_id_ignore_list.size()
-			);
+				"found parent leading to x:{} y:{}, "
+				"it's at x:{} y:{} dir:{}",
+				node % width, node / width,
+				parent % width, parent / width, tiles[parent].direction);
 		}
-		return true;
+		node = parent;
 	}
 
-	// No path to the destination, return failure.
-	return false;
+	lcf::rpg::MoveRoute route;
+	route.skippable = args.skip_when_failed;
+	route.repeat = false;
+
+	std::string debug_output_path;
+	for (auto it = path.rbegin(); it != path.rend(); ++it) {
+		const int direction = tiles[*it].direction;
+		if (direction >= 0) {
+			lcf::rpg::MoveCommand cmd;
+			cmd.command_id = direction;
+			route.move_commands.push_back(cmd);
+			if (args.debug_print) {
+				if (!debug_output_path.empty())
+					debug_output_path += ",";
+				debug_output_path += std::to_string(direction);
+			}
+		}
+	}
+
+	lcf::rpg::MoveCommand cmd;
+	cmd.command_id = 23;
+	route.move_commands.push_back(cmd);
+
+	ForceMoveRoute(route, args.frequency);
+
+	if (args.debug_print) {
+		Output::Debug(
+			"Game_Interpreter::CommandSearchPath: "
+			"setting route {} for character x{} y{}"
+			" (ignored event ids count: {})",
+			debug_output_path, start_x, start_y,
+			args.event_id_ignore_list.size()
+		);
+	}
+	return true;
 }
 
 int Game_Character::GetSpriteX() const {
@@ -1123,6 +1088,10 @@ int Game_Character::GetSpriteY() const {
 	return y;
 }
 
+void Game_Character::OnEventPositionChanged() {
+	Game_Map::OnEventPositionChanged(static_cast<const Game_Event&>(*this));
+}
+
 bool Game_Character::IsInPosition(int x, int y) const {
 	return ((GetX() == x) && (GetY() == y));
 }
@@ -943,6 +943,8 @@ protected:
 	void IncAnimFrame();
 	void UpdateFlash();
 	bool BeginMoveRouteJump(int32_t& current_index, const lcf::rpg::MoveRoute& current_route);
+	/** Keeps the event spatial index of Game_Map in sync when an event changes its tile. */
+	void OnEventPositionChanged();
 
 	lcf::rpg::SaveMapEventBase* data();
 	const lcf::rpg::SaveMapEventBase* data() const;
@@ -999,7 +1001,11 @@ inline int Game_Character::GetX() const {
 }
 
 inline void Game_Character::SetX(int new_x) {
+	const int old_x = data()->position_x;
 	data()->position_x = new_x;
+	if (_type == Event && new_x != old_x) {
+		OnEventPositionChanged();
+	}
 }
 
 inline int Game_Character::GetY() const {
@@ -1007,7 +1013,11 @@ inline int Game_Character::GetY() const {
 }
 
 inline void Game_Character::SetY(int new_y) {
+	const int old_y = data()->position_y;
 	data()->position_y = new_y;
+	if (_type == Event && new_y != old_y) {
+		OnEventPositionChanged();
+	}
 }
 
 inline int Game_Character::GetMapId() const {
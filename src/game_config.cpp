@@ -683,6 +683,13 @@ void Game_Config::LoadFromStream(Filesystem_Stream::InputStream& is) {
 	player.screenshot_timestamp.FromIni(ini);
 	player.automatic_screenshots.FromIni(ini);
 	player.automatic_screenshots_interval.FromIni(ini);
+	player.cache_budget_charset.FromIni(ini);
+	player.cache_budget_chipset.FromIni(ini);
+	player.cache_budget_tile.FromIni(ini);
+	player.cache_budget_panorama.FromIni(ini);
+	player.cache_budget_picture.FromIni(ini);
+	player.cache_budget_sprite_effect.FromIni(ini);
+	player.cache_budget_other.FromIni(ini);
 }
 
 void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
@@ -776,6 +783,13 @@ void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
 	player.screenshot_timestamp.ToIni(os);
 	player.automatic_screenshots.ToIni(os);
 	player.automatic_screenshots_interval.ToIni(os);
+	player.cache_budget_charset.ToIni(os);
+	player.cache_budget_chipset.ToIni(os);
+	player.cache_budget_tile.ToIni(os);
+	player.cache_budget_panorama.ToIni(os);
+	player.cache_budget_picture.ToIni(os);
+	player.cache_budget_sprite_effect.ToIni(os);
+	player.cache_budget_other.ToIni(os);
 
 	os << "\n";
 }
@@ -108,6 +108,13 @@ struct Game_ConfigPlayer {
 	BoolConfigParam screenshot_timestamp{ "Screenshot timestamp", "Add the current date and time to the file name", "Player", "ScreenshotTimestamp", true };
 	BoolConfigParam automatic_screenshots{ "Automatic screenshots", "Periodically take screenshots", "Player", "AutomaticScreenshots", false };
 	RangeConfigParam<int> automatic_screenshots_interval{ "Screenshot interval", "The interval between automatic screenshots (seconds)", "Player", "AutomaticScreenshotsInterval", 30, 1, 999999 };
+	RangeConfigParam<int> cache_budget_charset{ "Charset cache", "Memory budget of cached charsets in KiB (0: Default)", "Player", "CacheBudgetCharset", 0, 0, 1048576 };
+	RangeConfigParam<int> cache_budget_chipset{ "Chipset cache", "Memory budget of cached chipsets in KiB (0: Default)", "Player", "CacheBudgetChipset", 0, 0, 1048576 };
+	RangeConfigParam<int> cache_budget_tile{ "Tile cache", "Memory budget of cached chipset tiles in KiB (0: Default)", "Player", "CacheBudgetTile", 0, 0, 1048576 };
+	RangeConfigParam<int> cache_budget_panorama{ "Panorama cache", "Memory budget of cached panoramas in KiB (0: Default)", "Player", "CacheBudgetPanorama", 0, 0, 1048576 };
+	RangeConfigParam<int> cache_budget_picture{ "Picture cache", "Memory budget of cached pictures in KiB (0: Default)", "Player", "CacheBudgetPicture", 0, 0, 1048576 };
+	RangeConfigParam<int> cache_budget_sprite_effect{ "Sprite effect cache", "Memory budget of cached sprite effects in KiB (0: Default)", "Player", "CacheBudgetSpriteEffect", 0, 0, 1048576 };
+	RangeConfigParam<int> cache_budget_other{ "Image cache", "Memory budget of all other cached images in KiB (0: Default)", "Player", "CacheBudgetOther", 0, 0, 1048576 };
 
 	void Hide();
 };
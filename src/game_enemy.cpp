@@ -136,6 +136,8 @@ void Game_Enemy::Transform(int new_enemy_id) {
 		enemy = &dummy;
 	}
 
+	InvalidateBattleStats();
+
 	auto* sprite = GetEnemyBattleSprite();
 	if (sprite) {
 		sprite->Refresh();
@@ -51,6 +51,7 @@
 #include "sprite_character.h"
 #include "scene_gameover.h"
 #include "scene_map.h"
+#include "save_title_reader.h"
 #include "scene_save.h"
 #include "scene_settings.h"
 #include "scene.h"
@@ -69,6 +70,7 @@
 #include "transition.h"
 #include "baseui.h"
 #include "algo.h"
+#include "instrumentation.h"
 
 using namespace Game_Interpreter_Shared;
 
@@ -90,6 +92,7 @@ void Game_Interpreter::Clear() {
 	_state = {};
 	_keyinput = {};
 	_async_op = {};
+	_jump_tables.clear();
 }
 
 // Is interpreter running.
@@ -140,6 +143,8 @@ void Game_Interpreter::PushInternal(
 		Main_Data::game_player->SetEncounterCalling(false);
 	}
 
+	// Tables of popped frames must not be reused for the new frame
+	_jump_tables.resize(std::min(_jump_tables.size(), _state.stack.size()));
 	_state.stack.push_back(std::move(frame));
 }
 
@@ -371,6 +376,8 @@ int Game_Interpreter::GetSubcommandIndex(int indent) const {
 
 // Update
 void Game_Interpreter::Update(bool reset_loop_count) {
+	Instrumentation::Scope iscope("Interpreter");
+
 	if (reset_loop_count) {
 		loop_count = 0;
 	}
@@ -486,9 +493,7 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 			break;
 		}
 
-		if (Game_Map::GetNeedRefresh()) {
-			Game_Map::Refresh();
-		}
+		Game_Map::RefreshChanged();
 
 		// Previous operations could have modified the stack.
 		// So we need to fetch the frame again.
@@ -541,9 +546,7 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 		Output::Debug("Event {} exceeded execution limit", event_id);
 	}
 
-	if (Game_Map::GetNeedRefresh()) {
-		Game_Map::Refresh();
-	}
+	Game_Map::RefreshChanged();
 }
 
 // Setup Starting Event
@@ -585,15 +588,24 @@ void Game_Interpreter::SkipToNextConditional(std::initializer_list<Cmd> codes, i
 		return;
 	}
 
-	for (++index; index < static_cast<int>(list.size()); ++index) {
-		const auto& com = list[index];
-		if (com.indent > indent) {
-			continue;
-		}
-		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
-			break;
-		}
+	index = GetJumpTable().FindNextConditional(index, codes, indent);
+}
+
+const Game_Interpreter_JumpTable& Game_Interpreter::GetJumpTable() {
+	const auto& frame = GetFrame();
+	const size_t frame_idx = _state.stack.size() - 1;
+
+	if (_jump_tables.size() <= frame_idx) {
+		_jump_tables.resize(frame_idx + 1);
+	}
+
+	// Built on the first jump, parallel events keep their base frame and
+	// reuse the table every time they run.
+	auto& table = _jump_tables[frame_idx];
+	if (table.GetSize() != static_cast<int>(frame.commands.size())) {
+		table = Game_Interpreter_JumpTable(frame.commands);
 	}
+	return table;
 }
 
 // Execute Command.
@@ -1084,7 +1096,7 @@ bool Game_Interpreter::CommandControlSwitches(lcf::rpg::EventCommand const& com)
 			} else {
 				Main_Data::game_switches->FlipRange(start, end);
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForSwitchRange(start, end);
 		}
 	}
 	return true;
@@ -1366,7 +1378,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRangeVariable(start, end, var_id);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRange(start, end);
 		} else if (com.parameters[4] == 2) {
 			// Multiple variables - Indirect variable lookup
 			int var_id = com.parameters[5];
@@ -1405,7 +1417,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRangeVariableIndirect(start, end, var_id);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRange(start, end);
 		} else if (com.parameters[4] == 3) {
 			// Multiple variables - random
 			int rmax = max(com.parameters[5], com.parameters[6]);
@@ -1445,7 +1457,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRangeRandom(start, end, rmin, rmax);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRange(start, end);
 		} else {
 			// Multiple variables - constant
 			switch (operation) {
@@ -1483,7 +1495,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRange(start, end, value);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRange(start, end);
 		}
 	}
 
@@ -1620,17 +1632,16 @@ bool Game_Interpreter::CommandChangeItems(lcf::rpg::EventCommand const& com) { /
 		}
 	}
 
+	int item_id;
 	if (com.parameters[1] == 0) {
 		// Item by const number
-		Main_Data::game_party->AddItem(com.parameters[2], value);
+		item_id = com.parameters[2];
 	} else {
 		// Item by variable
-		Main_Data::game_party->AddItem(
-			Main_Data::game_variables->Get(com.parameters[2]),
-			value
-		);
+		item_id = Main_Data::game_variables->Get(com.parameters[2]);
 	}
-	Game_Map::SetNeedRefresh(true);
+	Main_Data::game_party->AddItem(item_id, value);
+	Game_Map::SetNeedRefreshForItemChange(item_id);
 	// Continue
 	return true;
 }
@@ -1656,7 +1667,13 @@ bool Game_Interpreter::CommandChangePartyMember(lcf::rpg::EventCommand const& co
 	}
 
 	CheckGameOver();
-	Game_Map::SetNeedRefresh(true);
+	Game_Map::SetNeedRefreshForActorChange(id);
+	// The equipment of party members counts towards the items of the party
+	for (auto item_id: actor->GetWholeEquipment()) {
+		if (item_id > 0) {
+			Game_Map::SetNeedRefreshForItemChange(item_id);
+		}
+	}
 
 	// Continue
 	return true;
@@ -3765,18 +3782,13 @@ bool Game_Interpreter::CommandEndBranch(lcf::rpg::EventCommand const& /* com */)
 
 bool Game_Interpreter::CommandJumpToLabel(lcf::rpg::EventCommand const& com) { // code 12120
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
 	auto& index = frame.current_command;
 
 	int label_id = com.parameters[0];
 
-	for (int idx = 0; (size_t)idx < list.size(); idx++) {
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Label)
-			continue;
-		if (list[idx].parameters.empty() || list[idx].parameters[0] != label_id)
-			continue;
+	int idx = GetJumpTable().FindLabel(label_id);
+	if (idx >= 0) {
 		index = idx;
-		break;
 	}
 
 	return true;
@@ -3860,20 +3872,14 @@ bool Game_Interpreter::CommandBreakLoop(lcf::rpg::EventCommand const& /* com */)
 
 	// This emulates an RPG_RT bug where break loop ignores scopes and
 	// unconditionally jumps to the next EndLoop command.
-	auto pcode = static_cast<Cmd>(list[index].code);
-	for (++index; index < (int)list.size(); ++index) {
-		if (pcode == Cmd::EndLoop) {
-			break;
-		}
-		pcode = static_cast<Cmd>(list[index].code);
-	}
+	int end_idx = GetJumpTable().FindNextEndLoop(index + 1);
+	index = std::min(end_idx + 1, static_cast<int>(list.size()));
 
 	return true;
 }
 
 bool Game_Interpreter::CommandEndLoop(lcf::rpg::EventCommand const& com) { // code 22210
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
 	auto& index = frame.current_command;
 
 	int indent = com.indent;
@@ -3930,16 +3936,11 @@ bool Game_Interpreter::CommandEndLoop(lcf::rpg::EventCommand const& com) { // co
 	}
 
 	// Restart the loop
-	for (int idx = index; idx >= 0; idx--) {
-		if (list[idx].indent > indent)
-			continue;
-		if (list[idx].indent < indent)
-			return false;
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Loop)
-			continue;
-		index = idx;
-		break;
+	int loop_idx = GetJumpTable().FindLoopStart(index, indent);
+	if (loop_idx < 0) {
+		return false;
 	}
+	index = loop_idx;
 
 	// Jump past the Cmd::Loop to the first command.
 	if (index < (int)frame.commands.size()) {
@@ -4391,25 +4392,25 @@ bool Game_Interpreter::CommandManiacGetSaveInfo(lcf::rpg::EventCommand const& co
 		return true;
 	}
 
-	auto save = lcf::LSD_Reader::Load(save_stream, Player::encoding);
-	if (!save) {
+	auto title = SaveTitleReader::Load(save_stream, Player::encoding);
+	if (!title) {
 		Output::Debug("ManiacGetSaveInfo: Save corrupted {}", save_number);
 		// Maniac Patch writes this for whatever reason
 		Main_Data::game_variables->Set(com.parameters[2], 8991230);
 		return true;
 	}
 
-	std::time_t t = lcf::LSD_Reader::ToUnixTimestamp(save->title.timestamp);
+	std::time_t t = lcf::LSD_Reader::ToUnixTimestamp(title->timestamp);
 	std::tm* tm = std::gmtime(&t);
 
 	Main_Data::game_variables->Set(com.parameters[2], atoi(Utils::FormatDate(tm, Utils::DateFormat_YYMMDD).c_str()));
 	Main_Data::game_variables->Set(com.parameters[3], atoi(Utils::FormatDate(tm, Utils::DateFormat_HHMMSS).c_str()));
-	Main_Data::game_variables->Set(com.parameters[4], save->title.hero_level);
-	Main_Data::game_variables->Set(com.parameters[5], save->title.hero_hp);
+	Main_Data::game_variables->Set(com.parameters[4], title->hero_level);
+	Main_Data::game_variables->Set(com.parameters[5], title->hero_hp);
 	Game_Map::SetNeedRefresh(true);
 
-	auto face_ids = Utils::MakeArray(save->title.face1_id, save->title.face2_id, save->title.face3_id, save->title.face4_id);
-	auto face_names = Utils::MakeArray(save->title.face1_name, save->title.face2_name, save->title.face3_name, save->title.face4_name);
+	auto face_ids = Utils::MakeArray(title->face1_id, title->face2_id, title->face3_id, title->face4_id);
+	auto face_names = Utils::MakeArray(title->face1_name, title->face2_name, title->face3_name, title->face4_name);
 
 	for (int i = 0; i <= 3; ++i) {
 		const int param = 8 + i;
@@ -25,6 +25,7 @@
 #include "async_handler.h"
 #include "game_character.h"
 #include "game_actor.h"
+#include "game_interpreter_jump_table.h"
 #include "game_interpreter_shared.h"
 #include <lcf/dbarray.h>
 #include <lcf/rpg/fwd.h>
@@ -174,6 +175,13 @@ protected:
 	 */
 	void SkipToNextConditional(std::initializer_list<Cmd> codes, int indent);
 
+	/**
+	 * Gets the jump table of the current frame and builds it on first use.
+	 *
+	 * @return jump table of the current frame
+	 */
+	const Game_Interpreter_JumpTable& GetJumpTable();
+
 	/**
 	 * Sets up a wait (and closes the message box)
 	 */
@@ -359,6 +367,8 @@ protected:
 	lcf::rpg::SaveEventExecState _state;
 	KeyInputState _keyinput;
 	AsyncOp _async_op = {};
+	/** Jump tables of the stack frames, index matches _state.stack */
+	std::vector<Game_Interpreter_JumpTable> _jump_tables;
 
 	private:
 		void PushInternal(
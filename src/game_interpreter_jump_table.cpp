@@ -0,0 +1,134 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "game_interpreter_jump_table.h"
+#include <algorithm>
+
+Game_Interpreter_JumpTable::Game_Interpreter_JumpTable(const std::vector<lcf::rpg::EventCommand>& list) {
+	const int size = static_cast<int>(list.size());
+	entries.resize(size);
+
+	// Stacks of the commands still waiting for their next command
+	std::vector<int32_t> open_next;
+	std::vector<int32_t> open_lower;
+	// Stack of the candidates for the previous command
+	std::vector<int32_t> open_prev;
+
+	for (int i = 0; i < size; ++i) {
+		const auto& com = list[i];
+		auto& entry = entries[i];
+		entry.code = com.code;
+		entry.indent = com.indent;
+		entry.next = size;
+		entry.next_lower = size;
+
+		while (!open_next.empty() && entries[open_next.back()].indent >= com.indent) {
+			entries[open_next.back()].next = i;
+			open_next.pop_back();
+		}
+		open_next.push_back(i);
+
+		while (!open_lower.empty() && entries[open_lower.back()].indent > com.indent) {
+			entries[open_lower.back()].next_lower = i;
+			open_lower.pop_back();
+		}
+		open_lower.push_back(i);
+
+		while (!open_prev.empty() && entries[open_prev.back()].indent > com.indent) {
+			open_prev.pop_back();
+		}
+		entry.prev = open_prev.empty() ? -1 : open_prev.back();
+		open_prev.push_back(i);
+
+		if (static_cast<Cmd>(com.code) == Cmd::Label && !com.parameters.empty()) {
+			labels.emplace_back(com.parameters[0], i);
+		}
+	}
+
+	int next_end_loop = size;
+	for (int i = size - 1; i >= 0; --i) {
+		if (static_cast<Cmd>(entries[i].code) == Cmd::EndLoop) {
+			next_end_loop = i;
+		}
+		entries[i].next_end_loop = next_end_loop;
+	}
+
+	// Sorting by id and index puts the first label of every id in front
+	std::sort(labels.begin(), labels.end());
+}
+
+bool Game_Interpreter_JumpTable::Contains(std::initializer_list<Cmd> codes, int32_t code) {
+	return std::find(codes.begin(), codes.end(), static_cast<Cmd>(code)) != codes.end();
+}
+
+int Game_Interpreter_JumpTable::Step(int index, int indent) const {
+	// All commands skipped by the links have a higher indent than the
+	// searched one, only commands with a lower indent (broken event code)
+	// need to be visited one by one.
+	const auto& entry = entries[index];
+	if (entry.indent > indent) {
+		return entry.next_lower;
+	}
+	if (entry.indent == indent) {
+		return entry.next;
+	}
+	return index + 1;
+}
+
+int Game_Interpreter_JumpTable::FindNextConditional(int index, std::initializer_list<Cmd> codes, int indent) const {
+	const int size = GetSize();
+	if (index >= size) {
+		return index;
+	}
+
+	for (index = Step(index, indent); index < size; index = Step(index, indent)) {
+		const auto& entry = entries[index];
+		if (entry.indent <= indent && Contains(codes, entry.code)) {
+			break;
+		}
+	}
+	return index;
+}
+
+int Game_Interpreter_JumpTable::FindLoopStart(int index, int indent) const {
+	for (int idx = index; idx >= 0; idx = entries[idx].prev) {
+		const auto& entry = entries[idx];
+		if (entry.indent < indent) {
+			return -1;
+		}
+		if (entry.indent == indent && static_cast<Cmd>(entry.code) == Cmd::Loop) {
+			return idx;
+		}
+	}
+	return index;
+}
+
+int Game_Interpreter_JumpTable::FindNextEndLoop(int index) const {
+	if (index >= GetSize()) {
+		return GetSize();
+	}
+	return entries[index].next_end_loop;
+}
+
+int Game_Interpreter_JumpTable::FindLabel(int label_id) const {
+	auto it = std::lower_bound(labels.begin(), labels.end(), std::make_pair(static_cast<int32_t>(label_id), INT32_MIN));
+	if (it == labels.end() || it->first != label_id) {
+		return -1;
+	}
+	return it->second;
+}
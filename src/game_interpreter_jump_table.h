@@ -0,0 +1,115 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GAME_INTERPRETER_JUMP_TABLE_H
+#define EP_GAME_INTERPRETER_JUMP_TABLE_H
+
+// Headers
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+#include <lcf/rpg/eventcommand.h>
+
+/**
+ * Index of the control flow targets of an event command list.
+ *
+ * Every command links to the next and previous command with the same or a
+ * lower indentation. In well formed event code these are the matching
+ * ElseBranch, EndBranch, EndLoop or next choice option, so the jumps of the
+ * interpreter become constant time instead of scanning the list.
+ * Broken event code with missing terminators is still handled like the linear
+ * scan of RPG_RT.
+ */
+class Game_Interpreter_JumpTable {
+public:
+	using Cmd = lcf::rpg::EventCommand::Code;
+
+	Game_Interpreter_JumpTable() = default;
+
+	/**
+	 * Builds the table for a command list.
+	 *
+	 * @param list event commands
+	 */
+	explicit Game_Interpreter_JumpTable(const std::vector<lcf::rpg::EventCommand>& list);
+
+	/** @return number of commands in the table */
+	int GetSize() const;
+
+	/**
+	 * Finds the next command after index with indent <= indent matching
+	 * one of the codes.
+	 *
+	 * @param index current command index
+	 * @param codes which codes to check
+	 * @param indent the indentation level to check
+	 * @return index of the command or the list size when not found
+	 */
+	int FindNextConditional(int index, std::initializer_list<Cmd> codes, int indent) const;
+
+	/**
+	 * Searches backwards from index for the Loop command with the given indent.
+	 *
+	 * @param index current command index
+	 * @param indent indentation of the loop
+	 * @return index of the Loop, -1 when a command with lower indent is hit first
+	 *   or index itself when there is no such Loop
+	 */
+	int FindLoopStart(int index, int indent) const;
+
+	/**
+	 * Finds the next EndLoop command regardless of the indentation.
+	 *
+	 * @param index index to start the search at
+	 * @return index of the EndLoop or the list size when not found
+	 */
+	int FindNextEndLoop(int index) const;
+
+	/**
+	 * @param label_id id of the label
+	 * @return index of the first Label command with this id or -1 when not found
+	 */
+	int FindLabel(int label_id) const;
+
+private:
+	struct Entry {
+		int32_t code = 0;
+		int32_t indent = 0;
+		/** Next command with indent <= this indent */
+		int32_t next = 0;
+		/** Next command with indent < this indent */
+		int32_t next_lower = 0;
+		/** Previous command with indent <= this indent */
+		int32_t prev = -1;
+		/** First EndLoop at or after this command */
+		int32_t next_end_loop = 0;
+	};
+
+	static bool Contains(std::initializer_list<Cmd> codes, int32_t code);
+	int Step(int index, int indent) const;
+
+	std::vector<Entry> entries;
+	/** Pairs of label id and index, sorted by id */
+	std::vector<std::pair<int32_t, int32_t>> labels;
+};
+
+inline int Game_Interpreter_JumpTable::GetSize() const {
+	return static_cast<int>(entries.size());
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers
+#include "game_list_cache.h"
+#include <cstdlib>
+#include "game_config.h"
+#include "output.h"
+
+namespace {
+	constexpr std::string_view cache_name = "gamelist.cache";
+	// Increase when the format or the meaning of ProjectType changes
+	constexpr std::string_view cache_header = "EasyRPG Player game list 1";
+}
+
+void GameListCache::Load() {
+	auto fs = Game_Config::GetGlobalConfigFilesystem();
+	if (!fs) {
+		return;
+	}
+
+	auto is = fs.OpenFile(cache_name);
+	if (is) {
+		Read(is);
+	}
+}
+
+void GameListCache::Save() {
+	if (!dirty) {
+		return;
+	}
+
+	auto fs = Game_Config::GetGlobalConfigFilesystem();
+	if (!fs) {
+		return;
+	}
+
+	auto os = fs.OpenOutputStream(cache_name, std::ios_base::out);
+	if (!os) {
+		Output::Debug("Could not write {}", cache_name);
+		return;
+	}
+
+	Write(os);
+	dirty = false;
+}
+
+void GameListCache::Read(std::istream& is) {
+	entries.clear();
+	dirty = false;
+
+	std::string line;
+	if (!std::getline(is, line) || line != cache_header) {
+		return;
+	}
+
+	// One entry per line: type, size, modification time and the path
+	while (std::getline(is, line)) {
+		const char* cur = line.c_str();
+		char* end = nullptr;
+
+		Entry entry;
+		long type = std::strtol(cur, &end, 10);
+		if (end == cur || *end != '\t' || type < 0 || type >= static_cast<long>(FileFinder::ProjectType::LAST)) {
+			continue;
+		}
+		entry.type = static_cast<FileFinder::ProjectType>(type);
+
+		cur = end + 1;
+		entry.size = std::strtoll(cur, &end, 10);
+		if (end == cur || *end != '\t') {
+			continue;
+		}
+
+		cur = end + 1;
+		entry.mtime = std::strtoll(cur, &end, 10);
+		if (end == cur || *end != '\t' || end[1] == '\0') {
+			continue;
+		}
+
+		entries[std::string(end + 1)] = entry;
+	}
+}
+
+void GameListCache::Write(std::ostream& os) const {
+	os << cache_header << '\n';
+	for (const auto& [path, entry]: entries) {
+		os << static_cast<int>(entry.type) << '\t' << entry.size << '\t' << entry.mtime << '\t' << path << '\n';
+	}
+}
+
+const GameListCache::Entry* GameListCache::Find(const std::string& path) const {
+	auto it = entries.find(path);
+	return it != entries.end() ? &it->second : nullptr;
+}
+
+void GameListCache::Set(std::string path, Entry entry) {
+	auto& cur = entries[std::move(path)];
+	if (cur.size != entry.size || cur.mtime != entry.mtime || cur.type != entry.type) {
+		cur = entry;
+		dirty = true;
+	}
+}
+
+bool GameListCache::IsValid(const Entry& entry, int64_t size, int64_t mtime) {
+	// Without a modification time changes cannot be detected
+	return mtime >= 0 && entry.mtime == mtime && entry.size == size;
+}
@@ -0,0 +1,101 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_GAME_LIST_CACHE_H
+#define EP_GAME_LIST_CACHE_H
+
+// Headers
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include "filefinder.h"
+
+/**
+ * Persistent cache of the project types shown by the game browser.
+ *
+ * Entries are keyed by the full path of the game directory or archive and
+ * are only valid as long as size and modification time did not change.
+ */
+class GameListCache {
+public:
+	struct Entry {
+		int64_t size = -1;
+		int64_t mtime = -1;
+		FileFinder::ProjectType type = FileFinder::ProjectType::Unknown;
+	};
+
+	/**
+	 * Reads the cache file from the config directory.
+	 */
+	void Load();
+
+	/**
+	 * Writes the cache file to the config directory when an entry changed.
+	 */
+	void Save();
+
+	/**
+	 * Replaces the entries with the ones in the stream.
+	 * Malformed lines and caches of another version are ignored.
+	 *
+	 * @param is stream to read from
+	 */
+	void Read(std::istream& is);
+
+	/**
+	 * @param os stream to write the entries to
+	 */
+	void Write(std::ostream& os) const;
+
+	/**
+	 * @param path full path of the directory or archive
+	 * @return cached entry or nullptr when the path is not cached
+	 */
+	const Entry* Find(const std::string& path) const;
+
+	/**
+	 * Adds or replaces an entry.
+	 *
+	 * @param path full path of the directory or archive
+	 * @param entry size, modification time and type
+	 */
+	void Set(std::string path, Entry entry);
+
+	/**
+	 * @param entry entry to check
+	 * @param size current size of the directory or archive
+	 * @param mtime current modification time
+	 * @return Whether the entry is still valid
+	 */
+	static bool IsValid(const Entry& entry, int64_t size, int64_t mtime);
+
+	/** @return amount of entries */
+	int GetSize() const;
+
+private:
+	std::unordered_map<std::string, Entry> entries;
+	bool dirty = false;
+};
+
+inline int GameListCache::GetSize() const {
+	return static_cast<int>(entries.size());
+}
+
+#endif
@@ -22,16 +22,19 @@
 #include <sstream>
 #include <algorithm>
 #include <climits>
+#include <functional>
 #include <numeric>
 #include <unordered_set>
 
 #include "async_handler.h"
+#include "cache.h"
 #include "options.h"
 #include "system.h"
 #include "game_battle.h"
 #include "game_battler.h"
 #include "game_map.h"
 #include "game_interpreter_map.h"
+#include "instrumentation.h"
 #include "game_switches.h"
 #include "game_player.h"
 #include "game_party.h"
@@ -67,6 +70,8 @@ namespace {
 	lcf::rpg::SavePanorama panorama;
 
 	bool need_refresh;
+	/** Events to refresh when no full refresh is pending, can contain duplicates */
+	std::vector<int> refresh_event_ids;
 
 	int animation_type;
 	bool animation_fast;
@@ -74,10 +79,30 @@ namespace {
 	std::vector<unsigned char> passages_up;
 	std::vector<Game_Event> events;
 	std::vector<Game_CommonEvent> common_events;
+
+	/**
+	 * Tile-bucketed index of the map events, each tile holds a list
+	 * of indices into events sorted ascending (= by event id).
+	 * Built lazily, any change to the events vector marks it dirty.
+	 */
+	struct EventIndex {
+		/** First event of every tile or -1. The last slot collects events outside of the map. */
+		std::vector<int> heads;
+		/** Next event on the same tile or -1, per event */
+		std::vector<int> next;
+		/** Slot in heads the event is linked into, per event */
+		std::vector<int> slots;
+		bool dirty = true;
+	};
+	EventIndex event_index;
 	std::unique_ptr<Game_Map::Caching::MapCache> map_cache;
 
 	std::unique_ptr<lcf::rpg::Map> map;
 
+	/** Map file loaded ahead of a teleport by PrefetchMap, consumed by LoadMapFile */
+	std::unique_ptr<lcf::rpg::Map> prefetched_map;
+	int prefetched_map_id = 0;
+
 	std::unique_ptr<Game_Interpreter_Map> interpreter;
 	std::vector<Game_Vehicle> vehicles;
 
@@ -133,6 +158,7 @@ void Game_Map::InitCommonEvents() {
 
 void Game_Map::Dispose() {
 	events.clear();
+	event_index.dirty = true;
 	map.reset();
 	map_info = {};
 	panorama = {};
@@ -143,6 +169,7 @@ void Game_Map::Quit() {
 	common_events.clear();
 	interpreter.reset();
 	map_cache.reset();
+	prefetched_map.reset();
 }
 
 int Game_Map::GetMapSaveCount() {
@@ -282,6 +309,8 @@ void Game_Map::SetupFromSave(
 		}
 		UpdateUnderlyingEventReferences();
 	}
+	// SetSaveData replaced the positions
+	event_index.dirty = true;
 	map_info.events.clear();
 	interpreter->Clear();
 
@@ -323,6 +352,10 @@ void Game_Map::SetupFromSave(
 }
 
 std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMapFile(int map_id) {
+	if (prefetched_map && prefetched_map_id == map_id) {
+		return std::move(prefetched_map);
+	}
+
 	std::unique_ptr<lcf::rpg::Map> map;
 
 	// Try loading EasyRPG map files first, then fallback to normal RPG Maker
@@ -370,6 +403,44 @@ std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMapFile(int map_id) {
 	return map;
 }
 
+void Game_Map::PrefetchMap(int map_id) {
+	if (!Cache::IsPrefetchSupported() || map_id <= 0 || map_id == GetMapId()) {
+		return;
+	}
+
+	if (!prefetched_map || prefetched_map_id != map_id) {
+		prefetched_map = LoadMapFile(map_id);
+		prefetched_map_id = map_id;
+	}
+
+	if (!prefetched_map) {
+		return;
+	}
+
+	const auto& next_map = *prefetched_map;
+
+	const auto* next_chipset = lcf::ReaderUtil::GetElement(lcf::Data::chipsets, next_map.chipset_id);
+	if (next_chipset) {
+		Cache::PrefetchChipset(next_chipset->chipset_name);
+	}
+
+	if (next_map.parallax_flag) {
+		Cache::PrefetchPanorama(next_map.parallax_name);
+	}
+
+	for (const auto& ev : next_map.events) {
+		for (const auto& page : ev.pages) {
+			Cache::PrefetchCharset(page.character_name);
+
+			for (const auto& com : page.event_commands) {
+				if (static_cast<lcf::rpg::EventCommand::Code>(com.code) == lcf::rpg::EventCommand::Code::ShowPicture && com.parameters.size() > 7) {
+					Cache::PrefetchPicture(com.string, com.parameters[7] > 0);
+				}
+			}
+		}
+	}
+}
+
 void Game_Map::SetupCommon() {
 	screen_width = (Player::screen_width / 16.0) * SCREEN_TILE_SIZE;
 	screen_height = (Player::screen_height / 16.0) * SCREEN_TILE_SIZE;
@@ -391,6 +462,7 @@ void Game_Map::SetupCommon() {
 }
 
 void Game_Map::CreateMapEvents() {
+	event_index.dirty = true;
 	events.reserve(map->events.size());
 	for (auto& ev : map->events) {
 		events.emplace_back(GetMapId(), &ev);
@@ -411,6 +483,12 @@ void Game_Map::AddEventToCache(const lcf::rpg::Event& ev) {
 		if (pg.condition.flags.variable) {
 			map_cache->AddEventAsRefreshTarget<Op::VarSet>(pg.condition.variable_id, ev);
 		}
+		if (pg.condition.flags.item) {
+			map_cache->AddEventAsRefreshTarget<Op::ItemSet>(pg.condition.item_id, ev);
+		}
+		if (pg.condition.flags.actor) {
+			map_cache->AddEventAsRefreshTarget<Op::ActorSet>(pg.condition.actor_id, ev);
+		}
 	}
 }
 
@@ -427,6 +505,12 @@ void Game_Map::RemoveEventFromCache(const lcf::rpg::Event& ev) {
 		if (pg.condition.flags.variable) {
 			map_cache->RemoveEventAsRefreshTarget<Op::VarSet>(pg.condition.variable_id, ev);
 		}
+		if (pg.condition.flags.item) {
+			map_cache->RemoveEventAsRefreshTarget<Op::ItemSet>(pg.condition.item_id, ev);
+		}
+		if (pg.condition.flags.actor) {
+			map_cache->RemoveEventAsRefreshTarget<Op::ActorSet>(pg.condition.actor_id, ev);
+		}
 	}
 }
 
@@ -490,6 +574,7 @@ bool Game_Map::CloneMapEvent(int src_map_id, int src_event_id, int target_x, int
 		std::upper_bound(events.begin(), events.end(), game_event, [](const auto& e, const auto& e2) {
 			return e.GetId() < e2.GetId();
 		}), std::move(game_event));
+	event_index.dirty = true;
 
 	UpdateUnderlyingEventReferences();
 
@@ -521,6 +606,7 @@ bool Game_Map::DestroyMapEvent(const int event_id, bool from_clone) {
 	for (auto it = events.begin(); it != events.end(); ++it) {
 		if (it->GetId() == event_id) {
 			events.erase(it);
+			event_index.dirty = true;
 			break;
 		}
 	}
@@ -645,6 +731,35 @@ void Game_Map::Refresh() {
 	}
 
 	need_refresh = false;
+	refresh_event_ids.clear();
+}
+
+void Game_Map::RefreshChanged() {
+	if (!GetNeedRefresh()) {
+		return;
+	}
+
+	if (need_refresh) {
+		Refresh();
+		return;
+	}
+
+	if (GetMapId() > 0) {
+		// Only the events observing a changed value, in the same order as the full refresh
+		std::sort(refresh_event_ids.begin(), refresh_event_ids.end());
+		refresh_event_ids.erase(std::unique(refresh_event_ids.begin(), refresh_event_ids.end()), refresh_event_ids.end());
+
+		for (int event_id : refresh_event_ids) {
+			auto it = std::lower_bound(events.begin(), events.end(), event_id, [](const Game_Event& ev, int id) {
+				return ev.GetId() < id;
+			});
+			if (it != events.end() && it->GetId() == event_id) {
+				it->RefreshPage();
+			}
+		}
+	}
+
+	refresh_event_ids.clear();
 }
 
 Game_Interpreter_Map& Game_Map::GetInterpreter() {
@@ -704,6 +819,81 @@ bool Game_Map::IsValid(int x, int y) {
 	return (x >= 0 && x < GetTilesX() && y >= 0 && y < GetTilesY());
 }
 
+static int GetEventIndexSlot(int x, int y) {
+	if (!Game_Map::IsValid(x, y)) {
+		return static_cast<int>(event_index.heads.size()) - 1;
+	}
+	return x + y * Game_Map::GetTilesX();
+}
+
+static void RebuildEventIndex() {
+	auto& idx = event_index;
+	idx.heads.assign(Game_Map::GetTilesX() * Game_Map::GetTilesY() + 1, -1);
+	idx.next.assign(events.size(), -1);
+	idx.slots.assign(events.size(), 0);
+
+	// Prepend in reverse order, this keeps every list sorted ascending
+	for (int i = static_cast<int>(events.size()) - 1; i >= 0; --i) {
+		const int slot = GetEventIndexSlot(events[i].GetX(), events[i].GetY());
+		idx.next[i] = idx.heads[slot];
+		idx.heads[slot] = i;
+		idx.slots[i] = slot;
+	}
+	idx.dirty = false;
+}
+
+/**
+ * @return index of the first event in the list of tile (x,y) after event index prev, or -1.
+ * The list is walked from the start on every call so that events moving between calls
+ * (e.g. by MakeWay) are neither skipped nor visited twice.
+ */
+static int FindNextEventIndexAt(int x, int y, int prev) {
+	if (event_index.dirty) {
+		RebuildEventIndex();
+	}
+
+	for (int i = event_index.heads[GetEventIndexSlot(x, y)]; i >= 0; i = event_index.next[i]) {
+		// The out of map slot holds events of all invalid coordinates
+		if (i > prev && events[i].IsInPosition(x, y)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void Game_Map::OnEventPositionChanged(const Game_Event& ev) {
+	auto& idx = event_index;
+	if (idx.dirty || events.empty()) {
+		return;
+	}
+
+	// Temporary events (e.g. while cloning) are not part of the index
+	std::less<const Game_Event*> less;
+	if (less(&ev, events.data()) || !less(&ev, events.data() + events.size())) {
+		return;
+	}
+	const int ev_idx = static_cast<int>(&ev - events.data());
+
+	const int slot = GetEventIndexSlot(ev.GetX(), ev.GetY());
+	if (slot == idx.slots[ev_idx]) {
+		return;
+	}
+
+	int* link = &idx.heads[idx.slots[ev_idx]];
+	while (*link != ev_idx) {
+		link = &idx.next[*link];
+	}
+	*link = idx.next[ev_idx];
+
+	link = &idx.heads[slot];
+	while (*link >= 0 && *link < ev_idx) {
+		link = &idx.next[*link];
+	}
+	idx.next[ev_idx] = *link;
+	*link = ev_idx;
+	idx.slots[ev_idx] = slot;
+}
+
 static int GetPassableMask(int old_x, int old_y, int new_x, int new_y) {
 	int bit = 0;
 	if (new_x > old_x) { bit |= Passable::Right; }
@@ -883,19 +1073,13 @@ bool Game_Map::CheckOrMakeWayEx(const Game_Character& self,
 	}
 	if (vehicle_type != Game_Vehicle::Airship && check_events_and_vehicles) {
 		// Check for collision with events on the target tile.
-		if (ignore_some_events_by_id.empty()) {
-			for (auto& other: GetEvents()) {
-				if (CheckOrMakeCollideEvent(other)) {
-					return false;
-				}
-			}
-		} else {
-			for (auto& other: GetEvents()) {
-				if (std::find(ignore_some_events_by_id.begin(), ignore_some_events_by_id.end(), other.GetId()) != ignore_some_events_by_id.end())
-					continue;
-				if (CheckOrMakeCollideEvent(other)) {
-					return false;
-				}
+		for (int i = FindNextEventIndexAt(to_x, to_y, -1); i >= 0; i = FindNextEventIndexAt(to_x, to_y, i)) {
+			auto& other = events[i];
+			if (!ignore_some_events_by_id.empty()
+					&& std::find(ignore_some_events_by_id.begin(), ignore_some_events_by_id.end(), other.GetId()) != ignore_some_events_by_id.end())
+				continue;
+			if (CheckOrMakeCollideEvent(other)) {
+				return false;
 			}
 		}
 
@@ -953,10 +1137,9 @@ bool Game_Map::CanLandAirship(int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: events) {
-		if (ev.IsInPosition(x, y)
-				&& ev.IsActive()
-				&& ev.GetActivePage() != nullptr) {
+	for (int i = FindNextEventIndexAt(x, y, -1); i >= 0; i = FindNextEventIndexAt(x, y, i)) {
+		auto& ev = events[i];
+		if (ev.IsActive() && ev.GetActivePage() != nullptr) {
 			return false;
 		}
 	}
@@ -991,9 +1174,9 @@ bool Game_Map::CanDisembarkShip(Game_Player& player, int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: GetEvents()) {
-		if (ev.IsInPosition(x, y)
-			&& ev.GetLayer() == lcf::rpg::EventPage::Layers_same
+	for (int i = FindNextEventIndexAt(x, y, -1); i >= 0; i = FindNextEventIndexAt(x, y, i)) {
+		auto& ev = events[i];
+		if (ev.GetLayer() == lcf::rpg::EventPage::Layers_same
 			&& ev.IsActive()
 			&& ev.GetActivePage() != nullptr) {
 			return false;
@@ -1069,14 +1252,15 @@ bool Game_Map::IsPassableTile(
 
 		// Highest ID event with layer=below, not through, and a tile graphic wins.
 		int event_tile_id = 0;
-		for (auto& ev: events) {
+		for (int i = FindNextEventIndexAt(x, y, -1); i >= 0; i = FindNextEventIndexAt(x, y, i)) {
+			auto& ev = events[i];
 			if (self == &ev) {
 				continue;
 			}
 			if (!ev.IsActive() || ev.GetActivePage() == nullptr || ev.GetThrough()) {
 				continue;
 			}
-			if (ev.IsInPosition(x, y) && ev.GetLayer() == lcf::rpg::EventPage::Layers_below) {
+			if (ev.GetLayer() == lcf::rpg::EventPage::Layers_below) {
 				if (ev.HasTileSprite()) {
 					event_tile_id = ev.GetTileId();
 				}
@@ -1183,14 +1367,20 @@ int Game_Map::GetTerrainTag(int x, int y) {
 }
 
 Game_Event* Game_Map::GetEventAt(int x, int y, bool require_active) {
-	auto& events = GetEvents();
-	for (auto iter = events.rbegin(); iter != events.rend(); ++iter) {
-		auto& ev = *iter;
-		if (ev.IsInPosition(x, y) && (!require_active || ev.IsActive())) {
-			return &ev;
+	Game_Event* found = nullptr;
+	for (int i = FindNextEventIndexAt(x, y, -1); i >= 0; i = FindNextEventIndexAt(x, y, i)) {
+		auto& ev = events[i];
+		if (!require_active || ev.IsActive()) {
+			found = &ev;
 		}
 	}
-	return nullptr;
+	return found;
+}
+
+Game_Event* Game_Map::GetNextEventAt(int x, int y, const Game_Event* prev) {
+	const int prev_idx = prev ? static_cast<int>(prev - events.data()) : -1;
+	const int i = FindNextEventIndexAt(x, y, prev_idx);
+	return i >= 0 ? &events[i] : nullptr;
 }
 
 bool Game_Map::LoopHorizontal() {
@@ -1242,19 +1432,14 @@ int Game_Map::YwithDirection(int y, int direction) {
 }
 
 int Game_Map::CheckEvent(int x, int y) {
-	for (const Game_Event& ev : events) {
-		if (ev.IsInPosition(x, y)) {
-			return ev.GetId();
-		}
-	}
-
-	return 0;
+	const int i = FindNextEventIndexAt(x, y, -1);
+	return i >= 0 ? events[i].GetId() : 0;
 }
 
 void Game_Map::Update(MapUpdateAsyncContext& actx, bool is_preupdate) {
-	if (GetNeedRefresh()) {
-		Refresh();
-	}
+	Instrumentation::Scope iscope("Game_Map::Update");
+
+	RefreshChanged();
 
 	if (!actx.IsActive()) {
 		//If not resuming from async op ...
@@ -1762,25 +1947,33 @@ bool Game_Map::GetNeedRefresh() {
 		return false;
 	}
 
-	return need_refresh;
+	return need_refresh || !refresh_event_ids.empty();
 }
 
 void Game_Map::SetNeedRefresh(bool refresh) {
 	need_refresh = refresh;
+	refresh_event_ids.clear();
 }
 
-void Game_Map::SetNeedRefreshForSwitchChange(int switch_id) {
+template <Game_Map::Caching::ObservedVarOps Op>
+static void SetNeedRefreshForTargets(int first_id, int last_id) {
 	if (need_refresh)
 		return;
-	if (map_cache->GetNeedRefresh<Caching::ObservedVarOps::SwitchSet>(switch_id))
-		SetNeedRefresh(true);
+
+	map_cache->CollectRefreshTargets<Op>(first_id, last_id, refresh_event_ids);
+
+	// Also bounds the list while the anti lag switch suppresses the refresh
+	if (refresh_event_ids.size() > events.size()) {
+		Game_Map::SetNeedRefresh(true);
+	}
+}
+
+void Game_Map::SetNeedRefreshForSwitchChange(int switch_id) {
+	SetNeedRefreshForTargets<Caching::ObservedVarOps::SwitchSet>(switch_id, switch_id);
 }
 
 void Game_Map::SetNeedRefreshForVarChange(int var_id) {
-	if (need_refresh)
-		return;
-	if (map_cache->GetNeedRefresh<Caching::ObservedVarOps::VarSet>(var_id))
-		SetNeedRefresh(true);
+	SetNeedRefreshForTargets<Caching::ObservedVarOps::VarSet>(var_id, var_id);
 }
 
 void Game_Map::SetNeedRefreshForSwitchChange(std::initializer_list<int> switch_ids) {
@@ -1795,6 +1988,22 @@ void Game_Map::SetNeedRefreshForVarChange(std::initializer_list<int> var_ids) {
 	}
 }
 
+void Game_Map::SetNeedRefreshForSwitchRange(int first_switch_id, int last_switch_id) {
+	SetNeedRefreshForTargets<Caching::ObservedVarOps::SwitchSet>(first_switch_id, last_switch_id);
+}
+
+void Game_Map::SetNeedRefreshForVarRange(int first_var_id, int last_var_id) {
+	SetNeedRefreshForTargets<Caching::ObservedVarOps::VarSet>(first_var_id, last_var_id);
+}
+
+void Game_Map::SetNeedRefreshForItemChange(int item_id) {
+	SetNeedRefreshForTargets<Caching::ObservedVarOps::ItemSet>(item_id, item_id);
+}
+
+void Game_Map::SetNeedRefreshForActorChange(int actor_id) {
+	SetNeedRefreshForTargets<Caching::ObservedVarOps::ActorSet>(actor_id, actor_id);
+}
+
 std::vector<unsigned char>& Game_Map::GetPassagesDown() {
 	return passages_down;
 }
@@ -134,6 +134,15 @@ namespace Game_Map {
 	 */
 	std::unique_ptr<lcf::rpg::Map> LoadMapFile(int map_id);
 
+	/**
+	 * Loads the map file of an upcoming teleport and starts decoding the chipset,
+	 * parallax, event graphics and pictures of the map in the background.
+	 * The next LoadMapFile call for this map reuses the loaded file.
+	 *
+	 * @param map_id map that is about to be entered
+	 */
+	void PrefetchMap(int map_id);
+
 	/**
 	 * Setups a new map.
 	 *
@@ -176,10 +185,17 @@ namespace Game_Map {
 	void PlayBgm();
 
 	/**
-	 * Refreshes the map.
+	 * Refreshes the pages of all events.
 	 */
 	void Refresh();
 
+	/**
+	 * Refreshes the pages of the events when needed: all events when the
+	 * need refresh flag is set, otherwise only the events observing a value
+	 * announced by the SetNeedRefreshFor functions.
+	 */
+	void RefreshChanged();
+
 	/** Actions to perform after finishing a battle */
 	void OnContinueFromBattle();
 
@@ -528,7 +544,7 @@ namespace Game_Map {
 	void SetPositionY(int new_position_y, bool reset_panorama = true);
 
 	/**
-	 * @return need refresh flag.
+	 * @return whether a full or a partial refresh of the event pages is pending.
 	 */
 	bool GetNeedRefresh();
 
@@ -541,6 +557,8 @@ namespace Game_Map {
 
 	/**
 	 * Sets the need refresh flag.
+	 * When set all events refresh their page, this also covers any pending
+	 * partial refresh.
 	 *
 	 * @param refresh need refresh flag.
 	 */
@@ -607,6 +625,25 @@ namespace Game_Map {
 	 */
 	Game_Event* GetEventAt(int x, int y, bool require_active);
 
+	/**
+	 * Iterates the events at a tile in ascending id order.
+	 * Events moving during the iteration are handled like a linear scan over all events would.
+	 *
+	 * @param x x position on the map
+	 * @param y y position on the map
+	 * @param prev event returned by the previous call, or nullptr to get the first event
+	 * @return the next event at (x,y) with an id higher than prev, or nullptr if there is none
+	 */
+	Game_Event* GetNextEventAt(int x, int y, const Game_Event* prev);
+
+	/**
+	 * Moves the event to its new tile in the event spatial index.
+	 * Called by Game_Character whenever the position of an event changes.
+	 *
+	 * @param ev the event which moved
+	 */
+	void OnEventPositionChanged(const Game_Event& ev);
+
 	bool LoopHorizontal();
 	bool LoopVertical();
 
@@ -717,6 +754,7 @@ namespace Game_Map {
 		public:
 			void AddEvent(const lcf::rpg::Event& ev);
 			void RemoveEvent(const lcf::rpg::Event& ev);
+			const std::vector<int>& GetEventIds() const;
 
 		private:
 			std::vector<int> event_ids;
@@ -727,6 +765,8 @@ namespace Game_Map {
 		enum ObservedVarOps {
 			SwitchSet = 0,
 			VarSet,
+			ItemSet,
+			ActorSet,
 
 			ObservedVarOps_END
 		};
@@ -742,16 +782,35 @@ namespace Game_Map {
 			template <ObservedVarOps Op>
 			bool GetNeedRefresh(int var_id);
 
+			/**
+			 * Appends the events observing any id of the range.
+			 *
+			 * @param first_id first switch, variable, item or actor
+			 * @param last_id last switch, variable, item or actor
+			 * @param event_ids receives the event ids, can contain duplicates
+			 */
+			template <ObservedVarOps Op>
+			void CollectRefreshTargets(int first_id, int last_id, std::vector<int>& event_ids) const;
+
 			void Clear();
 		private:
 			MapEventCacheData_t refresh_targets_by_varid[ObservedVarOps_END];
 		};
 	}
 
+	/**
+	 * The functions below only refresh the events with a page condition on
+	 * the changed switch, variable, item or actor.
+	 * Too many targets fall back to a full refresh.
+	 */
 	void SetNeedRefreshForSwitchChange(int switch_id);
 	void SetNeedRefreshForVarChange(int var_id);
 	void SetNeedRefreshForSwitchChange(std::initializer_list<int> switch_ids);
 	void SetNeedRefreshForVarChange(std::initializer_list<int> var_ids);
+	void SetNeedRefreshForSwitchRange(int first_switch_id, int last_switch_id);
+	void SetNeedRefreshForVarRange(int first_var_id, int last_var_id);
+	void SetNeedRefreshForItemChange(int item_id);
+	void SetNeedRefreshForActorChange(int actor_id);
 
 	namespace Parallax {
 		struct Params {
@@ -927,4 +986,35 @@ inline bool Game_Map::Caching::MapCache::GetNeedRefresh(int var_id) {
 	return events_cache.find(var_id) != events_cache.end();
 }
 
+template <Game_Map::Caching::ObservedVarOps Op>
+inline void Game_Map::Caching::MapCache::CollectRefreshTargets(int first_id, int last_id, std::vector<int>& event_ids) const {
+	static_assert(static_cast<int>(Op) >= 0 && Op < ObservedVarOps_END);
+
+	auto& events_cache = refresh_targets_by_varid[static_cast<int>(Op)];
+	auto append = [&](const MapEventCache& cache) {
+		const auto& ids = cache.GetEventIds();
+		event_ids.insert(event_ids.end(), ids.begin(), ids.end());
+	};
+
+	// Large ranges are faster checked against the observed ids
+	if (static_cast<int64_t>(last_id) - first_id < static_cast<int64_t>(events_cache.size())) {
+		for (int id = first_id; id <= last_id; ++id) {
+			auto it = events_cache.find(id);
+			if (it != events_cache.end()) {
+				append(it->second);
+			}
+		}
+	} else {
+		for (const auto& entry: events_cache) {
+			if (entry.first >= first_id && entry.first <= last_id) {
+				append(entry.second);
+			}
+		}
+	}
+}
+
+inline const std::vector<int>& Game_Map::Caching::MapEventCache::GetEventIds() const {
+	return event_ids;
+}
+
 #endif
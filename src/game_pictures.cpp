@@ -494,7 +494,8 @@ void Game_Pictures::Picture::AttachWindow(const Window_Base& window) {
 	CreateSprite();
 
 	auto bmp = std::make_shared<Bitmap>(window.GetWidth(), window.GetHeight(), data.use_transparent_color);
-	bmp->SetId(fmt::format("Window:addr={},w={},h={}", (void*)&window, window.GetWidth(), window.GetHeight()));
+	// The serial keeps cached sprite effects of an earlier window at the same address apart
+	bmp->SetId(fmt::format("Window:addr={},w={},h={},serial={}", (void*)&window, window.GetWidth(), window.GetHeight(), bmp->GetSerial()));
 
 	sprite->SetBitmap(bmp);
 	sprite->OnPictureShow();
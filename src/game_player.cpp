@@ -435,16 +435,14 @@ bool Game_Player::CheckEventTriggerHere(TriggerSet triggers, bool triggered_by_d
 
 	bool result = false;
 
-	for (auto& ev: Game_Map::GetEvents()) {
-		const auto trigger = ev.GetTrigger();
-		if (ev.IsActive()
-				&& ev.GetX() == GetX()
-				&& ev.GetY() == GetY()
-				&& ev.GetLayer() != lcf::rpg::EventPage::Layers_same
+	for (auto* ev = Game_Map::GetNextEventAt(GetX(), GetY(), nullptr); ev; ev = Game_Map::GetNextEventAt(GetX(), GetY(), ev)) {
+		const auto trigger = ev->GetTrigger();
+		if (ev->IsActive()
+				&& ev->GetLayer() != lcf::rpg::EventPage::Layers_same
 				&& trigger >= 0
 				&& triggers[trigger]) {
 			SetEncounterCalling(false);
-			result |= ev.ScheduleForegroundExecution(triggered_by_decision_key, face_player);
+			result |= ev->ScheduleForegroundExecution(triggered_by_decision_key, face_player);
 		}
 	}
 	return result;
@@ -456,16 +454,14 @@ bool Game_Player::CheckEventTriggerThere(TriggerSet triggers, int x, int y, bool
 	}
 	bool result = false;
 
-	for (auto& ev : Game_Map::GetEvents()) {
-		const auto trigger = ev.GetTrigger();
-		if (ev.IsActive()
-				&& ev.GetX() == x
-				&& ev.GetY() == y
-				&& ev.GetLayer() == lcf::rpg::EventPage::Layers_same
+	for (auto* ev = Game_Map::GetNextEventAt(x, y, nullptr); ev; ev = Game_Map::GetNextEventAt(x, y, ev)) {
+		const auto trigger = ev->GetTrigger();
+		if (ev->IsActive()
+				&& ev->GetLayer() == lcf::rpg::EventPage::Layers_same
 				&& trigger >= 0
 				&& triggers[trigger]) {
 			SetEncounterCalling(false);
-			result |= ev.ScheduleForegroundExecution(triggered_by_decision_key, face_player);
+			result |= ev->ScheduleForegroundExecution(triggered_by_decision_key, face_player);
 		}
 	}
 	return result;
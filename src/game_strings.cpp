@@ -27,6 +27,7 @@
 #include "game_variables.h"
 #include "output.h"
 #include "player.h"
+#include "regex_cache.h"
 #include "utils.h"
 
 #ifdef HAVE_NLOHMANN_JSON
@@ -309,9 +310,9 @@ std::string_view Game_Strings::ExMatch(Str_Params params, std::string expr, int
 	auto wbase = Utils::ToWideString(base);
 	auto wexpr = Utils::ToWideString(expr);
 
-	std::wregex r(wexpr);
+	auto r = RegexCache::Get(wexpr);
 
-	std::regex_search(wbase, match, r);
+	std::regex_search(wbase, match, *r);
 	str_result = Utils::FromWideString(match.str());
 
 	var_result = match.position() + begin;
@@ -461,9 +462,9 @@ std::string Game_Strings::RegExReplace(std::string_view str, std::string_view se
 	auto wsearch = Utils::ToWideString(search);
 	auto wreplace = Utils::ToWideString(replace);
 
-	std::wregex rexp(wsearch);
+	auto rexp = RegexCache::Get(wsearch);
 
-	auto result = std::regex_replace(wstr, rexp, wreplace, flags);
+	auto result = std::regex_replace(wstr, *rexp, wreplace, flags);
 
 	return Utils::FromWideString(result);
 }
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <chrono>
@@ -30,6 +31,8 @@
 #include "drawable_mgr.h"
 #include "baseui.h"
 #include "game_clock.h"
+#include "game_system.h"
+#include "main_data.h"
 
 using namespace std::chrono_literals;
 
@@ -42,6 +45,21 @@ namespace Graphics {
 	std::unique_ptr<FpsOverlay> fps_overlay;
 
 	std::string window_title_key;
+
+	/** State of the last frame for the damage tracking */
+	struct {
+		const Bitmap* surface = nullptr;
+		uint64_t surface_revision = 0;
+		const DrawableList* list = nullptr;
+		uint64_t background_key = 0;
+		bool partial_redraw = false;
+		std::vector<Rect> rects;
+	} damage;
+
+	bool DrawDamaged(Bitmap& dst);
+	void UpdateDamage(Bitmap& dst);
+	int GetDamageArea(const Bitmap& dst);
+	uint64_t GetBackgroundKey();
 }
 
 void Graphics::Init() {
@@ -114,8 +132,100 @@ void Graphics::Draw(Bitmap& dst) {
 	} else if (transition.IsErasedNotActive()) {
 		min_z = transition.GetZ() + 1;
 		dst.Clear();
+	} else if (DrawDamaged(dst)) {
+		return;
 	}
+
 	LocalDraw(dst, min_z, max_z);
+
+	if (min_z == std::numeric_limits<Drawable::Z_t>::min()) {
+		UpdateDamage(dst);
+	} else {
+		damage.partial_redraw = false;
+		damage.surface = nullptr;
+	}
+}
+
+uint64_t Graphics::GetBackgroundKey() {
+	DamageState state;
+	state.Hash(current_scene.get());
+	if (Main_Data::game_system) {
+		state.Hash(Main_Data::game_system->GetBackgroundColor());
+	}
+	return state.key;
+}
+
+bool Graphics::DrawDamaged(Bitmap& dst) {
+	// Only redraw the damaged parts when the surface still contains the last frame
+	// and the previous frame was mostly static. Otherwise the second draw pass
+	// needed for the damage tracking is a waste of time.
+	auto& drawable_list = DrawableMgr::GetLocalList();
+	if (!damage.partial_redraw || damage.surface != &dst || damage.surface_revision != dst.GetRevision() ||
+			damage.list != &drawable_list || drawable_list.empty() || damage.background_key != GetBackgroundKey()) {
+		return false;
+	}
+
+	// Run all Draw calls without touching any pixel: Drawables update their
+	// state while drawing and this state is needed to determine the damage.
+	damage.rects.clear();
+	dst.SetClipRects(damage.rects);
+	LocalDraw(dst, std::numeric_limits<Drawable::Z_t>::min(), std::numeric_limits<Drawable::Z_t>::max());
+	dst.ResetClip();
+
+	const bool tracked = drawable_list.CollectDamage(damage.rects);
+	const int area = GetDamageArea(dst);
+
+	if (!tracked || area * 2 > dst.GetWidth() * dst.GetHeight()) {
+		// Too much damage: Redraw everything and stay with full redraws until
+		// the screen becomes static again
+		damage.partial_redraw = false;
+		LocalDraw(dst, std::numeric_limits<Drawable::Z_t>::min(), std::numeric_limits<Drawable::Z_t>::max());
+	} else if (area > 0) {
+		dst.SetClipRects(damage.rects);
+		LocalDraw(dst, std::numeric_limits<Drawable::Z_t>::min(), std::numeric_limits<Drawable::Z_t>::max());
+		dst.ResetClip();
+	}
+
+	damage.surface_revision = dst.GetRevision();
+	return true;
+}
+
+int Graphics::GetDamageArea(const Bitmap& dst) {
+	const Rect screen = dst.GetRect();
+	for (auto& rect: damage.rects) {
+		rect.Adjust(screen);
+	}
+	damage.rects.erase(std::remove_if(damage.rects.begin(), damage.rects.end(), [](const Rect& rect) {
+		return rect.IsEmpty();
+	}), damage.rects.end());
+
+	// Overlapping rects are counted multiple times, good enough for a heuristic
+	int area = 0;
+	for (const auto& rect: damage.rects) {
+		area += rect.width * rect.height;
+	}
+	return area;
+}
+
+void Graphics::UpdateDamage(Bitmap& dst) {
+	auto& drawable_list = DrawableMgr::GetLocalList();
+
+	if (damage.list != &drawable_list) {
+		drawable_list.ResetDamage();
+	}
+
+	damage.surface = &dst;
+	damage.surface_revision = dst.GetRevision();
+	damage.list = &drawable_list;
+	damage.background_key = GetBackgroundKey();
+	damage.partial_redraw = false;
+
+	if (!drawable_list.CollectDamage(damage.rects)) {
+		return;
+	}
+
+	// Use partial redraws for the next frame when this frame was mostly static
+	damage.partial_redraw = GetDamageArea(dst) * 2 <= dst.GetWidth() * dst.GetHeight();
 }
 
 void Graphics::LocalDraw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z) {
@@ -18,11 +18,96 @@
 #include "instrumentation.h"
 #include "utils.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <fmt/ostream.h>
+
+std::atomic<bool> Instrumentation::recording{ false };
+
+namespace {
+	struct ScopeEvent {
+		const char* name = nullptr;
+		Game_Clock::time_point begin;
+		Game_Clock::time_point end;
+	};
+
+	/**
+	 * Fixed size ring buffer that is only written by its owning thread.
+	 * Readers on other threads take a snapshot without locking. Entries that
+	 * were overwritten while copying are detected by rereading the head and
+	 * are discarded.
+	 */
+	class ThreadBuffer {
+	public:
+		static constexpr size_t capacity = 16384;
+
+		ThreadBuffer(int tid, std::thread::id thread_id) : tid(tid), thread_id(thread_id) {}
+
+		void Push(const ScopeEvent& ev) {
+			auto h = head.load(std::memory_order_relaxed);
+			events[h % capacity] = ev;
+			head.store(h + 1, std::memory_order_release);
+		}
+
+		std::vector<ScopeEvent> Snapshot() const {
+			auto h = head.load(std::memory_order_acquire);
+			size_t first = h > capacity ? h - capacity : 0;
+
+			std::vector<ScopeEvent> out;
+			out.reserve(h - first);
+			for (size_t i = first; i < h; ++i) {
+				out.push_back(events[i % capacity]);
+			}
+
+			// Drop everything the writer could have touched in the meantime,
+			// including the slot of index h_after which may be written right now
+			auto h_after = head.load(std::memory_order_acquire);
+			size_t overwritten = h_after >= capacity ? h_after - capacity + 1 : 0;
+			if (overwritten > first) {
+				out.erase(out.begin(), out.begin() + std::min(overwritten - first, out.size()));
+			}
+			return out;
+		}
+
+		const int tid;
+		const std::thread::id thread_id;
+
+	private:
+		std::atomic<size_t> head{ 0 };
+		std::array<ScopeEvent, capacity> events;
+	};
+
+	std::mutex buffers_mutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+	std::thread::id main_thread_id;
+
+	ThreadBuffer& GetThreadBuffer() {
+		thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+			std::lock_guard<std::mutex> lock(buffers_mutex);
+			auto buf = std::make_shared<ThreadBuffer>(static_cast<int>(buffers.size()) + 1, std::this_thread::get_id());
+			buffers.push_back(buf);
+			return buf;
+		}();
+		return *buffer;
+	}
+
+	std::vector<std::shared_ptr<ThreadBuffer>> GetBuffers() {
+		std::lock_guard<std::mutex> lock(buffers_mutex);
+		return buffers;
+	}
+}
+
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 __itt_domain* Instrumentation::domain = nullptr;
 #endif
 
 void Instrumentation::Init(const char* name) {
+	main_thread_id = std::this_thread::get_id();
+
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	assert(!domain);
 #ifdef _WIN32
@@ -34,3 +119,77 @@ void Instrumentation::Init(const char* name) {
 	(void)name;
 #endif
 }
+
+void Instrumentation::Record(const char* name, Game_Clock::time_point begin, Game_Clock::time_point end) {
+	GetThreadBuffer().Push({ name, begin, end });
+}
+
+std::vector<Instrumentation::ScopeTiming> Instrumentation::GetMainThreadTimings(Game_Clock::time_point since) {
+	std::vector<ScopeTiming> timings;
+
+	for (auto& buf: GetBuffers()) {
+		if (buf->thread_id != main_thread_id) {
+			continue;
+		}
+
+		for (auto& ev: buf->Snapshot()) {
+			if (ev.begin < since) {
+				continue;
+			}
+
+			// Few distinct names, a linear search is faster than a map here
+			auto it = std::find_if(timings.begin(), timings.end(), [&](auto& t) {
+				return t.name == ev.name || std::strcmp(t.name, ev.name) == 0;
+			});
+			if (it == timings.end()) {
+				timings.push_back({ ev.name, {}, 0 });
+				it = timings.end() - 1;
+			}
+			it->time += ev.end - ev.begin;
+			++it->count;
+		}
+	}
+
+	std::sort(timings.begin(), timings.end(), [](auto& l, auto& r) {
+		return l.time > r.time;
+	});
+
+	return timings;
+}
+
+void Instrumentation::WriteChromeTrace(std::ostream& os) {
+	auto us = [](Game_Clock::duration d) {
+		return std::chrono::duration<double, std::micro>(d).count();
+	};
+
+	auto all_buffers = GetBuffers();
+
+	// Timestamps are relative to the oldest recorded event
+	std::vector<std::vector<ScopeEvent>> snapshots;
+	Game_Clock::time_point origin = Game_Clock::time_point::max();
+	for (auto& buf: all_buffers) {
+		snapshots.push_back(buf->Snapshot());
+		if (!snapshots.back().empty()) {
+			origin = std::min(origin, snapshots.back().front().begin);
+		}
+	}
+
+	fmt::print(os, "{{\"traceEvents\":[\n");
+
+	bool first = true;
+	for (size_t i = 0; i < all_buffers.size(); ++i) {
+		const int tid = all_buffers[i]->tid;
+		const char* thread_name = all_buffers[i]->thread_id == main_thread_id ? "Main" : "Worker";
+
+		fmt::print(os, "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{} {}\"}}}}",
+			first ? "" : ",\n", tid, thread_name, tid);
+		first = false;
+
+		for (auto& ev: snapshots[i]) {
+			fmt::print(os, ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+				ev.name, tid, us(ev.begin - origin), us(ev.end - ev.begin));
+		}
+	}
+
+	fmt::print(os, "\n]}}\n");
+}
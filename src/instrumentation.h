@@ -25,7 +25,11 @@
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 #include <ittnotify.h>
 #endif
+#include <atomic>
 #include <cassert>
+#include <ostream>
+#include <vector>
+#include "game_clock.h"
 
 class Instrumentation {
 public:
@@ -42,6 +46,71 @@ public:
 	/** Call at the end of a frame */
 	static void FrameEnd();
 
+	/**
+	 * Enables or disables recording of named scopes by the built-in backend.
+	 * Recording is off by default and a disabled Scope only costs a branch.
+	 *
+	 * @param enabled whether to record
+	 */
+	static void SetRecording(bool enabled);
+
+	/** @return whether named scopes are recorded */
+	static bool IsRecording();
+
+	/**
+	 * Records a finished named scope into the ring buffer of the calling thread.
+	 * Only the newest events of each thread are kept.
+	 *
+	 * @param name name of the scope, must have static storage duration
+	 * @param begin start time
+	 * @param end end time
+	 */
+	static void Record(const char* name, Game_Clock::time_point begin, Game_Clock::time_point end);
+
+	/** Accumulated time of all scopes with the same name */
+	struct ScopeTiming {
+		const char* name = nullptr;
+		Game_Clock::duration time = {};
+		int count = 0;
+	};
+
+	/**
+	 * Sums up all scopes recorded on the main thread that started after since.
+	 * Nested scopes are included in the time of their parents.
+	 *
+	 * @param since start of the time range
+	 * @return timings ordered by time, longest first
+	 */
+	static std::vector<ScopeTiming> GetMainThreadTimings(Game_Clock::time_point since);
+
+	/**
+	 * Writes all recorded scopes of all threads in the Chrome trace event format.
+	 * The output can be loaded in chrome://tracing or Perfetto.
+	 *
+	 * @param os stream to write to
+	 */
+	static void WriteChromeTrace(std::ostream& os);
+
+	/** RAII wrapper that records a named scope when recording is enabled */
+	class Scope {
+	public:
+		/**
+		 * Create a Scope
+		 *
+		 * @param name name of the scope, must have static storage duration
+		 */
+		explicit Scope(const char* name) noexcept;
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		/** Records the scope */
+		~Scope();
+	private:
+		const char* name = nullptr;
+		Game_Clock::time_point begin;
+	};
+
 	/** RAII wrapper around FrameBegin() / FrameEnd() */
 	class FrameScope {
 	public:
@@ -77,6 +146,7 @@ private:
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	static __itt_domain* domain;
 #endif
+	static std::atomic<bool> recording;
 };
 
 inline void Instrumentation::FrameBegin() {
@@ -92,6 +162,27 @@ inline void Instrumentation::FrameEnd() {
 #endif
 }
 
+inline void Instrumentation::SetRecording(bool enabled) {
+	recording.store(enabled, std::memory_order_relaxed);
+}
+
+inline bool Instrumentation::IsRecording() {
+	return recording.load(std::memory_order_relaxed);
+}
+
+inline Instrumentation::Scope::Scope(const char* name) noexcept {
+	if (IsRecording()) {
+		this->name = name;
+		begin = Game_Clock::now();
+	}
+}
+
+inline Instrumentation::Scope::~Scope() {
+	if (name) {
+		Record(name, begin, Game_Clock::now());
+	}
+}
+
 inline Instrumentation::FrameScope::FrameScope(bool frame_begin)
 {
 	if (frame_begin) {
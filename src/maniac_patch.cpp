@@ -33,6 +33,12 @@
 #include <lcf/reader_lcf.h>
 #include <lcf/reader_util.h>
 #include <lcf/writer_lcf.h>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 /*
@@ -177,434 +183,616 @@ struct ProcessAssignmentRet {
 	}
 };
 
-ProcessAssignmentRet ProcessAssignment(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip);
+namespace {
+	/**
+	 * Instruction of a compiled expression.
+	 * The instructions work on a value stack, every operand is pushed
+	 * before the instruction consuming it.
+	 */
+	struct Instruction {
+		enum class Type : uint8_t {
+			/** Pushes arg */
+			Const,
+			/** Replaces the id on the stack with the value */
+			Var,
+			Switch,
+			VarIndirect,
+			SwitchIndirect,
+			/** Unary, binary and ternary operators, op is the operator */
+			Unary,
+			Binary,
+			Ternary,
+			/** Pops id and value and assigns, op is the operator, arg the Op of the lvalue */
+			Inplace,
+			/** Calls the function arg */
+			Function,
+			/** Logs the warning with index arg */
+			Warning,
+			/** Pops arg values */
+			Discard
+		};
+
+		Type type;
+		Op op;
+		int32_t arg;
+	};
 
-int Process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip) {
-	int value = 0;
-	int imm = 0;
-	int imm2 = 0;
-	int imm3 = 0;
+	struct FunctionInfo {
+		const char* name;
+		int args;
+	};
 
-	if (it == end) {
-		return 0;
-	}
+	/** Name (used in warnings) and argument count of the functions, indexed by Fn */
+	constexpr FunctionInfo function_info[] = {
+		{ "rnd", 2 },
+		{ "item", 2 },
+		{ "event", 2 },
+		{ "actor", 2 },
+		{ "member", 2 },
+		{ "enemy", 2 },
+		{ "misc", 1 },
+		{ "pow", 2 },
+		{ "sqrt", 2 },
+		{ "sin", 3 },
+		{ "cos", 3 },
+		{ "atan2", 3 },
+		{ "min", 2 },
+		{ "max", 2 },
+		{ "abs", 1 },
+		{ "clamp", 3 },
+		{ "muldiv", 3 },
+		{ "divmul", 3 },
+		{ "between", 3 }
+	};
 
-	auto op = static_cast<Op>(*it);
-	++it;
+	/** Maniac expression compiled from the op codes of an event command */
+	struct CompiledExpression {
+		std::vector<Instruction> code;
+		std::vector<std::string> warnings;
+		/** Maximum size of the value stack during evaluation */
+		int max_depth = 0;
+	};
 
-	// When entering the switch it is on the first argument
-	switch (op) {
-		case Op::Null:
-			it++;
-			return 0;
-		case Op::U8:
-		case Op::UX8:
-			value = *it++;
-			return value;
-		case Op::U16:
-		case Op::UX16:
-			imm = *it++;
-			if (it == end) {
-				return 0;
+	/**
+	 * Translates the op codes into instructions.
+	 * Unsupported operations and functions with a wrong argument count do not
+	 * consume their arguments, the following op codes are parsed as the next
+	 * operand instead.
+	 */
+	class ExpressionCompiler {
+	public:
+		explicit ExpressionCompiler(Span<const int32_t> op_codes) {
+			ops.reserve(op_codes.size() * 4);
+			for (auto& o: op_codes) {
+				auto uo = static_cast<uint32_t>(o);
+				ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
+				ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
+				ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
+				ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
 			}
-			imm2 = *it++;
-			value = (imm2 << 8) + imm;
-			return value;
-		case Op::S32:
-		case Op::SX32:
-			imm = *it++;
-			if (it == end) {
-				return 0;
-			}
-			imm2 = *it++;
-			if (it == end) {
-				return 0;
+		}
+
+		/** Compiles the first expression */
+		CompiledExpression CompileSingle() {
+			Compile();
+			return std::move(result);
+		}
+
+		/** Compiles all expressions, every expression leaves a value on the stack */
+		CompiledExpression CompileList() {
+			if (ops.empty()) {
+				return {};
 			}
-			imm3 = *it++;
-			if (it == end) {
-				return 0;
+
+			while (true) {
+				Compile();
+
+				if (AtEnd() || static_cast<Op>(ops[pos]) == Op::Null) {
+					break;
+				}
 			}
-			value = *it++;
-			value = (value << 24) + (imm3 << 16) + (imm2 << 8) + imm;
+			return std::move(result);
+		}
+
+	private:
+		bool AtEnd() const {
+			return pos >= ops.size();
+		}
+
+		int32_t Read() {
+			// Reading past the end yields 0
+			int32_t value = AtEnd() ? 0 : ops[pos];
+			++pos;
 			return value;
-		case Op::Var:
-			imm = Process(it, end, ip);
-			return Main_Data::game_variables->Get(imm);
-		case Op::Switch:
-			imm = Process(it, end, ip);
-			return Main_Data::game_switches->GetInt(imm);
-		case Op::VarIndirect:
-			imm = Process(it, end, ip);
-			return Main_Data::game_variables->GetIndirect(imm);
-		case Op::SwitchIndirect:
-			imm = Process(it, end, ip);
-			return Main_Data::game_switches->GetInt(Main_Data::game_variables->Get(imm));
-		case Op::Negate:
-			imm = Process(it, end, ip);
-			return -imm;
-		case Op::Not:
-			imm = Process(it, end, ip);
-			return !imm ? 0 : 1;
-		case Op::Flip:
-			imm = Process(it, end, ip);
-			return ~imm;
-		case Op::AssignInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(imm2);
-		}
-		case Op::AddInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) + imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::SubInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) - imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::MulInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) * imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::DivInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return ret.fetch();
-			}
-			return ret.assign(ret.fetch() / imm2);
 		}
-		case Op::ModInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return ret.fetch();
-			}
-			return ret.assign(ret.fetch() % imm2);
-		}
-		case Op::BitOrInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() | imm2);
-		}
-		case Op::BitAndInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() & imm2);
-		}
-		case Op::BitXorInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() ^ imm2);
-		}
-		case Op::BitShiftLeftInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() << imm2);
-		}
-		case Op::BitShiftRightInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() >> imm2);
-		}
-		case Op::Add:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) + imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Sub:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) - imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Mul:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) * imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Div:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return imm;
+
+		void Emit(Instruction::Type type, Op op = Op::Null, int32_t arg = 0, int pop = 0, int push = 0) {
+			result.code.push_back({ type, op, arg });
+			depth += push - pop;
+			result.max_depth = std::max(result.max_depth, depth);
+		}
+
+		void EmitConst(int32_t value) {
+			Emit(Instruction::Type::Const, Op::Null, value, 0, 1);
+		}
+
+		template <typename... Args>
+		void EmitWarning(Args&&... args) {
+			result.warnings.push_back(fmt::format(std::forward<Args>(args)...));
+			Emit(Instruction::Type::Warning, Op::Null, static_cast<int32_t>(result.warnings.size() - 1));
+		}
+
+		void Compile();
+		void CompileAssignment(Op& lvalue);
+		void CompileFunction();
+
+		std::vector<int32_t> ops;
+		size_t pos = 0;
+		int depth = 0;
+		CompiledExpression result;
+	};
+
+	void ExpressionCompiler::Compile() {
+		if (AtEnd()) {
+			EmitConst(0);
+			return;
+		}
+
+		auto op = static_cast<Op>(Read());
+
+		switch (op) {
+			case Op::Null:
+				Read();
+				EmitConst(0);
+				return;
+			case Op::U8:
+			case Op::UX8:
+				EmitConst(Read());
+				return;
+			case Op::U16:
+			case Op::UX16: {
+				uint32_t imm = Read();
+				if (AtEnd()) {
+					EmitConst(0);
+					return;
+				}
+				uint32_t imm2 = Read();
+				EmitConst(static_cast<int32_t>((imm2 << 8) + imm));
+				return;
 			}
-			return imm / imm2;
-		case Op::Mod:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return imm;
+			case Op::S32:
+			case Op::SX32: {
+				uint32_t imm[4];
+				for (int i = 0; i < 3; ++i) {
+					imm[i] = Read();
+					if (AtEnd()) {
+						EmitConst(0);
+						return;
+					}
+				}
+				imm[3] = Read();
+				EmitConst(static_cast<int32_t>((imm[3] << 24) + (imm[2] << 16) + (imm[1] << 8) + imm[0]));
+				return;
 			}
-			return imm % imm2;
-		case Op::BitOr:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm | imm2;
-		case Op::BitAnd:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm & imm2;
-		case Op::BitXor:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm ^ imm2;
-		case Op::BitShiftLeft:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm << imm2;
-		case Op::BitShiftRight:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm >> imm2;
-		case Op::Equal:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm == imm2 ? 1 : 0;
-		case Op::GreaterEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm >= imm2 ? 1 : 0;
-		case Op::LessEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm <= imm2 ? 1 : 0;
-		case Op::Greater:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm > imm2 ? 1 : 0;
-		case Op::Less:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm < imm2 ? 1 : 0;
-		case Op::NotEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm != imm2 ? 1 : 0;
-		case Op::Or:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return !!imm || !!imm2 ? 1 : 0;
-		case Op::And:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return !!imm && !!imm2 ? 1 : 0;
-		case Op::Ternary:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			imm3 = Process(it, end, ip);
-			return imm != 0 ? imm2 : imm3;
-		case Op::Function:
-			imm = *it++; // function
-			imm2 = *it++; // arguments
-
-			if ((imm2 & 0x80) != 0) {
-				// Argument count is 4 bytes, that mode is not supported
-				Output::Warning("Maniac: Expression func long args unsupported");
-				return 0;
+			case Op::Var:
+				Compile();
+				Emit(Instruction::Type::Var, op, 0, 1, 1);
+				return;
+			case Op::Switch:
+				Compile();
+				Emit(Instruction::Type::Switch, op, 0, 1, 1);
+				return;
+			case Op::VarIndirect:
+				Compile();
+				Emit(Instruction::Type::VarIndirect, op, 0, 1, 1);
+				return;
+			case Op::SwitchIndirect:
+				Compile();
+				Emit(Instruction::Type::SwitchIndirect, op, 0, 1, 1);
+				return;
+			case Op::Negate:
+			case Op::Not:
+			case Op::Flip:
+				Compile();
+				Emit(Instruction::Type::Unary, op, 0, 1, 1);
+				return;
+			case Op::AssignInplace:
+			case Op::AddInplace:
+			case Op::SubInplace:
+			case Op::MulInplace:
+			case Op::DivInplace:
+			case Op::ModInplace:
+			case Op::BitOrInplace:
+			case Op::BitAndInplace:
+			case Op::BitXorInplace:
+			case Op::BitShiftLeftInplace:
+			case Op::BitShiftRightInplace: {
+				Op lvalue;
+				CompileAssignment(lvalue);
+				Compile();
+				Emit(Instruction::Type::Inplace, op, static_cast<int32_t>(lvalue), 2, 1);
+				return;
 			}
+			case Op::Add:
+			case Op::Sub:
+			case Op::Mul:
+			case Op::Div:
+			case Op::Mod:
+			case Op::BitOr:
+			case Op::BitAnd:
+			case Op::BitXor:
+			case Op::BitShiftLeft:
+			case Op::BitShiftRight:
+			case Op::Equal:
+			case Op::GreaterEqual:
+			case Op::LessEqual:
+			case Op::Greater:
+			case Op::Less:
+			case Op::NotEqual:
+			case Op::Or:
+			case Op::And:
+				Compile();
+				Compile();
+				Emit(Instruction::Type::Binary, op, 0, 2, 1);
+				return;
+			case Op::Ternary:
+				Compile();
+				Compile();
+				Compile();
+				Emit(Instruction::Type::Ternary, op, 0, 3, 1);
+				return;
+			case Op::Function:
+				CompileFunction();
+				return;
+			default:
+				EmitWarning("Maniac: Expression contains unsupported operation {}", static_cast<int>(op));
+				EmitConst(0);
+				return;
+		}
+	}
 
-			switch (static_cast<Fn>(imm)) {
-				case Fn::Rand:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression rnd args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Random(Process(it, end, ip), imm3);
-				case Fn::Item:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression item args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Item(Process(it, end, ip), imm3);
-				case Fn::Event:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression event args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Event(Process(it, end, ip), imm3, ip);
-				case Fn::Actor:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression actor args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Actor(Process(it, end, ip), imm3);
-				case Fn::Party:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression member args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Party(Process(it, end, ip), imm3);
-				case Fn::Enemy:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression enemy args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Enemy(Process(it, end, ip), imm3);
-					break;
-				case Fn::Misc:
-					if (imm2 != 1) {
-						Output::Warning("Maniac: Expression misc args {} != 1", imm2);
-						return 0;
-					}
-					return ControlVariables::Other(Process(it, end, ip));
-				case Fn::Pow:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression pow args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Pow(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Sqrt:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression sqrt args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Sqrt(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Sin:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression sin args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Sin(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Cos:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression cos args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Cos(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Atan2:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression atan2 args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Atan2(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Min:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression min args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Min(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Max:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression max args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Max(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Abs:
-					if (imm2 != 1) {
-						Output::Warning("Maniac: Expression abs args {} != 1", imm2);
-						return 0;
-					}
-					return ControlVariables::Abs(Process(it, end, ip));
-				case Fn::Clamp:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression clamp args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Clamp(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Muldiv:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression muldiv args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Muldiv(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Divmul:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression divmul args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Divmul(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Between:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression between args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Between(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				default:
-					Output::Warning("Maniac: Expression Unknown Func {}", imm);
-					for (int i = 0; i < imm2; ++i) {
-						Process(it, end, ip);
-					}
-					return 0;
-			}
-		default:
-			Output::Warning("Maniac: Expression contains unsupported operation {}", static_cast<int>(op));
-			return 0;
+	void ExpressionCompiler::CompileAssignment(Op& lvalue) {
+		// Like Compile but it remembers the type (Variable or Switch) without evaluating it to allow assignments
+		if (AtEnd()) {
+			lvalue = Op::Null;
+			EmitConst(0);
+			return;
+		}
+
+		lvalue = static_cast<Op>(Read());
+
+		switch (lvalue) {
+			case Op::Var:
+			case Op::Switch:
+			case Op::VarIndirect:
+			case Op::SwitchIndirect:
+				Compile();
+				return;
+			default:
+				--pos; // back on the op as op is fetched again by Compile
+				Compile();
+				return;
+		}
 	}
-}
 
-ProcessAssignmentRet ProcessAssignment(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip) {
-	// Like process but it remembers the type (Variable or Switch) without evaluating it to allow assignments
-	int imm = 0;
+	void ExpressionCompiler::CompileFunction() {
+		int32_t fn = Read();
+		int32_t args = Read();
 
-	if (it == end) {
-		return {Op::Null, 0};
+		if ((args & 0x80) != 0) {
+			// Argument count is 4 bytes, that mode is not supported
+			EmitWarning("Maniac: Expression func long args unsupported");
+			EmitConst(0);
+			return;
+		}
+
+		if (fn < 0 || fn >= static_cast<int32_t>(std::size(function_info))) {
+			EmitWarning("Maniac: Expression Unknown Func {}", fn);
+			for (int i = 0; i < args; ++i) {
+				Compile();
+			}
+			Emit(Instruction::Type::Discard, Op::Null, args, args, 0);
+			EmitConst(0);
+			return;
+		}
+
+		const auto& info = function_info[fn];
+		if (args != info.args) {
+			EmitWarning("Maniac: Expression {} args {} != {}", info.name, args, info.args);
+			EmitConst(0);
+			return;
+		}
+
+		for (int i = 0; i < args; ++i) {
+			Compile();
+		}
+		Emit(Instruction::Type::Function, Op::Function, fn, args, 1);
 	}
 
-	auto op = static_cast<Op>(*it);
-	++it;
+	int32_t ClampInt32(int64_t value) {
+		return static_cast<int32_t>(Utils::Clamp<int64_t>(value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+	}
 
-	// When entering the switch it is on the first argument
-	switch (op) {
-		case Op::Var:
-		case Op::Switch:
-		case Op::VarIndirect:
-		case Op::SwitchIndirect:
-			imm = Process(it, end, ip);
-			return {op, imm};
-		default:
-			--it; // back on the op as op is fetched again by Process
-			imm = Process(it, end, ip);
-			return {op, imm};
+	int32_t EvaluateInplace(Op op, const ProcessAssignmentRet& ret, int32_t value) {
+		switch (op) {
+			case Op::AssignInplace:
+				return ret.assign(value);
+			case Op::AddInplace:
+				return ret.assign(ClampInt32(static_cast<int64_t>(ret.fetch()) + value));
+			case Op::SubInplace:
+				return ret.assign(ClampInt32(static_cast<int64_t>(ret.fetch()) - value));
+			case Op::MulInplace:
+				return ret.assign(ClampInt32(static_cast<int64_t>(ret.fetch()) * value));
+			case Op::DivInplace:
+				if (value == 0) {
+					return ret.fetch();
+				}
+				return ret.assign(ret.fetch() / value);
+			case Op::ModInplace:
+				if (value == 0) {
+					return ret.fetch();
+				}
+				return ret.assign(ret.fetch() % value);
+			case Op::BitOrInplace:
+				return ret.assign(ret.fetch() | value);
+			case Op::BitAndInplace:
+				return ret.assign(ret.fetch() & value);
+			case Op::BitXorInplace:
+				return ret.assign(ret.fetch() ^ value);
+			case Op::BitShiftLeftInplace:
+				return ret.assign(ret.fetch() << value);
+			case Op::BitShiftRightInplace:
+				return ret.assign(ret.fetch() >> value);
+			default:
+				return 0;
+		}
 	}
-}
 
-int32_t ManiacPatch::ParseExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
-	std::vector<int32_t> ops;
-	for (auto &o: op_codes) {
-		auto uo = static_cast<uint32_t>(o);
-		ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
-		ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
-		ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
-		ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
-	}
-	auto beg = ops.begin();
-	return Process(beg, ops.end(), interpreter);
-}
+	int32_t EvaluateBinary(Op op, int32_t imm, int32_t imm2) {
+		switch (op) {
+			case Op::Add:
+				return ClampInt32(static_cast<int64_t>(imm) + imm2);
+			case Op::Sub:
+				return ClampInt32(static_cast<int64_t>(imm) - imm2);
+			case Op::Mul:
+				return ClampInt32(static_cast<int64_t>(imm) * imm2);
+			case Op::Div:
+				if (imm2 == 0) {
+					return imm;
+				}
+				return imm / imm2;
+			case Op::Mod:
+				if (imm2 == 0) {
+					return imm;
+				}
+				return imm % imm2;
+			case Op::BitOr:
+				return imm | imm2;
+			case Op::BitAnd:
+				return imm & imm2;
+			case Op::BitXor:
+				return imm ^ imm2;
+			case Op::BitShiftLeft:
+				return imm << imm2;
+			case Op::BitShiftRight:
+				return imm >> imm2;
+			case Op::Equal:
+				return imm == imm2 ? 1 : 0;
+			case Op::GreaterEqual:
+				return imm >= imm2 ? 1 : 0;
+			case Op::LessEqual:
+				return imm <= imm2 ? 1 : 0;
+			case Op::Greater:
+				return imm > imm2 ? 1 : 0;
+			case Op::Less:
+				return imm < imm2 ? 1 : 0;
+			case Op::NotEqual:
+				return imm != imm2 ? 1 : 0;
+			case Op::Or:
+				return !!imm || !!imm2 ? 1 : 0;
+			case Op::And:
+				return !!imm && !!imm2 ? 1 : 0;
+			default:
+				return 0;
+		}
+	}
 
-std::vector<int32_t> ManiacPatch::ParseExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
-	std::vector<int32_t> ops;
-	for (auto& o : op_codes) {
-		auto uo = static_cast<uint32_t>(o);
-		ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
-		ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
-		ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
-		ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
+	/**
+	 * Arguments are in the order of the op codes. The first op code is the
+	 * last parameter of the function, like in the former recursive evaluation.
+	 */
+	int32_t EvaluateFunction(Fn fn, const int32_t* a, const Game_BaseInterpreterContext& ip) {
+		switch (fn) {
+			case Fn::Rand:
+				return ControlVariables::Random(a[1], a[0]);
+			case Fn::Item:
+				return ControlVariables::Item(a[1], a[0]);
+			case Fn::Event:
+				return ControlVariables::Event(a[1], a[0], ip);
+			case Fn::Actor:
+				return ControlVariables::Actor(a[1], a[0]);
+			case Fn::Party:
+				return ControlVariables::Party(a[1], a[0]);
+			case Fn::Enemy:
+				return ControlVariables::Enemy(a[1], a[0]);
+			case Fn::Misc:
+				return ControlVariables::Other(a[0]);
+			case Fn::Pow:
+				return ControlVariables::Pow(a[1], a[0]);
+			case Fn::Sqrt:
+				return ControlVariables::Sqrt(a[1], a[0]);
+			case Fn::Sin:
+				return ControlVariables::Sin(a[2], a[1], a[0]);
+			case Fn::Cos:
+				return ControlVariables::Cos(a[2], a[1], a[0]);
+			case Fn::Atan2:
+				return ControlVariables::Atan2(a[2], a[1], a[0]);
+			case Fn::Min:
+				return ControlVariables::Min(a[1], a[0]);
+			case Fn::Max:
+				return ControlVariables::Max(a[1], a[0]);
+			case Fn::Abs:
+				return ControlVariables::Abs(a[0]);
+			case Fn::Clamp:
+				return ControlVariables::Clamp(a[2], a[1], a[0]);
+			case Fn::Muldiv:
+				return ControlVariables::Muldiv(a[2], a[1], a[0]);
+			case Fn::Divmul:
+				return ControlVariables::Divmul(a[2], a[1], a[0]);
+			case Fn::Between:
+				return ControlVariables::Between(a[2], a[1], a[0]);
+			default:
+				return 0;
+		}
 	}
 
-	if (ops.empty()) {
-		return {};
+	/**
+	 * Evaluates a compiled expression.
+	 *
+	 * @param expr compiled expression
+	 * @param ip interpreter executing the expression
+	 * @param stack value stack, must hold max_depth values and receives the results
+	 * @return number of values left on the stack
+	 */
+	int Evaluate(const CompiledExpression& expr, const Game_BaseInterpreterContext& ip, int32_t* stack) {
+		int sp = 0;
+
+		for (const auto& ins: expr.code) {
+			switch (ins.type) {
+				case Instruction::Type::Const:
+					stack[sp++] = ins.arg;
+					break;
+				case Instruction::Type::Var:
+					stack[sp - 1] = Main_Data::game_variables->Get(stack[sp - 1]);
+					break;
+				case Instruction::Type::Switch:
+					stack[sp - 1] = Main_Data::game_switches->GetInt(stack[sp - 1]);
+					break;
+				case Instruction::Type::VarIndirect:
+					stack[sp - 1] = Main_Data::game_variables->GetIndirect(stack[sp - 1]);
+					break;
+				case Instruction::Type::SwitchIndirect:
+					stack[sp - 1] = Main_Data::game_switches->GetInt(Main_Data::game_variables->Get(stack[sp - 1]));
+					break;
+				case Instruction::Type::Unary: {
+					int32_t imm = stack[sp - 1];
+					if (ins.op == Op::Negate) {
+						stack[sp - 1] = -imm;
+					} else if (ins.op == Op::Not) {
+						stack[sp - 1] = !imm ? 0 : 1;
+					} else {
+						stack[sp - 1] = ~imm;
+					}
+					break;
+				}
+				case Instruction::Type::Binary:
+					--sp;
+					stack[sp - 1] = EvaluateBinary(ins.op, stack[sp - 1], stack[sp]);
+					break;
+				case Instruction::Type::Ternary:
+					sp -= 2;
+					stack[sp - 1] = stack[sp - 1] != 0 ? stack[sp] : stack[sp + 1];
+					break;
+				case Instruction::Type::Inplace: {
+					--sp;
+					ProcessAssignmentRet ret = { static_cast<Op>(ins.arg), stack[sp - 1] };
+					stack[sp - 1] = EvaluateInplace(ins.op, ret, stack[sp]);
+					break;
+				}
+				case Instruction::Type::Function: {
+					sp -= function_info[ins.arg].args;
+					stack[sp] = EvaluateFunction(static_cast<Fn>(ins.arg), stack + sp, ip);
+					++sp;
+					break;
+				}
+				case Instruction::Type::Warning:
+					Output::WarningStr(expr.warnings[ins.arg]);
+					break;
+				case Instruction::Type::Discard:
+					sp -= ins.arg;
+					break;
+			}
+		}
+
+		return sp;
 	}
 
-	auto it = ops.begin();
+	/**
+	 * Cache of compiled expressions keyed by the op codes.
+	 * The same expression is evaluated every time the event command runs.
+	 */
+	class ExpressionCache {
+	public:
+		template <typename F>
+		const CompiledExpression& Get(Span<const int32_t> op_codes, F&& compile) {
+			const size_t hash = std::hash<std::string_view>()(std::string_view(
+				reinterpret_cast<const char*>(op_codes.data()), op_codes.size() * sizeof(int32_t)));
+
+			auto range = cache.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it) {
+				const auto& key = it->second.first;
+				if (std::equal(key.begin(), key.end(), op_codes.begin(), op_codes.end())) {
+					return it->second.second;
+				}
+			}
 
-	std::vector<int32_t> results;
+			if (cache.size() >= max_entries) {
+				// Games have a limited number of expressions, this only
+				// triggers when expressions are generated at runtime
+				cache.clear();
+			}
 
-	while (true) {
-		results.push_back(Process(it, ops.end(), interpreter));
+			auto it = cache.emplace(hash, std::make_pair(
+				std::vector<int32_t>(op_codes.begin(), op_codes.end()), compile(op_codes)));
+			return it->second.second;
+		}
 
-		if (it == ops.end() || static_cast<Op>(*it) == Op::Null) {
-			break;
+		void Clear() {
+			cache.clear();
 		}
+
+	private:
+		static constexpr size_t max_entries = 4096;
+
+		std::unordered_multimap<size_t, std::pair<std::vector<int32_t>, CompiledExpression>> cache;
+	};
+
+	ExpressionCache single_cache;
+	ExpressionCache list_cache;
+}
+
+int32_t ManiacPatch::ParseExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
+	const auto& expr = single_cache.Get(op_codes, [](Span<const int32_t> op_codes) {
+		return ExpressionCompiler(op_codes).CompileSingle();
+	});
+
+	std::array<int32_t, 32> small_stack;
+	std::vector<int32_t> large_stack;
+	int32_t* stack = small_stack.data();
+	if (expr.max_depth > static_cast<int>(small_stack.size())) {
+		large_stack.resize(expr.max_depth);
+		stack = large_stack.data();
 	}
 
+	Evaluate(expr, interpreter, stack);
+	return stack[0];
+}
+
+std::vector<int32_t> ManiacPatch::ParseExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
+	const auto& expr = list_cache.Get(op_codes, [](Span<const int32_t> op_codes) {
+		return ExpressionCompiler(op_codes).CompileList();
+	});
+
+	std::vector<int32_t> results(expr.max_depth);
+	results.resize(Evaluate(expr, interpreter, results.data()));
 	return results;
 }
 
+void ManiacPatch::ClearExpressionCache() {
+	single_cache.Clear();
+	list_cache.Clear();
+}
+
 std::array<bool, 50> ManiacPatch::GetKeyRange() {
 	std::array<Input::Keys::InputKey, 50> keys = {
 		Input::Keys::A,
@@ -28,9 +28,31 @@
 class Game_BaseInterpreterContext;
 
 namespace ManiacPatch {
+	/**
+	 * Evaluates the first expression of the op codes.
+	 * The op codes are compiled on first use and cached.
+	 *
+	 * @param op_codes expression op codes of the event command
+	 * @param interpreter interpreter executing the expression
+	 * @return result of the expression
+	 */
 	int32_t ParseExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter);
+
+	/**
+	 * Evaluates all expressions of the op codes.
+	 * The op codes are compiled on first use and cached.
+	 *
+	 * @param op_codes expression op codes of the event command
+	 * @param interpreter interpreter executing the expressions
+	 * @return results of the expressions
+	 */
 	std::vector<int32_t> ParseExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter);
 
+	/**
+	 * Frees all cached compiled expressions.
+	 */
+	void ClearExpressionCache();
+
 	std::array<bool, 50> GetKeyRange();
 
 	bool CheckString(std::string_view str_l, std::string_view str_r, int op, bool ignore_case);
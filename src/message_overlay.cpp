@@ -29,6 +29,16 @@ MessageOverlay::MessageOverlay() : Drawable(Priority_Overlay, Drawable::Flags::G
 	// Graphics::RegisterDrawable is in the Update function
 }
 
+bool MessageOverlay::GetDamageState(DamageState& state) const {
+	if (!IsAnyMessageVisible() && !show_all) {
+		return true;
+	}
+
+	state.rect = Rect(ox, oy, bitmap->GetWidth(), bitmap->GetHeight());
+	state.Hash(bitmap.get()).Hash(bitmap->GetRevision());
+	return true;
+}
+
 void MessageOverlay::Draw(Bitmap& dst) {
 	if (!IsAnyMessageVisible() && !show_all) {
 		// Don't render overlay when no message visible
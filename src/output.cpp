@@ -103,6 +103,9 @@ namespace {
 
 	LogCallbackFn log_cb = LogCallback;
 	LogCallbackUserData log_cb_udata = nullptr;
+
+	/** Messages of this thread go here instead of the log when set */
+	thread_local std::vector<Output::LogMessage>* log_buffer = nullptr;
 }
 
 std::string Output::LogLevelToString(LogLevel lvl) {
@@ -136,6 +139,11 @@ void Output::SetLogCallback(LogCallbackFn fn, LogCallbackUserData userdata) {
 }
 
 static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Color()) {
+	if (log_buffer) {
+		log_buffer->push_back({ lvl, msg });
+		return;
+	}
+
 // skip writing log file
 #ifndef EMSCRIPTEN
 	std::string prefix = Output::LogLevelToString(lvl) + ": ";
@@ -269,6 +277,16 @@ void Output::ToggleLog() {
 }
 
 void Output::ErrorStr(std::string const& err) {
+	if (log_buffer) {
+		// A worker thread cannot continue and must not touch the log file,
+		// the overlay or the display of the main thread
+		for (const auto& m: *log_buffer) {
+			std::cerr << LogLevelToString(m.lvl) << ": " << m.msg << '\n';
+		}
+		std::cerr << "Error: " << err << std::endl;
+		std::_Exit(EXIT_FAILURE);
+	}
+
 	WriteLog(LogLevel::Error, err);
 	std::string error = "Error:\n" + err + "\n\nEasyRPG Player will close now.";
 
@@ -321,3 +339,29 @@ void Output::DebugStr(std::string const& msg) {
 	}
 	WriteLog(LogLevel::Debug, msg, Color(128, 128, 128, 255));
 }
+
+Output::LogBuffer::LogBuffer(std::vector<LogMessage>& messages) : prev(log_buffer) {
+	log_buffer = &messages;
+}
+
+Output::LogBuffer::~LogBuffer() {
+	log_buffer = prev;
+}
+
+void Output::WriteMessages(const std::vector<LogMessage>& messages) {
+	for (const auto& m: messages) {
+		switch (m.lvl) {
+			case LogLevel::Error:
+				ErrorStr(m.msg);
+			case LogLevel::Warning:
+				WarningStr(m.msg);
+				break;
+			case LogLevel::Info:
+				InfoStr(m.msg);
+				break;
+			case LogLevel::Debug:
+				DebugStr(m.msg);
+				break;
+		}
+	}
+}
@@ -21,6 +21,7 @@
 // Headers
 #include <string>
 #include <iosfwd>
+#include <vector>
 #include <fmt/format.h>
 #include "filesystem_stream.h"
 
@@ -184,6 +185,40 @@ namespace Output {
 	 * @param msg formatted debug text to display.
 	 */
 	void DebugStr(std::string const& msg);
+
+	/** A message recorded by a LogBuffer */
+	struct LogMessage {
+		LogLevel lvl;
+		std::string msg;
+	};
+
+	/**
+	 * While alive, the messages logged by the current thread are appended to
+	 * a list instead of being written. Writing the log is not thread safe,
+	 * worker threads use this and hand the messages to the main thread which
+	 * writes them with WriteMessages.
+	 * Errors cannot be deferred, they still terminate the Player.
+	 */
+	class LogBuffer {
+	public:
+		/** @param messages list the messages are appended to */
+		explicit LogBuffer(std::vector<LogMessage>& messages);
+		~LogBuffer();
+
+		LogBuffer(const LogBuffer&) = delete;
+		LogBuffer& operator=(const LogBuffer&) = delete;
+
+	private:
+		std::vector<LogMessage>* prev;
+	};
+
+	/**
+	 * Writes messages recorded by a LogBuffer.
+	 * Must be called from the main thread.
+	 *
+	 * @param messages messages to write
+	 */
+	void WriteMessages(const std::vector<LogMessage>& messages);
 }
 
 template <typename FmtStr, typename... Args>
@@ -29,6 +29,20 @@ Plane::Plane() : Drawable(0)
 	DrawableMgr::Register(this);
 }
 
+bool Plane::GetDamageState(DamageState& state) const {
+	if (!bitmap) {
+		return true;
+	}
+
+	// Scrolling changes the ox/oy offsets and invalidates the whole screen
+	state.rect = Rect(0, 0, Player::screen_width, Player::screen_height);
+	state.Hash(bitmap.get()).Hash(bitmap->GetRevision()).Hash(tone_effect)
+		.Hash(ox - GetRenderOx()).Hash(oy - GetRenderOy())
+		.Hash(Main_Data::game_screen->GetShakeOffsetX()).Hash(Main_Data::game_screen->GetShakeOffsetY())
+		.Hash(Game_Map::LoopHorizontal()).Hash(Game_Map::GetDisplayX()).Hash(Game_Map::GetTilesX());
+	return true;
+}
+
 void Plane::Draw(Bitmap& dst) {
 	if (!bitmap) return;
 
@@ -89,6 +89,13 @@ namespace Platform {
 		/** @return Filesize or -1 on error */
 		int64_t GetSize() const;
 
+		/**
+		 * The unit depends on the platform, only use it to detect modifications.
+		 *
+		 * @return Time of the last modification or -1 on error or when not supported
+		 */
+		int64_t GetModificationTime() const;
+
 		/**
 		 * Creates a directory recursively at the filename path.
 		 * @param follow_symlinks Whether to follow symlinks (if supported on this platform)
@@ -0,0 +1,83 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "ui.h"
+#include "bitmap.h"
+
+#ifdef SUPPORT_AUDIO
+#include "audio.h"
+
+AudioInterface& HeadlessUi::GetAudio() {
+	return *audio_;
+}
+#endif
+
+HeadlessUi::HeadlessUi(int width, int height, const Game_Config& cfg) : BaseUi(cfg)
+{
+	current_display_mode.width = width;
+	current_display_mode.height = height;
+	current_display_mode.bpp = 32;
+
+	// Nothing is presented, the main loop must never wait for the display
+	SetFrameRateSynchronized(true);
+
+	const DynamicFormat format(
+		32,
+		0x00FF0000,
+		0x0000FF00,
+		0x000000FF,
+		0xFF000000,
+		PF::NoAlpha);
+
+	Bitmap::SetFormat(Bitmap::ChooseFormat(format));
+
+	main_surface = Bitmap::Create(current_display_mode.width,
+		current_display_mode.height,
+		false,
+		current_display_mode.bpp
+	);
+
+#ifdef SUPPORT_AUDIO
+	audio_ = std::make_unique<EmptyAudio>(cfg.audio);
+#endif
+}
+
+bool HeadlessUi::ProcessEvents() {
+	// No window, no events. Input is provided by the replay log.
+	return true;
+}
+
+bool HeadlessUi::vChangeDisplaySurfaceResolution(int new_width, int new_height) {
+	BitmapRef new_main_surface = Bitmap::Create(new_width, new_height, false, current_display_mode.bpp);
+
+	if (!new_main_surface) {
+		return false;
+	}
+
+	main_surface = new_main_surface;
+
+	current_display_mode.width = new_width;
+	current_display_mode.height = new_height;
+
+	return true;
+}
+
+void HeadlessUi::vGetConfig(Game_ConfigVideo& cfg) const {
+	cfg.renderer.Lock("Headless (Software)");
+	cfg.game_resolution.SetOptionVisible(true);
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_PLATFORM_HEADLESS_UI_H
+#define EP_PLATFORM_HEADLESS_UI_H
+
+// Headers
+#include "baseui.h"
+
+/**
+ * HeadlessUi class.
+ *
+ * Renders into an offscreen surface that is never presented and has no audio
+ * output. Used for benchmarking and automated runs without a display.
+ */
+class HeadlessUi final : public BaseUi {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param width surface width.
+	 * @param height surface height.
+	 * @param cfg config options
+	 */
+	HeadlessUi(int width, int height, const Game_Config& cfg);
+
+	/**
+	 * Inherited from BaseUi.
+	 */
+	/** @{ */
+	void UpdateDisplay() override {}
+	bool ProcessEvents() override;
+	void vGetConfig(Game_ConfigVideo& cfg) const override;
+	bool vChangeDisplaySurfaceResolution(int new_width, int new_height) override;
+
+#ifdef SUPPORT_AUDIO
+	AudioInterface& GetAudio() override;
+#endif
+	/** @} */
+
+private:
+#ifdef SUPPORT_AUDIO
+	std::unique_ptr<AudioInterface> audio_;
+#endif
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include <cstring>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <memory>
 
 #ifdef _WIN32
@@ -83,6 +84,9 @@
 #include "message_overlay.h"
 #include "audio_midi.h"
 #include "maniac_patch.h"
+#include "frame_stats.h"
+#include "battle_simulator.h"
+#include "platform/headless/ui.h"
 
 #if defined(__ANDROID__) && !defined(USE_LIBRETRO)
 #include "platform/android/android.h"
@@ -129,6 +133,10 @@ namespace Player {
 	int frames;
 	std::string replay_input_path;
 	std::string record_input_path;
+	int benchmark_frames = 0;
+	int simulate_battles = 0;
+	int simulate_jobs = 1;
+	std::string trace_output_path;
 	std::string command_line;
 	int rng_seed = -1;
 	Game_ConfigPlayer player_config;
@@ -148,6 +156,8 @@ namespace {
 	FileRequestBinding system_request_id;
 	FileRequestBinding save_request_id;
 	FileRequestBinding map_request_id;
+
+	FrameStats benchmark_stats;
 }
 
 void Player::Init(std::vector<std::string> args) {
@@ -193,7 +203,11 @@ void Player::Init(std::vector<std::string> args) {
 	DisplayUi.reset();
 
 	if(! DisplayUi) {
-		DisplayUi = BaseUi::CreateUi(Player::screen_width, Player::screen_height, cfg);
+		if (benchmark_frames > 0 || simulate_battles > 0) {
+			DisplayUi = std::make_shared<HeadlessUi>(Player::screen_width, Player::screen_height, cfg);
+		} else {
+			DisplayUi = BaseUi::CreateUi(Player::screen_width, Player::screen_height, cfg);
+		}
 	}
 
 	Input::Init(cfg.input, replay_input_path, record_input_path);
@@ -201,6 +215,21 @@ void Player::Init(std::vector<std::string> args) {
 
 	player_config = std::move(cfg.player);
 
+	const std::pair<Cache::Category, const RangeConfigParam<int>&> cache_budgets[] = {
+		{ Cache::Category::Charset, player_config.cache_budget_charset },
+		{ Cache::Category::Chipset, player_config.cache_budget_chipset },
+		{ Cache::Category::Tile, player_config.cache_budget_tile },
+		{ Cache::Category::Panorama, player_config.cache_budget_panorama },
+		{ Cache::Category::Picture, player_config.cache_budget_picture },
+		{ Cache::Category::SpriteEffect, player_config.cache_budget_sprite_effect },
+		{ Cache::Category::Other, player_config.cache_budget_other }
+	};
+	for (const auto& [category, budget]: cache_budgets) {
+		if (budget.Get() > 0) {
+			Cache::SetBudget(category, static_cast<size_t>(budget.Get()) * 1024);
+		}
+	}
+
 	last_auto_screenshot = Game_Clock::now();
 }
 
@@ -219,8 +248,16 @@ void Player::Run() {
 	// emscripten implemented in main.cpp
 	// libretro invokes the MainLoop through a retro_run-callback
 #else
-	while (Transition::instance().IsActive() || (Scene::instance && Scene::instance->type != Scene::Null)) {
-		MainLoop();
+	if (benchmark_frames > 0) {
+		benchmark_stats.Reserve(benchmark_frames);
+		while (Transition::instance().IsActive() || (Scene::instance && Scene::instance->type != Scene::Null)) {
+			BenchmarkLoop();
+		}
+		benchmark_stats.Print(std::cout);
+	} else {
+		while (Transition::instance().IsActive() || (Scene::instance && Scene::instance->type != Scene::Null)) {
+			MainLoop();
+		}
 	}
 #endif
 }
@@ -294,6 +331,46 @@ void Player::MainLoop() {
 	}
 }
 
+void Player::BenchmarkLoop() {
+	Instrumentation::FrameScope iframe;
+
+	Game_Clock::OnNextFrame(Game_Clock::now());
+
+	Player::UpdateInput();
+
+	if (!DisplayUi->ProcessEvents()) {
+		Scene::PopUntil(Scene::Null);
+		Player::Exit();
+		return;
+	}
+
+	// Frame pacing is ignored: Always run a single logical frame to stay in sync with the input log
+	const auto update_begin = Game_Clock::now();
+
+	Scene::old_instances.clear();
+	Scene::instance->MainFunction();
+
+	Graphics::GetMessageOverlay().Update();
+
+	const auto draw_begin = Game_Clock::now();
+
+	Player::Draw();
+
+	benchmark_stats.Add(draw_begin - update_begin, Game_Clock::now() - draw_begin);
+
+	Scene::old_instances.clear();
+
+	if (!Transition::instance().IsActive() && Scene::instance->type == Scene::Null) {
+		Exit();
+		return;
+	}
+
+	if (benchmark_stats.GetNumFrames() >= benchmark_frames) {
+		Scene::PopUntil(Scene::Null);
+		Exit();
+	}
+}
+
 void Player::Pause() {
 	Audio().BGM_Pause();
 }
@@ -409,6 +486,16 @@ void Player::Exit() {
 		Scene_Settings::SaveConfig(true);
 	}
 
+	if (!trace_output_path.empty()) {
+		auto trace_stream = FileFinder::Root().OpenOutputStream(trace_output_path, std::ios_base::out | std::ios_base::trunc);
+		if (trace_stream) {
+			Instrumentation::WriteChromeTrace(trace_stream);
+			Output::Debug("Instrumentation trace written to {}", trace_output_path);
+		} else {
+			Output::Warning("Failed to write instrumentation trace to {}", trace_output_path);
+		}
+	}
+
 	Graphics::UpdateSceneCallback();
 #ifdef EMSCRIPTEN
 	BitmapRef surface = DisplayUi->GetDisplaySurface();
@@ -633,6 +720,35 @@ Game_Config Player::ParseCommandLine() {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--benchmark-frames")) {
+			if (arg.ParseValue(0, li_value) && li_value > 0) {
+				benchmark_frames = li_value;
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--simulate-battles")) {
+			if (arg.ParseValue(0, li_value) && li_value > 0) {
+				simulate_battles = li_value;
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--jobs")) {
+			if (arg.ParseValue(0, li_value) && li_value > 0) {
+				simulate_jobs = li_value;
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--record-trace")) {
+			if (arg.NumValues() > 0) {
+				trace_output_path = arg.Value(0);
+				Instrumentation::SetRecording(true);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--show-timings")) {
+			Instrumentation::SetRecording(true);
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--encoding")) {
 			if (arg.NumValues() > 0) {
 				forced_encoding = arg.Value(0);
@@ -687,6 +803,12 @@ Game_Config Player::ParseCommandLine() {
 		cp.SkipNext();
 	}
 
+	if (simulate_battles > 0 && !Game_Battle::battle_test.enabled) {
+		// Would start the game without a display otherwise
+		std::cerr << "--simulate-battles requires --battle-test" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
 	return cfg;
 }
 
@@ -921,6 +1043,7 @@ void Player::RestoreBaseResolution() {
 void Player::ResetGameObjects() {
 	// The init order is important
 	ManiacPatch::GlobalSave::Save(true);
+	ManiacPatch::ClearExpressionCache();
 
 	Main_Data::Cleanup();
 
@@ -1321,6 +1444,25 @@ void Player::SetupBattleTest() {
 		Main_Data::game_party->SetupBattleTest();
 	}
 
+	if (simulate_battles > 0) {
+		Game_Battle::SetTerrainId(args.terrain_id);
+		Game_Battle::SetBattleCondition(args.condition);
+		Game_Battle::SetBattleFormation(args.formation);
+
+		BattleSimulator::Config config;
+		config.troop_id = args.troop_id;
+		config.num_battles = simulate_battles;
+		config.jobs = simulate_jobs;
+		// The battles only depend on this seed, passing it to --seed repeats the run
+		config.seed = rng_seed > 0 ? rng_seed : Rand::GetRandomNumber(1, std::numeric_limits<int32_t>::max());
+		config.autobattle_algo = player_config.autobattle_algo.Get();
+		config.enemyai_algo = player_config.enemyai_algo.Get();
+
+		BattleSimulator::Run(config).Print(std::cout);
+		Scene::PopUntil(Scene::Null);
+		return;
+	}
+
 	Scene::Push(Scene_Battle::Create(std::move(args)), true);
 }
 
@@ -1552,8 +1694,23 @@ Debug options:
                       Providing a single N sets the monster party.
                       Providing four N sets: monster party, formation,
                       condition and terrain ID.
+ --benchmark-frames N Run N frames without display, audio and frame limit and
+                      print update and draw time percentiles on exit.
+                      Use with --replay-input and --seed for reproducible runs.
  --hide-title         Hide the title background image and center the command
                       menu.
+ --jobs N             Split the battles of --simulate-battles across N worker
+                      processes (Linux, BSD and macOS only).
+ --record-trace FILE  Record the time spent in engine subsystems and write it to
+                      FILE on exit. The file uses the Chrome trace event format
+                      and can be opened in chrome://tracing or Perfetto.
+ --show-timings       Show the time spent per frame in engine subsystems below
+                      the FPS counter (requires --show-fps).
+ --simulate-battles N Run N battles of the battle test without display and
+                      audio as fast as possible and print the battles per
+                      second and the outcomes. Actors use auto battle.
+                      Requires --battle-test. The printed seed repeats the
+                      run when passed to --seed.
  --start-map-id N     Overwrite the map used for new games and use MapN.lmu
                       instead (N is padded to four digits).
                       Incompatible with --load-game-id.
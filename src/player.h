@@ -77,6 +77,13 @@ namespace Player {
 	 */
 	void MainLoop();
 
+	/**
+	 * Runs the game loop in benchmark mode.
+	 * Exactly one logical frame is executed per call without any frame limiting
+	 * and the time spent in update and draw is recorded.
+	 */
+	void BenchmarkLoop();
+
 	/**
 	 * Pauses the game engine.
 	 */
@@ -400,6 +407,18 @@ namespace Player {
 	/** Path to record input log to */
 	extern std::string record_input_path;
 
+	/** Amount of frames to run in benchmark mode, 0 when disabled */
+	extern int benchmark_frames;
+
+	/** Amount of battles to simulate instead of the battle test, 0 when disabled */
+	extern int simulate_battles;
+
+	/** Worker processes running the simulated battles */
+	extern int simulate_jobs;
+
+	/** Path to write the instrumentation trace to on exit */
+	extern std::string trace_output_path;
+
 	/** The concatenated command line */
 	extern std::string command_line;
 
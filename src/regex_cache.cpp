@@ -0,0 +1,101 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers
+#include "regex_cache.h"
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <fmt/format.h>
+
+namespace {
+	using Key = std::pair<std::wstring, RegexCache::Flags>;
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const {
+			return std::hash<std::wstring>()(key.first) ^ (static_cast<size_t>(key.second) * 31);
+		}
+	};
+
+	struct Item {
+		Key key;
+		std::shared_ptr<const std::wregex> regex;
+	};
+
+	// Most recently used pattern in front
+	std::list<Item> lru;
+	std::unordered_map<Key, std::list<Item>::iterator, KeyHash> items;
+	size_t capacity = RegexCache::default_capacity;
+	RegexCache::Stats stats;
+
+	void Trim() {
+		while (lru.size() > capacity) {
+			items.erase(lru.back().key);
+			lru.pop_back();
+			++stats.evictions;
+		}
+	}
+}
+
+std::shared_ptr<const std::wregex> RegexCache::Get(const std::wstring& pattern, Flags flags) {
+	Key key(pattern, flags);
+
+	auto it = items.find(key);
+	if (it != items.end()) {
+		++stats.hits;
+		lru.splice(lru.begin(), lru, it->second);
+		return it->second->regex;
+	}
+
+	++stats.misses;
+	// Throws on invalid patterns before anything is inserted
+	auto regex = std::make_shared<const std::wregex>(pattern, flags);
+	if (capacity == 0) {
+		return regex;
+	}
+
+	lru.push_front({ key, regex });
+	items.emplace(std::move(key), lru.begin());
+	Trim();
+
+	return regex;
+}
+
+void RegexCache::SetCapacity(size_t new_capacity) {
+	capacity = new_capacity;
+	Trim();
+}
+
+RegexCache::Stats RegexCache::GetStats() {
+	Stats result = stats;
+	result.items = static_cast<int>(lru.size());
+	result.capacity = capacity;
+	return result;
+}
+
+std::string RegexCache::GetStatsReport() {
+	const auto& result = GetStats();
+	return fmt::format("Regex: {}/{} items\n Hit {} Miss {} Evict {}\n",
+		result.items, result.capacity, result.hits, result.misses, result.evictions);
+}
+
+void RegexCache::Clear() {
+	items.clear();
+	lru.clear();
+	stats = {};
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_REGEX_CACHE_H
+#define EP_REGEX_CACHE_H
+
+// Headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <regex>
+#include <string>
+
+/**
+ * Bounded cache of compiled regular expressions used by the string commands.
+ *
+ * Event code usually runs the same few patterns every frame, compiling them
+ * again on every call dominated the cost of the match itself.
+ * Patterns are keyed by the pattern string and the syntax flags, the least
+ * recently used pattern is dropped when the cache is full.
+ * Only used from the main thread.
+ */
+namespace RegexCache {
+	using Flags = std::regex_constants::syntax_option_type;
+
+	/** Default number of cached patterns */
+	constexpr size_t default_capacity = 64;
+
+	/**
+	 * Returns the compiled regular expression of the pattern.
+	 * The returned expression stays valid after it was evicted.
+	 *
+	 * @param pattern regular expression
+	 * @param flags syntax flags of the expression
+	 * @return compiled expression
+	 * @throws std::regex_error when the pattern is invalid, invalid patterns
+	 * are not cached
+	 */
+	std::shared_ptr<const std::wregex> Get(const std::wstring& pattern, Flags flags = std::regex_constants::ECMAScript);
+
+	/**
+	 * Sets the maximum number of cached patterns.
+	 * Excess patterns are evicted immediately.
+	 *
+	 * @param capacity maximum number of patterns, 0 disables the cache
+	 */
+	void SetCapacity(size_t capacity);
+
+	/** Usage counters of the cache */
+	struct Stats {
+		/** Number of cached patterns */
+		int items = 0;
+		/** Maximum number of cached patterns */
+		size_t capacity = 0;
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+	};
+
+	/** @return usage counters of the cache */
+	Stats GetStats();
+
+	/** @return a usage report of the cache */
+	std::string GetStatsReport();
+
+	/** Removes all patterns and resets the counters */
+	void Clear();
+}
+
+#endif
@@ -19,19 +19,79 @@
 #include <array>
 #include <cassert>
 #include <cstring>
+#include <tuple>
 #include "rtp.h"
 
-static std::pair<int, int> get_table_idx(const char* const lookup_table[16], const int lookup_table_idx[16], std::string_view category) {
-	int i;
-
-	for (i = 0; lookup_table[i] != nullptr; ++i) {
+static int get_category(const char* const lookup_table[16], std::string_view category) {
+	for (int i = 0; lookup_table[i] != nullptr; ++i) {
 		if (std::string_view(lookup_table[i]) == category) {
-			return {lookup_table_idx[i], lookup_table_idx[i+1]};
+			return i;
+		}
+	}
+	return -1;
+}
+
+namespace {
+	/** Asset name of an RTP table cell */
+	struct IndexEntry {
+		std::string_view name;
+		int row;
+		int column;
+
+		bool operator<(const IndexEntry& other) const {
+			return std::tie(name, row, column) < std::tie(other.name, other.row, other.column);
+		}
+	};
+
+	/** Per category all names of the table, sorted by name and then by table position */
+	using TableIndex = std::vector<std::vector<IndexEntry>>;
+}
+
+template <typename T>
+static TableIndex make_table_index(T rtp_table, const char* const lookup_table[16], const int lookup_table_idx[16], int num_rtps) {
+	TableIndex index;
+
+	for (int c = 0; lookup_table[c] != nullptr; ++c) {
+		auto& entries = index.emplace_back();
+		for (int i = lookup_table_idx[c]; i < lookup_table_idx[c+1]; ++i) {
+			for (int j = 1; j <= num_rtps; ++j) {
+				const char* name = rtp_table[i][j];
+				if (name != nullptr) {
+					entries.push_back({name, i, j});
+				}
+			}
 		}
+		std::sort(entries.begin(), entries.end());
 	}
 
-	// Points at nullptr (final row) in the rtp table
-	return {lookup_table_idx[i], lookup_table_idx[i]};
+	return index;
+}
+
+/**
+ * @return All cells of the category with the given name, in table order
+ */
+static Span<const IndexEntry> find_in_index(const TableIndex& index, int category, std::string_view name) {
+	if (category < 0) {
+		return {};
+	}
+
+	const auto& entries = index[category];
+	auto it = std::lower_bound(entries.begin(), entries.end(), IndexEntry{name, -1, -1});
+	auto end = it;
+	while (end != entries.end() && end->name == name) {
+		++end;
+	}
+	return {entries.data() + (it - entries.begin()), static_cast<size_t>(end - it)};
+}
+
+static const TableIndex& get_table_index_2k() {
+	static const TableIndex index = make_table_index(RTP::rtp_table_2k, RTP::rtp_table_2k_categories, RTP::rtp_table_2k_categories_idx, RTP::num_2k_rtps);
+	return index;
+}
+
+static const TableIndex& get_table_index_2k3() {
+	static const TableIndex index = make_table_index(RTP::rtp_table_2k3, RTP::rtp_table_2k3_categories, RTP::rtp_table_2k3_categories_idx, RTP::num_2k3_rtps);
+	return index;
 }
 
 template <typename T>
@@ -126,18 +186,12 @@ std::vector<RTP::RtpHitInfo> RTP::Detect(const FilesystemView& fs, int version,
 	return hit_list;
 }
 
-template <typename T>
-static std::vector<RTP::Type> lookup_any_to_rtp_helper(T rtp_table, const std::pair<int, int>& range,
-		std::string_view src_name, int num_rtps, int offset) {
+static std::vector<RTP::Type> lookup_any_to_rtp_helper(const TableIndex& index, int category,
+		std::string_view src_name, int offset) {
 	std::vector<RTP::Type> type_hits;
 
-	for (int i = range.first; i < range.second; ++i) {
-		for (int j = 1; j <= num_rtps; ++j) {
-			const char* name = rtp_table[i][j];
-			if (name != nullptr && src_name == std::string_view(name)) {
-				type_hits.push_back((RTP::Type)(j - 1 + offset));
-			}
-		}
+	for (const auto& entry: find_in_index(index, category, src_name)) {
+		type_hits.push_back((RTP::Type)(entry.column - 1 + offset));
 	}
 
 	return type_hits;
@@ -145,22 +199,21 @@ static std::vector<RTP::Type> lookup_any_to_rtp_helper(T rtp_table, const std::p
 
 std::vector<RTP::Type> RTP::LookupAnyToRtp(std::string_view src_category, std::string_view src_name, int version) {
 	if (version == 2000) {
-		auto tbl_idx = get_table_idx(rtp_table_2k_categories, rtp_table_2k_categories_idx, src_category);
-		return lookup_any_to_rtp_helper(rtp_table_2k, tbl_idx, src_name, num_2k_rtps, 0);
+		int category = get_category(rtp_table_2k_categories, src_category);
+		return lookup_any_to_rtp_helper(get_table_index_2k(), category, src_name, 0);
 	} else {
-		auto tbl_idx = get_table_idx(rtp_table_2k3_categories, rtp_table_2k3_categories_idx, src_category);
-		return lookup_any_to_rtp_helper(rtp_table_2k3, tbl_idx, src_name, num_2k3_rtps, num_2k_rtps);
+		int category = get_category(rtp_table_2k3_categories, src_category);
+		return lookup_any_to_rtp_helper(get_table_index_2k3(), category, src_name, num_2k_rtps);
 	}
 }
 
 template <typename T>
-static std::string lookup_rtp_to_rtp_helper(T rtp_table, const std::pair<int, int>& range,
+static std::string lookup_rtp_to_rtp_helper(T rtp_table, const TableIndex& index, int category,
 		std::string_view src_name, int src_index, int dst_index, bool* is_rtp_asset) {
 
-	for (int i = range.first; i < range.second; ++i) {
-		const char* name = rtp_table[i][src_index + 1];
-		if (name != nullptr && src_name == std::string_view(name)) {
-			const char* dst_name = rtp_table[i][dst_index + 1];
+	for (const auto& entry: find_in_index(index, category, src_name)) {
+		if (entry.column == src_index + 1) {
+			const char* dst_name = rtp_table[entry.row][dst_index + 1];
 
 			if (is_rtp_asset) {
 				*is_rtp_asset = true;
@@ -192,10 +245,10 @@ std::string RTP::LookupRtpToRtp(std::string_view src_category, std::string_view
 	}
 
 	if ((int)src_rtp < num_2k_rtps) {
-		auto tbl_idx = get_table_idx(rtp_table_2k_categories, rtp_table_2k_categories_idx, src_category);
-		return lookup_rtp_to_rtp_helper(rtp_table_2k, tbl_idx, src_name, (int)src_rtp, (int)target_rtp, is_rtp_asset);
+		int category = get_category(rtp_table_2k_categories, src_category);
+		return lookup_rtp_to_rtp_helper(rtp_table_2k, get_table_index_2k(), category, src_name, (int)src_rtp, (int)target_rtp, is_rtp_asset);
 	} else {
-		auto tbl_idx = get_table_idx(rtp_table_2k3_categories, rtp_table_2k3_categories_idx, src_category);
-		return lookup_rtp_to_rtp_helper(rtp_table_2k3, tbl_idx, src_name, (int)src_rtp - num_2k_rtps, (int)target_rtp - num_2k_rtps, is_rtp_asset);
+		int category = get_category(rtp_table_2k3_categories, src_category);
+		return lookup_rtp_to_rtp_helper(rtp_table_2k3, get_table_index_2k3(), category, src_name, (int)src_rtp - num_2k_rtps, (int)target_rtp - num_2k_rtps, is_rtp_asset);
 	}
 }
@@ -0,0 +1,154 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers
+#include "save_title_reader.h"
+#include <string>
+#include <lcf/reader_lcf.h>
+
+namespace {
+	// Chunk IDs of lcf::rpg::Save and lcf::rpg::SaveTitle
+	constexpr uint32_t chunk_save_title = 0x64;
+
+	constexpr uint32_t chunk_timestamp = 0x01;
+	constexpr uint32_t chunk_hero_name = 0x0B;
+	constexpr uint32_t chunk_hero_level = 0x0C;
+	constexpr uint32_t chunk_hero_hp = 0x0D;
+	constexpr uint32_t chunk_face1_name = 0x15;
+	constexpr uint32_t chunk_face1_id = 0x16;
+	constexpr uint32_t chunk_face2_name = 0x17;
+	constexpr uint32_t chunk_face2_id = 0x18;
+	constexpr uint32_t chunk_face3_name = 0x19;
+	constexpr uint32_t chunk_face3_id = 0x1A;
+	constexpr uint32_t chunk_face4_name = 0x1B;
+	constexpr uint32_t chunk_face4_id = 0x1C;
+
+	bool ReadTitle(lcf::LcfReader& reader, uint32_t title_end, lcf::rpg::SaveTitle& title) {
+		lcf::LcfReader::Chunk chunk;
+
+		while (reader.Tell() < title_end) {
+			chunk.ID = reader.ReadInt();
+			if (chunk.ID == 0) {
+				break;
+			}
+			chunk.length = reader.ReadInt();
+
+			const uint32_t chunk_end = reader.Tell() + chunk.length;
+			if (chunk_end > title_end) {
+				return false;
+			}
+
+			switch (chunk.ID) {
+				case chunk_timestamp:
+					reader.Read(title.timestamp);
+					break;
+				case chunk_hero_name:
+					reader.ReadString(title.hero_name, chunk.length);
+					break;
+				case chunk_hero_level:
+					title.hero_level = reader.ReadInt();
+					break;
+				case chunk_hero_hp:
+					title.hero_hp = reader.ReadInt();
+					break;
+				case chunk_face1_name:
+					reader.ReadString(title.face1_name, chunk.length);
+					break;
+				case chunk_face1_id:
+					title.face1_id = reader.ReadInt();
+					break;
+				case chunk_face2_name:
+					reader.ReadString(title.face2_name, chunk.length);
+					break;
+				case chunk_face2_id:
+					title.face2_id = reader.ReadInt();
+					break;
+				case chunk_face3_name:
+					reader.ReadString(title.face3_name, chunk.length);
+					break;
+				case chunk_face3_id:
+					title.face3_id = reader.ReadInt();
+					break;
+				case chunk_face4_name:
+					reader.ReadString(title.face4_name, chunk.length);
+					break;
+				case chunk_face4_id:
+					title.face4_id = reader.ReadInt();
+					break;
+				default:
+					break;
+			}
+
+			// Unknown chunks and chunks with an unexpected length
+			reader.Seek(chunk_end);
+		}
+
+		reader.Seek(title_end);
+		return reader.IsOk();
+	}
+}
+
+std::unique_ptr<lcf::rpg::SaveTitle> SaveTitleReader::Load(std::istream& filestream, std::string_view encoding) {
+	lcf::LcfReader reader(filestream, std::string(encoding));
+	if (!reader.IsOk()) {
+		return nullptr;
+	}
+
+	reader.Seek(0, lcf::LcfReader::FromEnd);
+	const uint32_t file_size = reader.Tell();
+	reader.Seek(0);
+
+	std::string header;
+	reader.ReadString(header, reader.ReadInt());
+	if (header.length() != 11 || header != "LcfSaveData") {
+		return nullptr;
+	}
+
+	auto title = std::make_unique<lcf::rpg::SaveTitle>();
+
+	// Only the title is parsed. The other blocks are skipped without reading
+	// them, a block ending behind the end of the file means the save is corrupted.
+	lcf::LcfReader::Chunk chunk;
+
+	while (reader.Tell() < file_size) {
+		chunk.ID = reader.ReadInt();
+		if (chunk.ID == 0) {
+			break;
+		}
+		chunk.length = reader.ReadInt();
+
+		const uint32_t chunk_end = reader.Tell() + chunk.length;
+		if (!reader.IsOk() || chunk_end > file_size) {
+			return nullptr;
+		}
+
+		if (chunk.ID == chunk_save_title) {
+			if (!ReadTitle(reader, chunk_end, *title)) {
+				return nullptr;
+			}
+		} else {
+			reader.Seek(chunk_end);
+		}
+	}
+
+	if (!reader.IsOk()) {
+		return nullptr;
+	}
+
+	return title;
+}
@@ -0,0 +1,44 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_SAVE_TITLE_READER_H
+#define EP_SAVE_TITLE_READER_H
+
+// Headers
+#include <istream>
+#include <memory>
+#include <string_view>
+#include <lcf/rpg/savetitle.h>
+
+/**
+ * Reads the title block (party faces, hero name, level and timestamp)
+ * of a savegame without parsing the rest of the file.
+ */
+namespace SaveTitleReader {
+	/**
+	 * Loads the title of a savegame.
+	 * The title is the first block of a LSD file. The remaining blocks are
+	 * only skipped over to check that the file is not truncated.
+	 *
+	 * @param filestream LSD file stream
+	 * @param encoding encoding of the strings in the file
+	 * @return title or nullptr when the file is not a valid savegame
+	 */
+	std::unique_ptr<lcf::rpg::SaveTitle> Load(std::istream& filestream, std::string_view encoding);
+}
+
+#endif
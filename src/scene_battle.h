@@ -133,6 +133,14 @@ public:
 
 	static void SelectionFlash(Game_Battler* battler);
 
+	/**
+	 * Adjusts the action of the battler right before it starts: state
+	 * restrictions force an attack and impossible actions are dropped.
+	 *
+	 * @param battler Battler whose action is about to start.
+	 */
+	static void PrepareBattleAction(Game_Battler* battler);
+
 protected:
 	explicit Scene_Battle(const BattleArgs& args);
 
@@ -160,8 +168,6 @@ protected:
 	 */
 	virtual void ActionSelectedCallback(Game_Battler* for_battler);
 
-	void PrepareBattleAction(Game_Battler* battler);
-
 	void RemoveCurrentAction();
 
 	bool CallDebug();
@@ -29,6 +29,7 @@
 #include "game_map.h"
 #include "game_system.h"
 #include "game_battle.h"
+#include "regex_cache.h"
 #include "scene_debug.h"
 #include "scene_load.h"
 #include "scene_menu.h"
@@ -332,6 +333,17 @@ void Scene_Debug::PushUiInterpreterView() {
 	interpreter_window->Refresh();
 }
 
+void Scene_Debug::PushUiBitmapCacheView() {
+	Push(eUiStringView);
+
+	var_window->SetActive(false);
+	stringview_window->SetActive(true);
+	stringview_window->SetVisible(true);
+
+	stringview_window->SetDisplayData(Cache::GetStatsReport() + RegexCache::GetStatsReport());
+	stringview_window->SetIndex(0);
+	stringview_window->Refresh();
+}
 
 void Scene_Debug::Pop() {
 	range_window->SetActive(false);
@@ -642,6 +654,11 @@ void Scene_Debug::vUpdate() {
 			case eOpenMenu:
 				DoOpenMenu();
 				break;
+			case eBitmapCache:
+				if (sz == 1) {
+					PushUiBitmapCacheView();
+				}
+				break;
 		}
 		Game_Map::SetNeedRefresh(true);
 	} else if (range_window->GetActive() && Input::IsRepeated(Input::RIGHT)) {
@@ -778,6 +795,7 @@ void Scene_Debug::UpdateRangeListWindow() {
 				addItem("Strings", Player::IsPatchManiac());
 				addItem("Interpreter");
 				addItem("Open Menu", !is_battle);
+				addItem("Bitmap Cache");
 			}
 			break;
 		case eSwitch:
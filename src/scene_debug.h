@@ -74,6 +74,7 @@ public:
 		eString,
 		eInterpreter,
 		eOpenMenu,
+		eBitmapCache,
 		eLastMainMenuOption,
 	};
 
@@ -175,6 +176,7 @@ private:
 	void PushUiChoices(std::vector<std::string> choices, std::vector<bool> choices_enabled);
 	void PushUiStringView();
 	void PushUiInterpreterView();
+	void PushUiBitmapCacheView();
 
 	Window_VarList::Mode GetWindowMode() const;
 	static constexpr Window_VarList::Mode GetWindowMode(Mode mode);
@@ -25,8 +25,8 @@
 #include "game_system.h"
 #include "game_party.h"
 #include "input.h"
-#include <lcf/lsd/reader.h>
 #include "player.h"
+#include "save_title_reader.h"
 #include "scene_file.h"
 #include "bitmap.h"
 #include <lcf/reader_util.h>
@@ -76,14 +76,14 @@ void Scene_File::CreateHelpWindow() {
 	help_window->SetZ(Priority_Window + 1);
 }
 
-void Scene_File::PopulatePartyFaces(Window_SaveFile& win, int /* id */, lcf::rpg::Save& savegame) {
-	win.SetParty(savegame.title);
+void Scene_File::PopulatePartyFaces(Window_SaveFile& win, int /* id */, const lcf::rpg::SaveTitle& title) {
+	win.SetParty(title);
 	win.SetHasSave(true);
 }
 
-void Scene_File::UpdateLatestTimestamp(int id, lcf::rpg::Save& savegame) {
-	if (savegame.title.timestamp > latest_time) {
-		latest_time = savegame.title.timestamp;
+void Scene_File::UpdateLatestTimestamp(int id, const lcf::rpg::SaveTitle& title) {
+	if (title.timestamp > latest_time) {
+		latest_time = title.timestamp;
 		latest_slot = id;
 	}
 }
@@ -104,11 +104,12 @@ void Scene_File::PopulateSaveWindow(Window_SaveFile& win, int id) {
 			return;
 		}
 
-		std::unique_ptr<lcf::rpg::Save> savegame = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+		// Only the title is needed for the slot, the full save is parsed on load
+		std::unique_ptr<lcf::rpg::SaveTitle> title = SaveTitleReader::Load(save_stream, Player::encoding);
 
-		if (savegame) {
-			PopulatePartyFaces(win, id, *savegame);
-			UpdateLatestTimestamp(id, *savegame);
+		if (title) {
+			PopulatePartyFaces(win, id, *title);
+			UpdateLatestTimestamp(id, *title);
 		} else {
 			Output::Debug("Save {} corrupted", file);
 			win.SetCorrupted(true);
@@ -129,7 +130,6 @@ void Scene_File::Start() {
 		w->SetIndex(i);
 		w->SetZ(Priority_Window);
 		PopulateSaveWindow(*w, i);
-		w->Refresh();
 
 		file_windows.push_back(w);
 	}
@@ -142,7 +142,7 @@ void Scene_File::Start() {
 	index = latest_slot;
 	top_index = std::max(0, index - 2);
 
-	RefreshWindows();
+	RefreshWindows(top_index);
 
 	for (auto& fw: file_windows) {
 		fw->Update();
@@ -158,12 +158,18 @@ void Scene_File::Start() {
 	extra_commands_window->SetVisible(false);
 }
 
-void Scene_File::RefreshWindows() {
+void Scene_File::RefreshWindows(int old_top_index) {
+	// Three windows fit on the screen
+	int first_visible = std::min(old_top_index, top_index);
+	int last_visible = std::max(old_top_index, top_index) + 2;
+
 	for (int i = 0; i < (int)file_windows.size(); i++) {
 		Window_SaveFile *w = file_windows[i].get();
 		w->SetY(40 + (i - top_index) * 64);
 		w->SetActive(i == index);
-		w->Refresh();
+		if (i >= first_visible && i <= last_visible && w->NeedsRefresh()) {
+			w->Refresh();
+		}
 	}
 }
 
@@ -171,8 +177,8 @@ void Scene_File::Refresh() {
 	for (int i = 0; i < Utils::Clamp<int32_t>(lcf::Data::system.easyrpg_max_savefiles, 3, 99); i++) {
 		Window_SaveFile *w = file_windows[i].get();
 		PopulateSaveWindow(*w, i);
-		w->Refresh();
 	}
+	RefreshWindows(top_index);
 }
 
 void Scene_File::vUpdate() {
@@ -254,7 +260,7 @@ void Scene_File::vUpdate() {
 	//top_index = std::min(top_index, std::max(top_index, index - 3 + 1));
 
 	if (top_index != old_top_index || index != old_index)
-		RefreshWindows();
+		RefreshWindows(old_top_index);
 
 	for (auto& fw: file_windows) {
 		fw->Update();
@@ -55,12 +55,19 @@ public:
 protected:
 	virtual void CreateHelpWindow();
 	virtual void PopulateSaveWindow(Window_SaveFile& win, int id);
-	virtual void PopulatePartyFaces(Window_SaveFile& win, int id, lcf::rpg::Save& savegame);
-	virtual void UpdateLatestTimestamp(int id, lcf::rpg::Save& savegame);
+	virtual void PopulatePartyFaces(Window_SaveFile& win, int id, const lcf::rpg::SaveTitle& title);
+	virtual void UpdateLatestTimestamp(int id, const lcf::rpg::SaveTitle& title);
 	static std::unique_ptr<Sprite> MakeBorderSprite(int y);
 	static std::unique_ptr<Sprite> MakeArrowSprite(bool down);
 
-	void RefreshWindows();
+	/**
+	 * Moves the windows to the current scroll position and redraws the
+	 * windows that are visible while scrolling from old_top_index.
+	 * Windows outside of that range are drawn once they scroll into view.
+	 *
+	 * @param old_top_index top_index before scrolling
+	 */
+	void RefreshWindows(int old_top_index);
 	void MoveFileWindows(int dy, int dt);
 	void UpdateArrows();
 	bool HandleExtraCommandsWindow();
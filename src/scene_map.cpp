@@ -132,6 +132,10 @@ void Scene_Map::Continue(SceneType prev_scene) {
 		Game_Map::OnContinueFromBattle();
 	}
 
+	// Shops, menus and battles change items and party members without
+	// announcing the change, the page refresh only tracks announced changes
+	Game_Map::SetNeedRefresh(true);
+
 	// Player cast Escape / Teleport from menu
 	if (Main_Data::game_player->IsPendingTeleport()) {
 		auto tt = Main_Data::game_player->GetTeleportTarget().GetType();
@@ -305,6 +309,9 @@ void Scene_Map::UpdateSceneCalling() {
 void Scene_Map::StartPendingTeleport(TeleportParams tp) {
 	auto& transition = Transition::instance();
 
+	// Decode the graphics of the next map while the screen is erased
+	Game_Map::PrefetchMap(Main_Data::game_player->GetTeleportTarget().GetMapId());
+
 	if (!transition.IsErasedNotActive() && tp.erase_screen) {
 		transition.InitErase(Main_Data::game_system->GetTransition(Main_Data::game_system->Transition_TeleportErase), this);
 	}
@@ -55,8 +55,8 @@ void Scene_Save::Start() {
 
 	for (int i = 0; i < Utils::Clamp<int32_t>(lcf::Data::system.easyrpg_max_savefiles, 3, 99); i++) {
 		file_windows[i]->SetHasSave(true);
-		file_windows[i]->Refresh();
 	}
+	RefreshWindows(top_index);
 }
 
 void Scene_Save::Action(int index) {
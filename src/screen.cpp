@@ -21,6 +21,7 @@
 #include "color.h"
 #include "game_screen.h"
 #include "main_data.h"
+#include "player.h"
 #include "screen.h"
 #include "drawable_mgr.h"
 
@@ -29,6 +30,15 @@ Screen::Screen() : Drawable(Priority_Screen)
 	DrawableMgr::Register(this);
 }
 
+bool Screen::GetDamageState(DamageState& state) const {
+	auto flash_color = Main_Data::game_screen->GetFlashColor();
+	if (flash_color.alpha > 0 || viewport != Rect()) {
+		state.rect = Rect(0, 0, Player::screen_width, Player::screen_height);
+		state.Hash(flash_color).Hash(viewport);
+	}
+	return true;
+}
+
 void Screen::Draw(Bitmap& dst) {
 	auto flash_color = Main_Data::game_screen->GetFlashColor();
 	if (flash_color.alpha > 0) {
@@ -16,12 +16,15 @@
  */
 
 // Headers
+#include <cmath>
+#include <cstdlib>
 #include <string>
 #include "sprite.h"
 #include "player.h"
 #include "util_macro.h"
 #include "bitmap.h"
 #include "cache.h"
+#include "drawable_list.h"
 #include "drawable_mgr.h"
 
 // Constructor
@@ -32,11 +35,66 @@ Sprite::Sprite(Drawable::Flags flags) : Drawable(0, flags)
 
 // Draw
 void Sprite::Draw(Bitmap& dst) {
+	const auto pass = DrawableList::GetDrawPass();
+	if (draw_pass != pass) {
+		draw_pass = pass;
+		draw_count = 0;
+	}
+	++draw_count;
+
 	if (GetWidth() <= 0 || GetHeight() <= 0) return;
 
 	BlitScreen(dst);
 }
 
+bool Sprite::GetDamageState(DamageState& state) const {
+	if (draw_pass != DrawableList::GetDrawPass() || draw_count == 0) {
+		// Not drawn at all
+		return true;
+	}
+
+	if (draw_count > 1) {
+		// Drawn multiple times with different settings (battle animations and afterimages)
+		return false;
+	}
+
+	if (!bitmap || GetWidth() <= 0 || GetHeight() <= 0 || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0)) {
+		return true;
+	}
+
+	Rect rect = src_rect_effect.GetSubRect(src_rect);
+	const int dst_ox = ox - GetRenderOx();
+	const int dst_oy = oy - GetRenderOy();
+
+	if (angle_effect != 0.0) {
+		// Conservative: Any rotation stays inside the circle around the origin
+		// that contains all corners of the sprite
+		const double dx = std::max(std::abs(dst_ox), std::abs(rect.width - dst_ox)) * std::abs(zoom_x_effect);
+		const double dy = std::max(std::abs(dst_oy), std::abs(rect.height - dst_oy)) * std::abs(zoom_y_effect);
+		const int radius = static_cast<int>(std::ceil(std::sqrt(dx * dx + dy * dy))) + 1;
+		state.rect = Rect(x - radius, y - radius, radius * 2, radius * 2);
+	} else {
+		const int left = x - static_cast<int>(std::floor(dst_ox * zoom_x_effect));
+		const int top = y - static_cast<int>(std::floor(dst_oy * zoom_y_effect));
+		const int width = static_cast<int>(std::ceil(rect.width * zoom_x_effect));
+		const int height = static_cast<int>(std::ceil(rect.height * zoom_y_effect));
+		// The waver effect shifts every line by up to 2 * depth pixels
+		const int waver = static_cast<int>(std::ceil(2 * std::abs(zoom_x_effect * waver_effect_depth)));
+		state.rect = Rect(left - waver - 1, top - 1, width + waver * 2 + 2, height + 2);
+	}
+
+	state.Hash(bitmap.get()).Hash(bitmap->GetRevision())
+		.Hash(src_rect).Hash(src_rect_effect)
+		.Hash(x).Hash(y).Hash(dst_ox).Hash(dst_oy)
+		.Hash(opacity_top_effect).Hash(opacity_bottom_effect).Hash(bush_effect)
+		.Hash(tone_effect).Hash(zoom_x_effect).Hash(zoom_y_effect).Hash(angle_effect)
+		.Hash(blend_type_effect).Hash(blend_color_effect)
+		.Hash(waver_effect_depth).Hash(waver_effect_phase)
+		.Hash(flash_effect).Hash(flipx_effect).Hash(flipy_effect);
+
+	return true;
+}
+
 void Sprite::BlitScreen(Bitmap& dst) {
 	if (!bitmap || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0))
 		return;
@@ -34,6 +34,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamageState(DamageState& state) const override;
+
 	virtual int GetWidth() const;
 	virtual int GetHeight() const;
 
@@ -138,6 +140,10 @@ private:
 	bool current_flip_y = false;
 	bool bitmap_changed = true;
 
+	/** Draw pass of the last Draw() call and how often Draw() was called in it */
+	uint32_t draw_pass = 0;
+	int draw_count = 0;
+
 	void BlitScreen(Bitmap& dst);
 	void BlitScreenIntern(Bitmap& dst, Bitmap const& draw_bitmap,
 							Rect const& src_rect) const;
@@ -0,0 +1,94 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int num_threads) {
+#ifdef HAVE_THREADS
+	for (int i = 0; i < num_threads; ++i) {
+		threads.emplace_back([this]() { Work(); });
+	}
+#else
+	(void)num_threads;
+#endif
+}
+
+ThreadPool::~ThreadPool() {
+#ifdef HAVE_THREADS
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	cv.notify_all();
+
+	for (auto& thread: threads) {
+		thread.join();
+	}
+#endif
+}
+
+int ThreadPool::GetNumThreads() const {
+#ifdef HAVE_THREADS
+	return static_cast<int>(threads.size());
+#else
+	return 0;
+#endif
+}
+
+int ThreadPool::GetDefaultNumThreads() {
+#ifdef HAVE_THREADS
+	// hardware_concurrency is 0 when unknown
+	return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+#else
+	return 0;
+#endif
+}
+
+void ThreadPool::Enqueue(std::function<void()> job) {
+#ifdef HAVE_THREADS
+	if (!threads.empty()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back(std::move(job));
+		}
+		cv.notify_one();
+		return;
+	}
+#endif
+	job();
+}
+
+#ifdef HAVE_THREADS
+void ThreadPool::Work() {
+	for (;;) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv.wait(lock, [this]() { return stop || !jobs.empty(); });
+			if (jobs.empty()) {
+				// stop requested and all work done
+				return;
+			}
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		job();
+	}
+}
+#endif
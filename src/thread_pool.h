@@ -0,0 +1,98 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_THREAD_POOL_H
+#define EP_THREAD_POOL_H
+
+// Headers
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "system.h"
+
+#ifdef HAVE_THREADS
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+#endif
+
+/**
+ * A fixed number of worker threads processing jobs in submission order.
+ *
+ * When the build has no thread support (HAVE_THREADS undefined) or the pool
+ * has zero threads, jobs run synchronously inside Submit.
+ */
+class ThreadPool {
+public:
+	/**
+	 * Starts the worker threads.
+	 *
+	 * @param num_threads amount of worker threads
+	 */
+	explicit ThreadPool(int num_threads);
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/** Finishes all queued jobs and joins the worker threads. */
+	~ThreadPool();
+
+	/**
+	 * Queues a job.
+	 *
+	 * @param f callable without arguments
+	 * @return future receiving the result of f
+	 */
+	template <typename F>
+	std::future<std::invoke_result_t<std::decay_t<F>>> Submit(F&& f);
+
+	/** @return amount of worker threads */
+	int GetNumThreads() const;
+
+	/** @return a thread count for CPU bound work that leaves one core for the main thread */
+	static int GetDefaultNumThreads();
+
+private:
+	void Enqueue(std::function<void()> job);
+
+#ifdef HAVE_THREADS
+	void Work();
+
+	std::vector<std::thread> threads;
+	std::deque<std::function<void()>> jobs;
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool stop = false;
+#endif
+};
+
+template <typename F>
+std::future<std::invoke_result_t<std::decay_t<F>>> ThreadPool::Submit(F&& f) {
+	using R = std::invoke_result_t<std::decay_t<F>>;
+
+	// std::function requires copyable callables
+	auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+	auto result = task->get_future();
+	Enqueue([task]() { (*task)(); });
+	return result;
+}
+
+#endif
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include "tilemap_layer.h"
@@ -209,11 +210,13 @@ TilemapLayer::TilemapLayer(int ilayer) :
 // was created intentionally. Inlining the transparency check was measured and shown
 // to provide a performance improvement
 EP_ALWAYS_INLINE
-void TilemapLayer::DrawTile(Bitmap& dst, Bitmap& tileset, Bitmap& tone_tileset, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit) {
+bool TilemapLayer::DrawTile(Bitmap& dst, Bitmap& tileset, Bitmap& tone_tileset, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit) {
 	auto op = tileset.GetTileOpacity(col, row);
-	if (op != ImageOpacity::Transparent) {
-		DrawTileImpl(dst, tileset, tone_tileset, x, y, row, col, tone_hash, op, allow_fast_blit);
+	if (op == ImageOpacity::Transparent) {
+		return false;
 	}
+	DrawTileImpl(dst, tileset, tone_tileset, x, y, row, col, tone_hash, op, allow_fast_blit);
+	return true;
 }
 
 void TilemapLayer::DrawTileImpl(Bitmap& dst, Bitmap& tileset, Bitmap& tone_tileset, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit) {
@@ -258,6 +261,194 @@ static uint32_t MakeAbTileHash(int id, int anim_step) {
 	return static_cast<uint32_t>((id + (anim_step << 12)) | (4 << 24));
 }
 
+void TilemapLayer::GetAnimationSteps(int& step_c, int& step_ab) const {
+	// FIXME: When Game_Map singleton is made an object we can remove this null check
+	const auto frames = Main_Data::game_system ? static_cast<uint32_t>(Main_Data::game_system->GetFrameCounter()) : 0u;
+	step_c = static_cast<int>((frames / 6) % 4);
+	auto animation_step_ab = frames / animation_speed;
+	if (animation_type) {
+		animation_step_ab %= 3;
+	} else {
+		animation_step_ab %= 4;
+		if (animation_step_ab == 3) {
+			animation_step_ab = 1;
+		}
+	}
+	step_ab = static_cast<int>(animation_step_ab);
+}
+
+bool TilemapLayer::DrawTileData(Bitmap& dst, const TileData& tile, int x, int y, int animation_step_c, int animation_step_ab, bool allow_fast_blit) {
+	if (layer == 0) {
+		// If lower layer
+		allow_fast_blit = allow_fast_blit && (tile.z == TileBelow);
+
+		if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
+			int id = substitutions[tile.ID - BLOCK_E];
+			// If Block E
+
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 96) {
+				// If from first column of the block
+				col = 12 + id % 6;
+				row = id / 6;
+			} else {
+				// If from second column of the block
+				col = 18 + (id - 96) % 6;
+				row = (id - 96) / 6;
+			}
+
+			auto tone_hash = MakeETileHash(id);
+			return DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
+			// If Block C
+
+			// Get the tile coordinates from chipset
+			int col = 3 + (tile.ID - BLOCK_C) / 50;
+			int row = 4 + animation_step_c;
+
+			auto tone_hash = MakeCTileHash(tile.ID, animation_step_c);
+			return DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else if (tile.ID < BLOCK_C) {
+			// If Blocks A1, A2, B
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
+
+			int col = pos.x;
+			int row = pos.y;
+
+			// Create tone changed tile
+			auto tone_hash = MakeAbTileHash(tile.ID,  animation_step_ab);
+			return DrawTile(dst, *autotiles_ab_screen, *autotiles_ab_screen_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else {
+			// If blocks D1-D12
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileD(tile.ID);
+
+			int col = pos.x;
+			int row = pos.y;
+
+			auto tone_hash = MakeDTileHash(tile.ID);
+			return DrawTile(dst, *autotiles_d_screen, *autotiles_d_screen_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		}
+	} else {
+		// If upper layer
+
+		// Check that block F is being drawn
+		if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
+			int id = substitutions[tile.ID - BLOCK_F];
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 48) {
+				// If from first column of the block
+				col = 18 + id % 6;
+				row = 8 + id / 6;
+			} else {
+				// If from second column of the block
+				col = 24 + (id - 48) % 6;
+				row = (id - 48) / 6;
+			}
+
+			auto tone_hash = MakeFTileHash(id);
+			return DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		}
+	}
+	return false;
+}
+
+bool TilemapLayer::IsAnimatedTile(const TileData& tile) const {
+	// Blocks A1, A2, B and C change with every animation step
+	return layer == 0 && tile.ID < BLOCK_D;
+}
+
+TilemapLayer::TileChunk& TilemapLayer::GetChunk(uint8_t z_order, int chunk_x, int chunk_y) {
+	const uint32_t key = (static_cast<uint32_t>(z_order) << 24) | (static_cast<uint32_t>(chunk_y) << 12) | static_cast<uint32_t>(chunk_x);
+
+	auto it = chunks.find(key);
+	if (it == chunks.end()) {
+		if (chunks.size() >= max_cached_chunks) {
+			// Evict the least recently drawn chunk
+			auto lru = std::min_element(chunks.begin(), chunks.end(), [](const auto& l, const auto& r) {
+				return l.second.last_use < r.second.last_use;
+			});
+			chunks.erase(lru);
+		}
+		it = chunks.emplace(key, TileChunk()).first;
+	}
+
+	auto& chunk = it->second;
+	chunk.last_use = chunk_use_counter;
+
+	if (chunk.valid) {
+		return chunk;
+	}
+
+	// Render all static tiles of this z-order into the chunk
+	chunk.valid = true;
+	chunk.animated.clear();
+	chunk.drawn.reset();
+	if (chunk.bitmap) {
+		chunk.bitmap->Clear();
+	}
+
+	const int start_x = chunk_x * CHUNK_SIZE;
+	const int start_y = chunk_y * CHUNK_SIZE;
+	const int end_x = std::min(start_x + CHUNK_SIZE, width);
+	const int end_y = std::min(start_y + CHUNK_SIZE, height);
+
+	for (int map_y = start_y; map_y < end_y; ++map_y) {
+		for (int map_x = start_x; map_x < end_x; ++map_x) {
+			const TileData& tile = GetDataCache(map_x, map_y);
+			if (tile.z != z_order) {
+				continue;
+			}
+
+			if (IsAnimatedTile(tile)) {
+				chunk.animated.push_back({ static_cast<uint8_t>(map_x - start_x), static_cast<uint8_t>(map_y - start_y) });
+				continue;
+			}
+
+			if (!chunk.bitmap) {
+				chunk.bitmap = Bitmap::Create(CHUNK_SIZE * TILE_SIZE, CHUNK_SIZE * TILE_SIZE, true);
+			}
+
+			// Same blit as when drawing the tile to the screen, Draw copies only
+			// the drawn tiles of the chunk when fast blit is enabled
+			const int local_x = map_x - start_x;
+			const int local_y = map_y - start_y;
+			if (DrawTileData(*chunk.bitmap, tile, local_x * TILE_SIZE, local_y * TILE_SIZE, 0, 0, true)) {
+				chunk.drawn.set(local_x + local_y * CHUNK_SIZE);
+			}
+		}
+	}
+
+	return chunk;
+}
+
+void TilemapLayer::InvalidateChunkAt(int x, int y) {
+	if (chunks.empty()) {
+		return;
+	}
+
+	const uint32_t pos = (static_cast<uint32_t>(y / CHUNK_SIZE) << 12) | static_cast<uint32_t>(x / CHUNK_SIZE);
+	for (auto z_order: { TileBelow + layer, TileAbove + layer }) {
+		auto it = chunks.find((static_cast<uint32_t>(z_order) << 24) | pos);
+		if (it != chunks.end()) {
+			it->second.valid = false;
+		}
+	}
+}
+
+void TilemapLayer::InvalidateChunks() {
+	for (auto& chunk: chunks) {
+		chunk.second.valid = false;
+	}
+}
+
 void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_oy) {
 	// Get the number of tiles that can be displayed on window
 	int tiles_x = (int)ceil(Player::screen_width / (float)TILE_SIZE);
@@ -284,18 +475,8 @@ void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_
 		return rem >= 0 ? rem : m + rem;
 	};
 
-	// FIXME: When Game_Map singleton is made an object we can remove this null check
-	const auto frames = Main_Data::game_system ? static_cast<uint32_t>(Main_Data::game_system->GetFrameCounter()) : 0u;
-	auto animation_step_c = (frames / 6) % 4;
-	auto animation_step_ab = frames / animation_speed;
-	if (animation_type) {
-		animation_step_ab %= 3;
-	} else {
-		animation_step_ab %= 4;
-		if (animation_step_ab == 3) {
-			animation_step_ab = 1;
-		}
-	}
+	int animation_step_c, animation_step_ab;
+	GetAnimationSteps(animation_step_c, animation_step_ab);
 
 	const int div_ox = div_rounding_down(ox - render_ox, TILE_SIZE);
 	const int div_oy = div_rounding_down(oy - render_oy, TILE_SIZE);
@@ -303,112 +484,119 @@ void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_
 	const int mod_ox = mod(ox - render_ox, TILE_SIZE);
 	const int mod_oy = mod(oy - render_oy, TILE_SIZE);
 
-	for (int y = 0; y < tiles_y; y++) {
-		for (int x = 0; x < tiles_x; x++) {
+	++chunk_use_counter;
 
-			// Get the real maps tile coordinates
-			int map_x = div_ox + x;
-			int map_y = div_oy + y;
-			if (loop_h) map_x = mod(map_x, width);
-			if (loop_v) map_y = mod(map_y, height);
+	if (tone_tile_draws > 0) {
+		// The tone changed recently, e.g. during a tint fade. Rendering the
+		// chunks again on every frame is slower than drawing the visible tiles.
+		--tone_tile_draws;
 
-			bool out_of_bounds =
-				map_x < 0 || map_x >= width ||
-				map_y < 0 || map_y >= height;
+		for (int y = 0; y < tiles_y; y++) {
+			for (int x = 0; x < tiles_x; x++) {
+				// Get the real maps tile coordinates
+				int map_x = div_ox + x;
+				int map_y = div_oy + y;
+				if (loop_h) map_x = mod(map_x, width);
+				if (loop_v) map_y = mod(map_y, height);
 
-			if (out_of_bounds) {
-				continue;
-			}
-
-			int map_draw_x = x * TILE_SIZE - mod_ox;
-			int map_draw_y = y * TILE_SIZE - mod_oy;
+				if (!IsInMapBounds(map_x, map_y)) {
+					continue;
+				}
 
-			// Get the tile data
-			TileData &tile = GetDataCache(map_x, map_y);
+				const TileData& tile = GetDataCache(map_x, map_y);
+				if (tile.z == z_order) {
+					DrawTileData(dst, tile, x * TILE_SIZE - mod_ox, y * TILE_SIZE - mod_oy, animation_step_c, animation_step_ab, true);
+				}
+			}
+		}
+		return;
+	}
 
-			// Draw the sublayer if its z is being draw now
-			if (z_order == tile.z) {
-				if (layer == 0) {
-					// If lower layer
-					bool allow_fast_blit = (tile.z == TileBelow);
+	// Fast blit copies the lower tiles, including their transparent pixels
+	const bool chunk_fast_blit = fast_blit && layer == 0 && z_order == TileBelow;
 
-					if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
-						int id = substitutions[tile.ID - BLOCK_E];
-						// If Block E
+	if (chipset->GetRevision() != chunk_chipset_revision) {
+		chunk_chipset_revision = chipset->GetRevision();
+		InvalidateChunks();
+	}
 
-						int row, col;
+	// Walk the screen in runs of tiles that belong to the same chunk, this
+	// way every visible chunk is drawn with a single blit
+	for (int y = 0; y < tiles_y;) {
+		int map_y = div_oy + y;
+		if (loop_v) map_y = mod(map_y, height);
 
-						// Get the tile coordinates from chipset
-						if (id < 96) {
-							// If from first column of the block
-							col = 12 + id % 6;
-							row = id / 6;
-						} else {
-							// If from second column of the block
-							col = 18 + (id - 96) % 6;
-							row = (id - 96) / 6;
-						}
+		if (map_y < 0 || map_y >= height) {
+			++y;
+			continue;
+		}
 
-						auto tone_hash = MakeETileHash(id);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
-						// If Block C
+		const int chunk_y = map_y / CHUNK_SIZE;
+		const int run_h = std::min({ tiles_y - y, (chunk_y + 1) * CHUNK_SIZE - map_y, height - map_y });
 
-						// Get the tile coordinates from chipset
-						int col = 3 + (tile.ID - BLOCK_C) / 50;
-						int row = 4 + animation_step_c;
+		for (int x = 0; x < tiles_x;) {
+			int map_x = div_ox + x;
+			if (loop_h) map_x = mod(map_x, width);
 
-						auto tone_hash = MakeCTileHash(tile.ID, animation_step_c);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else if (tile.ID < BLOCK_C) {
-						// If Blocks A1, A2, B
+			if (map_x < 0 || map_x >= width) {
+				++x;
+				continue;
+			}
 
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
+			const int chunk_x = map_x / CHUNK_SIZE;
+			const int run_w = std::min({ tiles_x - x, (chunk_x + 1) * CHUNK_SIZE - map_x, width - map_x });
 
-						int col = pos.x;
-						int row = pos.y;
+			const int map_draw_x = x * TILE_SIZE - mod_ox;
+			const int map_draw_y = y * TILE_SIZE - mod_oy;
 
-						// Create tone changed tile
-						auto tone_hash = MakeAbTileHash(tile.ID,  animation_step_ab);
-						DrawTile(dst, *autotiles_ab_screen, *autotiles_ab_screen_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else {
-						// If blocks D1-D12
+			const auto& chunk = GetChunk(z_order, chunk_x, chunk_y);
 
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileD(tile.ID);
+			const int local_x = map_x - chunk_x * CHUNK_SIZE;
+			const int local_y = map_y - chunk_y * CHUNK_SIZE;
 
-						int col = pos.x;
-						int row = pos.y;
+			if (chunk_fast_blit && chunk.drawn.all()) {
+				Rect src_rect(local_x * TILE_SIZE, local_y * TILE_SIZE, run_w * TILE_SIZE, run_h * TILE_SIZE);
+				dst.BlitFast(map_draw_x, map_draw_y, *chunk.bitmap, src_rect, 255);
+			} else if (chunk_fast_blit && chunk.drawn.any()) {
+				// Copy the drawn tiles in horizontal runs, the other tiles keep
+				// what is below them like when drawing tile by tile
+				for (int ty = 0; ty < run_h; ++ty) {
+					for (int tx = 0; tx < run_w;) {
+						const int first = tx;
+						while (tx < run_w && chunk.drawn.test(local_x + tx + (local_y + ty) * CHUNK_SIZE)) {
+							++tx;
+						}
 
-						auto tone_hash = MakeDTileHash(tile.ID);
-						DrawTile(dst, *autotiles_d_screen, *autotiles_d_screen_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					}
-				} else {
-					// If upper layer
-
-					// Check that block F is being drawn
-					if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
-						int id = substitutions[tile.ID - BLOCK_F];
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 48) {
-							// If from first column of the block
-							col = 18 + id % 6;
-							row = 8 + id / 6;
+						if (tx > first) {
+							Rect src_rect((local_x + first) * TILE_SIZE, (local_y + ty) * TILE_SIZE, (tx - first) * TILE_SIZE, TILE_SIZE);
+							dst.BlitFast(map_draw_x + first * TILE_SIZE, map_draw_y + ty * TILE_SIZE, *chunk.bitmap, src_rect, 255);
 						} else {
-							// If from second column of the block
-							col = 24 + (id - 48) % 6;
-							row = (id - 48) / 6;
+							++tx;
 						}
-
-						auto tone_hash = MakeFTileHash(id);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash);
 					}
 				}
+			} else if (chunk.drawn.any()) {
+				Rect src_rect(local_x * TILE_SIZE, local_y * TILE_SIZE, run_w * TILE_SIZE, run_h * TILE_SIZE);
+				dst.Blit(map_draw_x, map_draw_y, *chunk.bitmap, src_rect, 255);
 			}
+
+			// Animated tiles are not part of the chunk and drawn on top
+			for (const auto& pos: chunk.animated) {
+				const int tile_x = chunk_x * CHUNK_SIZE + pos.x;
+				const int tile_y = chunk_y * CHUNK_SIZE + pos.y;
+				if (tile_x < map_x || tile_x >= map_x + run_w || tile_y < map_y || tile_y >= map_y + run_h) {
+					continue;
+				}
+
+				DrawTileData(dst, GetDataCache(tile_x, tile_y),
+					map_draw_x + (tile_x - map_x) * TILE_SIZE, map_draw_y + (tile_y - map_y) * TILE_SIZE,
+					animation_step_c, animation_step_ab, true);
+			}
+
+			x += run_w;
 		}
+
+		y += run_h;
 	}
 }
 
@@ -426,6 +614,8 @@ TilemapLayer::TileXY TilemapLayer::GetCachedAutotileD(short ID) {
 }
 
 void TilemapLayer::CreateTileCache(const std::vector<short>& nmap_data) {
+	has_animated_tiles = false;
+	chunks.clear();
 	data_cache_vec.resize(width * height);
 	for (int x = 0; x < width; x++) {
 		for (int y = 0; y < height; y++) {
@@ -462,6 +652,12 @@ void TilemapLayer::CreateTileCacheAt(int x, int y, int tile_id) {
 		}
 	}
 	GetDataCache(x, y) = tile;
+	InvalidateChunkAt(x, y);
+
+	++revision;
+	if (layer == 0 && tile.ID < BLOCK_D) {
+		has_animated_tiles = true;
+	}
 }
 
 void TilemapLayer::RecreateTileDataAt(int x, int y, int tile_id) {
@@ -670,6 +866,8 @@ BitmapRef TilemapLayer::GenerateAutotiles(int count, const std::unordered_map<ui
 }
 
 void TilemapLayer::SetChipset(BitmapRef const& nchipset) {
+	++revision;
+	chunks.clear();
 	chipset = nchipset;
 	chipset_effect = Bitmap::Create(chipset->width(), chipset->height());
 	chipset_tone_tiles.clear();
@@ -887,6 +1085,30 @@ void TilemapSubLayer::Draw(Bitmap& dst) {
 	tilemap->Draw(dst, internal_z, GetRenderOx(), GetRenderOy());
 }
 
+bool TilemapSubLayer::GetDamageState(DamageState& state) const {
+	if (!tilemap->GetChipset()) {
+		return true;
+	}
+
+	state.rect = Rect(0, 0, Player::screen_width, Player::screen_height);
+	tilemap->HashDamageState(state, GetRenderOx(), GetRenderOy());
+	return true;
+}
+
+void TilemapLayer::HashDamageState(DamageState& state, int render_ox, int render_oy) const {
+	// The fast blit flag is not included: It toggles while drawing the scene
+	// background and only matters when nothing is drawn below the tilemap.
+	state.Hash(revision).Hash(chipset.get()).Hash(chipset->GetRevision())
+		.Hash(ox - render_ox).Hash(oy - render_oy).Hash(tone)
+		.Hash(Game_Map::LoopHorizontal()).Hash(Game_Map::LoopVertical());
+
+	if (has_animated_tiles) {
+		int animation_step_c, animation_step_ab;
+		GetAnimationSteps(animation_step_c, animation_step_ab);
+		state.Hash(animation_step_c).Hash(animation_step_ab);
+	}
+}
+
 void TilemapLayer::SetTone(Tone tone) {
 	if (tone == this->tone) {
 		return;
@@ -904,4 +1126,6 @@ void TilemapLayer::SetTone(Tone tone) {
 		chipset_effect->Clear();
 	}
 	chipset_tone_tiles.clear();
+	InvalidateChunks();
+	tone_tile_draws = tone_stable_draws;
 }
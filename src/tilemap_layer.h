@@ -19,6 +19,7 @@
 #define EP_TILEMAP_LAYER_H
 
 // Headers
+#include <bitset>
 #include <cstdint>
 #include <vector>
 #include <map>
@@ -41,6 +42,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamageState(DamageState& state) const override;
+
 private:
 	TilemapLayer* tilemap = nullptr;
 
@@ -62,6 +65,15 @@ public:
 
 	void Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_oy);
 
+	/**
+	 * Adds everything that affects the drawn tiles to a damage state.
+	 *
+	 * @param state damage state to update
+	 * @param render_ox x rendering offset of the sublayer
+	 * @param render_oy y rendering offset of the sublayer
+	 */
+	void HashDamageState(DamageState& state, int render_ox, int render_oy) const;
+
 	BitmapRef const& GetChipset() const;
 	void SetChipset(BitmapRef const& nchipset);
 	const std::vector<short>& GetMapData() const;
@@ -114,13 +126,18 @@ private:
 	int animation_type = 0;
 	int layer = 0;
 	bool fast_blit = false;
+	bool has_animated_tiles = false;
 
+	/** Incremented whenever the tile data or the chipset changes */
+	uint32_t revision = 0;
+
+	void GetAnimationSteps(int& step_c, int& step_ab) const;
 	void CreateTileCache(const std::vector<short>& nmap_data);
 	void CreateTileCacheAt(int x, int y, int tile_id);
 	void RecreateTileDataAt(int x, int y, int tile_id);
 	void GenerateAutotileAB(short ID, short animID);
 	void GenerateAutotileD(short ID);
-	void DrawTile(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit = true);
+	bool DrawTile(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit = true);
 	void DrawTileImpl(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit);
 	void RecalculateAutotile(int x, int y, int tile_id);
 
@@ -161,6 +178,47 @@ private:
 
 	std::vector<TileData> data_cache_vec;
 
+	bool IsAnimatedTile(const TileData& tile) const;
+	bool DrawTileData(Bitmap& dst, const TileData& tile, int x, int y, int animation_step_c, int animation_step_ab, bool allow_fast_blit);
+
+	/** Width and height of a chunk in tiles */
+	static constexpr int CHUNK_SIZE = 16;
+	/** Upper limit of chunks kept per layer, the least recently drawn chunk is evicted first */
+	static constexpr size_t max_cached_chunks = 32;
+
+	struct ChunkTile {
+		uint8_t x;
+		uint8_t y;
+	};
+
+	/**
+	 * Pre-rendered static tiles of a CHUNK_SIZE x CHUNK_SIZE region of one z-layer.
+	 * Animated tiles are not rendered into the chunk, they are drawn every frame.
+	 */
+	struct TileChunk {
+		BitmapRef bitmap;
+		/** Positions of the animated tiles, relative to the chunk */
+		std::vector<ChunkTile> animated;
+		/** Tiles rendered into the chunk, indexed by x + y * CHUNK_SIZE */
+		std::bitset<CHUNK_SIZE * CHUNK_SIZE> drawn;
+		uint32_t last_use = 0;
+		bool valid = false;
+	};
+
+	/** Key is (z << 24) | (chunk_y << 12) | chunk_x */
+	std::unordered_map<uint32_t, TileChunk> chunks;
+	uint32_t chunk_use_counter = 0;
+	uint64_t chunk_chipset_revision = 0;
+
+	/** Draw calls after a tone change that draw tile by tile, two frames of both sublayers */
+	static constexpr uint32_t tone_stable_draws = 4;
+	/** Remaining draw calls that draw tile by tile */
+	uint32_t tone_tile_draws = 0;
+
+	TileChunk& GetChunk(uint8_t z_order, int chunk_x, int chunk_y);
+	void InvalidateChunkAt(int x, int y);
+	void InvalidateChunks();
+
 	TilemapSubLayer lower_layer;
 	TilemapSubLayer upper_layer;
 
@@ -258,7 +316,10 @@ inline void TilemapLayer::SetAnimationType(int type) {
 }
 
 inline void TilemapLayer::SetFastBlit(bool fast) {
-	fast_blit = fast;
+	if (fast != fast_blit) {
+		fast_blit = fast;
+		InvalidateChunks();
+	}
 }
 
 inline TilemapLayer::TileData& TilemapLayer::GetDataCache(int x, int y) {
@@ -185,6 +185,10 @@ void Transition::SetAttributesTransitions() {
 	}
 }
 
+bool Transition::GetDamageState(DamageState&) const {
+	return !IsActive();
+}
+
 void Transition::Draw(Bitmap& dst) {
 	if (!IsActive())
 		return;
@@ -33,6 +33,8 @@ public:
 	Weather();
 
 	void Draw(Bitmap& dst) override;
+
+	bool GetDamageState(DamageState& state) const override;
 	void Update();
 
 	Tone GetTone() const;
@@ -192,6 +192,30 @@ void Window::Draw(Bitmap& dst) {
 	}
 }
 
+bool Window::GetDamageState(DamageState& state) const {
+	if (width <= 0 || height <= 0) {
+		return true;
+	}
+
+	state.rect = Rect(x, y, width, height);
+
+	auto hash_bitmap = [&](const BitmapRef& bitmap) {
+		state.Hash(bitmap.get()).Hash(bitmap ? bitmap->GetRevision() : 0u);
+	};
+	hash_bitmap(windowskin);
+	hash_bitmap(contents);
+
+	state.Hash(stretch).Hash(cursor_rect).Hash(active).Hash(pause)
+		.Hash(up_arrow).Hash(down_arrow).Hash(left_arrow).Hash(right_arrow).Hash(animate_arrows)
+		.Hash(x).Hash(y).Hash(width).Hash(height).Hash(ox).Hash(oy).Hash(border_x).Hash(border_y)
+		.Hash(opacity).Hash(frame_opacity).Hash(back_opacity).Hash(contents_opacity)
+		.Hash(background_alpha).Hash(bg_preserve_transparent_color)
+		.Hash(cursor_frame <= 10).Hash(arrow_animation_frame < arrow_animation_frames)
+		.Hash(animation_frames).Hash(static_cast<int>(animation_count));
+
+	return true;
+}
+
 void Window::RefreshBackground() {
 	background_needs_refresh = false;
 
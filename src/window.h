@@ -33,6 +33,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamageState(DamageState& state) const override;
+
 	virtual void Update();
 	BitmapRef const& GetWindowskin() const;
 	void SetWindowskin(BitmapRef const& nwindowskin);
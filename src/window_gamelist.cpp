@@ -16,23 +16,65 @@
  */
 
 // Headers
+#include <chrono>
+#include <optional>
 #include "window_gamelist.h"
 #include "filefinder.h"
+#include "filesystem_native.h"
 #include "bitmap.h"
 #include "font.h"
+#include "platform.h"
 #include "system.h"
+#include "thread_pool.h"
+
+namespace {
+	ThreadPool& GetScanPool() {
+		// Bound by file IO (archive directories), a few threads are sufficient
+		static ThreadPool pool(std::min(ThreadPool::GetDefaultNumThreads(), 4));
+		return pool;
+	}
+
+	GameListCache::Entry ScanProjectType(const std::string& path, std::optional<GameListCache::Entry> cached, const std::atomic<bool>& cancelled) {
+		Platform::File file(path);
+
+		GameListCache::Entry entry;
+		entry.size = file.GetSize();
+		entry.mtime = file.GetModificationTime();
+
+		if (cached && GameListCache::IsValid(*cached, entry.size, entry.mtime)) {
+			return *cached;
+		}
+
+		if (cancelled) {
+			return entry;
+		}
+
+		// A private filesystem: The directory cache of the shared one is not thread safe
+		auto native_fs = std::make_shared<NativeFilesystem>("", FilesystemView());
+		auto fs = native_fs->Subtree("").Create(path);
+		if (fs) {
+			entry.type = FileFinder::GetProjectType(fs);
+		}
+		return entry;
+	}
+}
 
 Window_GameList::Window_GameList(int ix, int iy, int iwidth, int iheight) :
 	Window_Selectable(ix, iy, iwidth, iheight) {
 	column_max = 1;
 }
 
+Window_GameList::~Window_GameList() {
+	CancelScan();
+}
+
 bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot) {
 	base_fs = filesystem_base;
 	if (!base_fs) {
 		return false;
 	}
 
+	CancelScan();
 	game_entries.clear();
 
 	this->show_dotdot = show_dotdot;
@@ -65,22 +107,10 @@ bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot)
 		}
 		if (dir.second.type == DirectoryTree::FileType::Regular) {
 			if (FileFinder::IsSupportedArchiveExtension(dir.second.name)) {
-				// The type is only determined on platforms with fast file IO (Windows and UNIX systems)
-				// A platform is considered "fast" when it does not require our custom IO buffer
-#ifndef USE_CUSTOM_FILEBUF
-				auto fs = base_fs.Create(dir.second.name);
-				game_entries.push_back({ dir.second.name, FileFinder::GetProjectType(fs) });
-#else
 				game_entries.push_back({ dir.second.name, FileFinder::ProjectType::Unknown });
-#endif
 			}
 		} else if (dir.second.type == DirectoryTree::FileType::Directory) {
-#ifndef USE_CUSTOM_FILEBUF
-			auto fs = base_fs.Create(dir.second.name);
-			game_entries.push_back({ dir.second.name, FileFinder::GetProjectType(fs) });
-#else
 			game_entries.push_back({ dir.second.name, FileFinder::ProjectType::Unknown });
-#endif
 		}
 	}
 
@@ -95,6 +125,14 @@ bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot)
 		game_entries.insert(game_entries.begin(), { "..", FileFinder::ProjectType::Unknown });
 	}
 
+	type_pending.assign(game_entries.size(), false);
+
+	// The type is only determined on platforms with fast file IO (Windows and UNIX systems)
+	// A platform is considered "fast" when it does not require our custom IO buffer
+#ifndef USE_CUSTOM_FILEBUF
+	StartScan();
+#endif
+
 	if (HasValidEntry()) {
 		item_max = game_entries.size();
 
@@ -121,6 +159,96 @@ bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot)
 	return true;
 }
 
+void Window_GameList::Update() {
+	Window_Selectable::Update();
+
+	if (!pending.empty()) {
+		CollectScan();
+	}
+}
+
+void Window_GameList::StartScan() {
+	const int first = show_dotdot ? 1 : 0;
+
+	if (!base_fs.IsFeatureSupported(Filesystem::Feature::Native)) {
+		// Archives and other virtual filesystems cannot be shared between threads
+		for (int i = first; i < static_cast<int>(game_entries.size()); ++i) {
+			auto fs = base_fs.Create(game_entries[i].dir_name);
+			game_entries[i].type = FileFinder::GetProjectType(fs);
+		}
+		return;
+	}
+
+	if (!cache_loaded) {
+		cache.Load();
+		cache_loaded = true;
+	}
+
+	scan_cancelled = std::make_shared<std::atomic<bool>>(false);
+
+	// Submitted in list order: The entries on the first page finish first
+	for (int i = first; i < static_cast<int>(game_entries.size()); ++i) {
+		auto path = FileFinder::MakePath(base_fs.GetFullPath(), game_entries[i].dir_name);
+
+		std::optional<GameListCache::Entry> cached;
+		if (auto* entry = cache.Find(path)) {
+			cached = *entry;
+		}
+
+		auto result = GetScanPool().Submit([path, cached, cancelled = scan_cancelled]() {
+			ScanResult result;
+			{
+				// Logging is not thread safe
+				Output::LogBuffer log(result.log);
+				result.entry = ScanProjectType(path, cached, *cancelled);
+			}
+			return result;
+		});
+
+		type_pending[i] = true;
+		pending.push_back({ i, std::move(path), std::move(result) });
+	}
+}
+
+void Window_GameList::CancelScan() {
+	if (scan_cancelled) {
+		*scan_cancelled = true;
+		scan_cancelled.reset();
+	}
+	pending.clear();
+}
+
+void Window_GameList::CollectScan() {
+	bool redraw = HasValidEntry();
+
+	for (auto it = pending.begin(); it != pending.end();) {
+		if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+
+		auto result = it->result.get();
+		Output::WriteMessages(result.log);
+
+		auto& entry = result.entry;
+		game_entries[it->index].type = entry.type;
+		type_pending[it->index] = false;
+		if (entry.mtime >= 0) {
+			cache.Set(std::move(it->path), entry);
+		}
+
+		if (redraw) {
+			DrawItem(it->index);
+		}
+
+		it = pending.erase(it);
+	}
+
+	if (pending.empty()) {
+		cache.Save();
+	}
+}
+
 void Window_GameList::DrawItem(int index) {
 	Rect rect = GetItemRect(index);
 	contents->ClearRect(rect);
@@ -129,7 +257,9 @@ void Window_GameList::DrawItem(int index) {
 
 #ifndef USE_CUSTOM_FILEBUF
 	auto color = Font::ColorDefault;
-	if (ge.type == FileFinder::ProjectType::Unknown) {
+	if (type_pending[index]) {
+		color = Font::ColorDisabled;
+	} else if (ge.type == FileFinder::ProjectType::Unknown) {
 		color = Font::ColorHeal;
 	} else if (ge.type > FileFinder::ProjectType::Supported) {
 		color = Font::ColorKnockout;
@@ -19,9 +19,14 @@
 #define EP_WINDOW_GAMELIST_H
 
 // Headers
+#include <atomic>
+#include <future>
+#include <memory>
 #include <vector>
 #include "window_selectable.h"
 #include "filefinder.h"
+#include "game_list_cache.h"
+#include "output.h"
 
 /**
  * Window_GameList class.
@@ -34,11 +39,17 @@ public:
 	 */
 	Window_GameList(int ix, int iy, int iwidth, int iheight);
 
+	~Window_GameList() override;
+
 	/**
 	 * Refreshes the game list.
+	 * The project types are determined in the background, entries are
+	 * redrawn by Update when their type is known.
 	 */
 	bool Refresh(FilesystemView filesystem_base, bool show_dotdot);
 
+	void Update() override;
+
 	/**
 	 * Draws an item together with the quantity.
 	 *
@@ -58,11 +69,53 @@ public:
 	 */
 	FileFinder::FsEntry GetFilesystemEntry() const;
 
+	/**
+	 * @return true while project types are determined in the background
+	 */
+	bool IsScanning() const;
+
 private:
+	struct ScanResult {
+		GameListCache::Entry entry;
+		/** Messages of the archive filesystems, written when the result is collected */
+		std::vector<Output::LogMessage> log;
+	};
+
+	struct PendingScan {
+		int index;
+		std::string path;
+		std::future<ScanResult> result;
+	};
+
+	/**
+	 * Determines the project types of all entries.
+	 * On native filesystems this runs on a thread pool with a private
+	 * filesystem per job, because the directory caches are not thread safe.
+	 */
+	void StartScan();
+
+	/** Discards the results of the running scan */
+	void CancelScan();
+
+	/** Applies finished jobs of the scan and redraws their entries */
+	void CollectScan();
+
 	FilesystemView base_fs;
 	std::vector<FileFinder::GameEntry> game_entries;
+	/** Entries whose project type is not known yet */
+	std::vector<bool> type_pending;
+
+	std::vector<PendingScan> pending;
+	std::shared_ptr<std::atomic<bool>> scan_cancelled;
+
+	GameListCache cache;
+	bool cache_loaded = false;
 
 	bool show_dotdot = false;
 };
 
+inline bool Window_GameList::IsScanning() const {
+	return !pending.empty();
+}
+
 #endif
@@ -87,6 +87,11 @@ public:
 	 */
 	void SetCorrupted(bool corrupted);
 
+	/**
+	 * @return Whether the slot data changed since the last Refresh.
+	 */
+	bool NeedsRefresh() const;
+
 	void Update() override;
 
 protected:
@@ -102,8 +107,13 @@ protected:
 	bool corrupted = false;
 	bool has_save = false;
 	bool has_party = false;
+	bool needs_refresh = false;
 };
 
+inline bool Window_SaveFile::NeedsRefresh() const {
+	return needs_refresh;
+}
+
 inline bool Window_SaveFile::IsSystemGraphicUpdateAllowed() const {
 	return false;
 }
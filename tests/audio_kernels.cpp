@@ -0,0 +1,203 @@
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "audio_decoder.h"
+#include "audio_kernels.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("AudioKernels");
+
+namespace {
+
+using Format = AudioDecoderBase::Format;
+
+constexpr AudioKernels::Isa isas[] = {
+	AudioKernels::Isa::Scalar,
+	AudioKernels::Isa::SSE2,
+	AudioKernels::Isa::NEON
+};
+
+constexpr Format formats[] = {
+	Format::S8,
+	Format::U8,
+	Format::S16,
+	Format::U16,
+	Format::S32,
+	Format::U32,
+	Format::F32
+};
+
+struct IsaGuard {
+	AudioKernels::Isa isa = AudioKernels::GetIsa();
+	~IsaGuard() { AudioKernels::SetIsa(isa); }
+};
+
+std::vector<uint8_t> MakeSamples(Format format, size_t count, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::vector<uint8_t> data(count * AudioDecoder::GetSamplesizeForFormat(format));
+	if (format == Format::F32) {
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+		for (size_t i = 0; i < count; ++i) {
+			float sample = dist(rng);
+			std::memcpy(data.data() + i * sizeof(float), &sample, sizeof(float));
+		}
+	} else {
+		for (auto& byte: data) {
+			byte = static_cast<uint8_t>(rng());
+		}
+	}
+	return data;
+}
+
+std::vector<float> MakeMix(size_t count, float range, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> dist(-range, range);
+	std::vector<float> mix(count);
+	for (auto& sample: mix) {
+		sample = dist(rng);
+	}
+	return mix;
+}
+
+}
+
+TEST_CASE("Isa") {
+	IsaGuard guard;
+
+	REQUIRE(AudioKernels::IsSupported(AudioKernels::Isa::Scalar));
+	REQUIRE(AudioKernels::IsSupported(AudioKernels::GetIsa()));
+
+	for (auto isa: isas) {
+		REQUIRE_EQ(AudioKernels::SetIsa(isa), AudioKernels::IsSupported(isa));
+	}
+}
+
+TEST_CASE("ToStereoFloatLimits") {
+	IsaGuard guard;
+	REQUIRE(AudioKernels::SetIsa(AudioKernels::Isa::Scalar));
+
+	float out[4];
+
+	const int8_t s8[] = { -128, 64 };
+	AudioKernels::ToStereoFloat(reinterpret_cast<const uint8_t*>(s8), Format::S8, 2, 1, 1.0f, 0.5f, out);
+	REQUIRE_EQ(out[0], -1.0f);
+	REQUIRE_EQ(out[1], 0.25f);
+
+	const uint8_t u8[] = { 0, 128 };
+	AudioKernels::ToStereoFloat(u8, Format::U8, 1, 2, 1.0f, 1.0f, out);
+	REQUIRE_EQ(out[0], -1.0f);
+	REQUIRE_EQ(out[1], -1.0f);
+	REQUIRE_EQ(out[2], 0.0f);
+	REQUIRE_EQ(out[3], 0.0f);
+
+	const uint16_t u16[] = { 0xC000, 0 };
+	AudioKernels::ToStereoFloat(reinterpret_cast<const uint8_t*>(u16), Format::U16, 2, 1, 1.0f, 1.0f, out);
+	REQUIRE_EQ(out[0], 0.5f);
+	REQUIRE_EQ(out[1], -1.0f);
+
+	const uint32_t u32[] = { 0xFFFFFFFF, 0x80000000 };
+	AudioKernels::ToStereoFloat(reinterpret_cast<const uint8_t*>(u32), Format::U32, 2, 1, 1.0f, 1.0f, out);
+	REQUIRE_EQ(out[0], 1.0f);
+	REQUIRE_EQ(out[1], 0.0f);
+}
+
+TEST_CASE("ToStereoFloat") {
+	IsaGuard guard;
+
+	// Odd frame count to cover the remainder of the vector loops
+	const size_t frames = 67;
+
+	for (auto format: formats) {
+		for (int channels: { 1, 2, 3 }) {
+			const auto input = MakeSamples(format, frames * channels, channels);
+
+			std::vector<float> expected(frames * 2);
+			REQUIRE(AudioKernels::SetIsa(AudioKernels::Isa::Scalar));
+			AudioKernels::ToStereoFloat(input.data(), format, channels, frames, 0.75f, 0.5f, expected.data());
+
+			for (auto isa: isas) {
+				if (!AudioKernels::SetIsa(isa)) {
+					continue;
+				}
+				INFO(AudioKernels::GetIsaName(isa), " ", static_cast<int>(format), " ", channels);
+
+				std::vector<float> out(frames * 2);
+				AudioKernels::ToStereoFloat(input.data(), format, channels, frames, 0.75f, 0.5f, out.data());
+				REQUIRE(out == expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("MixAdd") {
+	IsaGuard guard;
+
+	const size_t count = 131;
+	const auto samples = MakeMix(count, 1.0f, 1);
+	const auto mix = MakeMix(count, 1.0f, 2);
+
+	for (auto isa: isas) {
+		if (!AudioKernels::SetIsa(isa)) {
+			continue;
+		}
+		INFO(AudioKernels::GetIsaName(isa));
+
+		auto out = mix;
+		AudioKernels::MixAdd(out.data(), samples.data(), count, 0.3f);
+		for (size_t i = 0; i < count; ++i) {
+			REQUIRE_EQ(out[i], doctest::Approx(mix[i] + samples[i] * 0.3f));
+		}
+	}
+}
+
+TEST_CASE("MixToS16") {
+	IsaGuard guard;
+
+	const size_t count = 131;
+
+	for (float total_volume: { 0.5f, 1.0f, 2.5f }) {
+		const auto mix = MakeMix(count, total_volume * 1.2f, 3);
+
+		std::vector<int16_t> expected(count);
+		REQUIRE(AudioKernels::SetIsa(AudioKernels::Isa::Scalar));
+		AudioKernels::MixToS16(mix.data(), expected.data(), count, total_volume);
+
+		for (auto isa: isas) {
+			if (!AudioKernels::SetIsa(isa)) {
+				continue;
+			}
+			INFO(AudioKernels::GetIsaName(isa), " ", total_volume);
+
+			std::vector<int16_t> out(count);
+			AudioKernels::MixToS16(mix.data(), out.data(), count, total_volume);
+			for (size_t i = 0; i < count; ++i) {
+				REQUIRE_LE(std::abs(out[i] - expected[i]), 1);
+			}
+		}
+	}
+}
+
+TEST_CASE("MixToS16Limits") {
+	IsaGuard guard;
+
+	for (auto isa: isas) {
+		if (!AudioKernels::SetIsa(isa)) {
+			continue;
+		}
+		INFO(AudioKernels::GetIsaName(isa));
+
+		// Samples beyond the range saturate
+		std::vector<float> mix = { 0.5f, -0.5f, 1.0f, -1.0f, 4.0f, -4.0f, 0.0f, 0.25f, 1.5f };
+		std::vector<int16_t> out(mix.size());
+		AudioKernels::MixToS16(mix.data(), out.data(), mix.size(), 1.0f);
+		REQUIRE_EQ(out, std::vector<int16_t>{ 16384, -16384, 32767, -32768, 32767, -32768, 0, 8192, 32767 });
+
+		// With compression the loudest possible sample maps to the limit
+		mix = { 0.4f, -0.4f, 0.8f, -0.8f, 2.0f, -2.0f, 1.4f, -1.4f, 0.0f };
+		AudioKernels::MixToS16(mix.data(), out.data(), mix.size(), 2.0f);
+		REQUIRE_EQ(out, std::vector<int16_t>{ 13107, -13107, 26214, -26214, 32767, -32768, 29491, -29491, 0 });
+	}
+}
+
+TEST_SUITE_END();
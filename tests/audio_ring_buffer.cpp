@@ -0,0 +1,97 @@
+#include <vector>
+#include "audio_ring_buffer.h"
+#include "doctest.h"
+
+#ifdef HAVE_THREADS
+#  include <thread>
+#endif
+
+TEST_SUITE_BEGIN("AudioRingBuffer");
+
+TEST_CASE("Capacity") {
+	AudioRingBuffer ring;
+	REQUIRE_EQ(ring.Capacity(), 0);
+	REQUIRE_EQ(ring.WriteAvailable(), 0);
+
+	float sample = 1.0f;
+	REQUIRE_EQ(ring.Write(&sample, 1), 0);
+	REQUIRE_EQ(ring.Read(&sample, 1), 0);
+
+	ring.Resize(100);
+	REQUIRE_EQ(ring.Capacity(), 128);
+	REQUIRE_EQ(ring.WriteAvailable(), 128);
+	REQUIRE_EQ(ring.ReadAvailable(), 0);
+}
+
+TEST_CASE("WriteRead") {
+	AudioRingBuffer ring(8);
+
+	std::vector<float> in = { 1, 2, 3, 4, 5, 6 };
+	std::vector<float> out(8);
+
+	REQUIRE_EQ(ring.Write(in.data(), 6), 6);
+	REQUIRE_EQ(ring.ReadAvailable(), 6);
+	REQUIRE_EQ(ring.WriteAvailable(), 2);
+
+	REQUIRE_EQ(ring.Read(out.data(), 4), 4);
+	REQUIRE_EQ(out[0], 1);
+	REQUIRE_EQ(out[3], 4);
+
+	// Wraps around the end
+	REQUIRE_EQ(ring.Write(in.data(), 6), 6);
+	REQUIRE_EQ(ring.ReadAvailable(), 8);
+
+	// Full
+	REQUIRE_EQ(ring.Write(in.data(), 1), 0);
+
+	REQUIRE_EQ(ring.Read(out.data(), 8), 8);
+	REQUIRE_EQ(out, std::vector<float>{ 5, 6, 1, 2, 3, 4, 5, 6 });
+	REQUIRE_EQ(ring.Read(out.data(), 1), 0);
+}
+
+TEST_CASE("Clear") {
+	AudioRingBuffer ring(4);
+
+	float samples[] = { 1, 2, 3 };
+	ring.Write(samples, 3);
+	ring.Clear();
+
+	REQUIRE_EQ(ring.ReadAvailable(), 0);
+	REQUIRE_EQ(ring.WriteAvailable(), 4);
+}
+
+#ifdef HAVE_THREADS
+TEST_CASE("Threads") {
+	AudioRingBuffer ring(64);
+	constexpr int count = 100000;
+
+	std::thread producer([&]() {
+		float next = 0;
+		while (next < count) {
+			float chunk[7];
+			int n = 0;
+			for (; n < 7 && next + n < count; ++n) {
+				chunk[n] = next + n;
+			}
+			next += ring.Write(chunk, n);
+		}
+	});
+
+	float expected = 0;
+	bool in_order = true;
+	while (expected < count) {
+		float chunk[5];
+		size_t n = ring.Read(chunk, 5);
+		for (size_t i = 0; i < n; ++i) {
+			in_order &= chunk[i] == expected;
+			++expected;
+		}
+	}
+	producer.join();
+
+	REQUIRE(in_order);
+	REQUIRE_EQ(ring.ReadAvailable(), 0);
+}
+#endif
+
+TEST_SUITE_END();
@@ -0,0 +1,109 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include "audio_secache.h"
+#include "filesystem_stream.h"
+#include "game_clock.h"
+#include "system.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("AudioSeCache");
+
+#ifdef USE_AUDIO_RESAMPLER
+
+namespace {
+
+// 16 bit mono samples, the converted stereo copy is twice as large.
+// Ten played SE fit into the 8 MB of the cache, the eleventh evicts one SE.
+constexpr uint32_t num_frames = 139264;
+
+std::vector<uint8_t> MakeWav() {
+	auto put = [](std::vector<uint8_t>& out, uint32_t value, int bytes) {
+		for (int i = 0; i < bytes; ++i) {
+			out.push_back((value >> (i * 8)) & 0xFF);
+		}
+	};
+	auto tag = [](std::vector<uint8_t>& out, const char* name) {
+		out.insert(out.end(), name, name + 4);
+	};
+
+	std::vector<uint8_t> wav;
+	tag(wav, "RIFF");
+	put(wav, 36 + num_frames * 2, 4);
+	tag(wav, "WAVE");
+	tag(wav, "fmt ");
+	put(wav, 16, 4);
+	put(wav, 1, 2); // PCM
+	put(wav, 1, 2); // Mono
+	put(wav, 44100, 4);
+	put(wav, 44100 * 2, 4);
+	put(wav, 2, 2);
+	put(wav, 16, 2);
+	tag(wav, "data");
+	put(wav, num_frames * 2, 4);
+	for (uint32_t i = 0; i < num_frames; ++i) {
+		put(wav, (i * 64) & 0x3FFF, 2);
+	}
+	return wav;
+}
+
+// Plays the SE once at the given second, returns false when no decoder supports WAV
+bool Play(int name, int second) {
+	Game_Clock::ResetFrame(Game_Clock::time_point(std::chrono::seconds(second)));
+
+	auto* buf = new Filesystem_Stream::InputMemoryStreamBuf(MakeWav());
+	auto se = AudioSeCache::Create(Filesystem_Stream::InputStream(buf, std::to_string(name)), std::to_string(name));
+	if (!se) {
+		return false;
+	}
+	// The decoder is released right away, the sample can be evicted
+	se->CreateSeDecoder(44100, AudioDecoder::Format::S16, 2, 100);
+	return true;
+}
+
+bool IsCached(int name) {
+	return AudioSeCache::GetCachedSe(std::to_string(name)) != nullptr;
+}
+
+}
+
+TEST_CASE("EvictLeastRecentlyUsed") {
+	AudioSeCache::Clear();
+
+	for (int i = 0; i < 10; ++i) {
+		if (!Play(i, i + 1)) {
+			MESSAGE("No WAV decoder available");
+			return;
+		}
+	}
+
+	// The oldest SE makes room for the new one
+	REQUIRE(Play(10, 11));
+	REQUIRE_FALSE(IsCached(0));
+	REQUIRE(IsCached(10));
+
+	// Converted on insert, not converted again
+	auto size = AudioSeCache::GetCacheSize();
+	REQUIRE(Play(10, 12));
+	REQUIRE_EQ(AudioSeCache::GetCacheSize(), size);
+
+	// A hit on the converted sample keeps it
+	REQUIRE(Play(1, 13));
+	REQUIRE_EQ(AudioSeCache::GetCacheSize(), size);
+
+	REQUIRE(Play(11, 14));
+	REQUIRE(IsCached(1));
+	REQUIRE_FALSE(IsCached(2));
+
+	size = AudioSeCache::GetCacheSize();
+	REQUIRE(Play(1, 15));
+	REQUIRE(Play(11, 16));
+	REQUIRE_EQ(AudioSeCache::GetCacheSize(), size);
+
+	AudioSeCache::Clear();
+	Game_Clock::ResetFrame(Game_Clock::now());
+}
+
+#endif
+
+TEST_SUITE_END();
@@ -0,0 +1,115 @@
+#include "test_mock_actor.h"
+#include "battle_simulator.h"
+#include "doctest.h"
+
+static void SetupParty(int hp, int atk, int def) {
+	Main_Data::game_party->Clear();
+	for (int id = 1; id <= 2; ++id) {
+		Main_Data::game_party->AddActor(id);
+		auto* actor = Main_Data::game_actors->GetActor(id);
+		actor->SetBaseMaxHp(hp);
+		actor->SetHp(hp);
+		actor->SetBaseAtk(atk);
+		actor->SetBaseDef(def);
+		actor->SetBaseAgi(50);
+	}
+}
+
+static void SetupTroop(int hp, int atk, int def) {
+	auto& tp = lcf::Data::troops[0];
+	tp.members.resize(2);
+	for (int id = 1; id <= 2; ++id) {
+		tp.members[id - 1].enemy_id = id;
+		auto* enemy = MakeDBEnemy(id, hp, 0, atk, def, 1, 10);
+		// Normal attack
+		enemy->actions.push_back({});
+	}
+}
+
+static BattleSimulator::Stats Run(int num_battles, int max_turns, int32_t seed = 0, int jobs = 1) {
+	BattleSimulator::Config config;
+	config.troop_id = 1;
+	config.num_battles = num_battles;
+	config.max_turns = max_turns;
+	config.seed = seed;
+	config.jobs = jobs;
+	return BattleSimulator::Run(config);
+}
+
+TEST_SUITE_BEGIN("BattleSimulator");
+
+TEST_CASE("Victory") {
+	const MockActor m;
+	SetupParty(500, 300, 100);
+	SetupTroop(10, 1, 1);
+
+	auto stats = Run(10, 20);
+	REQUIRE_EQ(stats.battles, 10);
+	REQUIRE_EQ(stats.victories, 10);
+	REQUIRE_EQ(stats.defeats, 0);
+	REQUIRE_EQ(stats.aborted, 0);
+	REQUIRE_GE(stats.turns, 10);
+	REQUIRE_GE(stats.actions, 20);
+
+	// Every battle starts with the same party
+	for (auto* actor: Main_Data::game_party->GetActors()) {
+		REQUIRE_EQ(actor->GetHp(), 500);
+		REQUIRE(actor->GetInflictedStates().empty());
+	}
+	REQUIRE_FALSE(Game_Battle::IsBattleRunning());
+}
+
+TEST_CASE("Defeat") {
+	const MockActor m;
+	SetupParty(10, 1, 1);
+	SetupTroop(9999, 500, 999);
+
+	auto stats = Run(10, 20);
+	REQUIRE_EQ(stats.defeats, 10);
+	REQUIRE_EQ(stats.victories, 0);
+
+	for (auto* actor: Main_Data::game_party->GetActors()) {
+		REQUIRE_FALSE(actor->IsDead());
+	}
+}
+
+TEST_CASE("TurnLimit") {
+	const MockActor m;
+	SetupParty(500, 1, 999);
+	SetupTroop(500, 1, 999);
+
+	auto stats = Run(4, 5);
+	REQUIRE_EQ(stats.aborted, 4);
+	REQUIRE_EQ(stats.turns, 20);
+}
+
+TEST_CASE("Seed") {
+	const MockActor m;
+	SetupParty(100, 60, 30);
+	SetupTroop(150, 70, 30);
+
+	auto a = Run(20, 50, 42);
+	auto b = Run(20, 50, 42);
+	REQUIRE_EQ(a.seed, 42);
+	REQUIRE_EQ(a.victories, b.victories);
+	REQUIRE_EQ(a.defeats, b.defeats);
+	REQUIRE_EQ(a.turns, b.turns);
+	REQUIRE_EQ(a.actions, b.actions);
+}
+
+TEST_CASE("Jobs") {
+	const MockActor m;
+	SetupParty(100, 60, 30);
+	SetupTroop(150, 70, 30);
+
+	auto a = Run(20, 50, 42);
+	auto b = Run(20, 50, 42, 3);
+	REQUIRE_EQ(b.battles, 20);
+	REQUIRE_EQ(a.victories, b.victories);
+	REQUIRE_EQ(a.defeats, b.defeats);
+	REQUIRE_EQ(a.aborted, b.aborted);
+	REQUIRE_EQ(a.turns, b.turns);
+	REQUIRE_EQ(a.actions, b.actions);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,148 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "bitmap_kernels.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("BitmapKernels");
+
+namespace {
+
+constexpr BitmapKernels::Isa isas[] = {
+	BitmapKernels::Isa::Scalar,
+	BitmapKernels::Isa::SSE2,
+	BitmapKernels::Isa::AVX2,
+	BitmapKernels::Isa::NEON
+};
+
+// RGBA with alpha in the lowest byte, the format used by HueChangeBlit
+constexpr int rs = 24;
+constexpr int gs = 16;
+constexpr int bs = 8;
+constexpr int as = 0;
+constexpr uint32_t alpha_mask = 0xFF;
+
+struct IsaGuard {
+	BitmapKernels::Isa isa = BitmapKernels::GetIsa();
+	~IsaGuard() { BitmapKernels::SetIsa(isa); }
+};
+
+std::vector<uint32_t> MakePixels(int n, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::vector<uint32_t> pixels(n);
+	for (auto& px: pixels) {
+		px = rng();
+		// Make fully transparent and opaque pixels common
+		switch (px % 4) {
+			case 0: px &= ~alpha_mask; break;
+			case 1: px |= alpha_mask; break;
+		}
+	}
+	return pixels;
+}
+
+}
+
+TEST_CASE("Isa") {
+	IsaGuard guard;
+
+	REQUIRE(BitmapKernels::IsSupported(BitmapKernels::Isa::Scalar));
+	REQUIRE(BitmapKernels::IsSupported(BitmapKernels::GetIsa()));
+
+	REQUIRE(BitmapKernels::SetIsa(BitmapKernels::Isa::Scalar));
+	REQUIRE_EQ(BitmapKernels::GetIsa(), BitmapKernels::Isa::Scalar);
+
+	for (auto isa: isas) {
+		REQUIRE_EQ(BitmapKernels::SetIsa(isa), BitmapKernels::IsSupported(isa));
+	}
+}
+
+TEST_CASE("ComputeOpacity") {
+	IsaGuard guard;
+
+	// Odd sizes to cover the remainder of the vector loops
+	const int width = 37;
+	const int height = 5;
+	const int stride = 40;
+
+	for (auto isa: isas) {
+		if (!BitmapKernels::SetIsa(isa)) {
+			continue;
+		}
+		INFO(BitmapKernels::GetIsaName(isa));
+
+		std::vector<uint32_t> pixels(stride * height, 0x12345600);
+		REQUIRE_EQ(BitmapKernels::ComputeOpacity(pixels.data(), width, height, stride, alpha_mask), ImageOpacity::Transparent);
+
+		// Pixels outside of the region are ignored
+		for (int y = 0; y < height; ++y) {
+			pixels[y * stride + width] = 0x80;
+		}
+		REQUIRE_EQ(BitmapKernels::ComputeOpacity(pixels.data(), width, height, stride, alpha_mask), ImageOpacity::Transparent);
+
+		pixels[width - 1] = 0xFF;
+		REQUIRE_EQ(BitmapKernels::ComputeOpacity(pixels.data(), width, height, stride, alpha_mask), ImageOpacity::Alpha_1Bit);
+
+		for (auto& px: pixels) {
+			px |= alpha_mask;
+		}
+		REQUIRE_EQ(BitmapKernels::ComputeOpacity(pixels.data(), width, height, stride, alpha_mask), ImageOpacity::Opaque);
+
+		pixels[(height - 1) * stride + 3] = 0x80;
+		REQUIRE_EQ(BitmapKernels::ComputeOpacity(pixels.data(), width, height, stride, alpha_mask), ImageOpacity::Alpha_8Bit);
+
+		pixels[(height - 1) * stride + 3] = 0x00;
+		REQUIRE_EQ(BitmapKernels::ComputeOpacity(pixels.data(), width, height, stride, alpha_mask), ImageOpacity::Alpha_1Bit);
+	}
+}
+
+TEST_CASE("SaturationTone") {
+	IsaGuard guard;
+
+	const int width = 61;
+	const int height = 7;
+	const int stride = 64;
+
+	for (int saturation: { 0, 512, 1024, 1024 + 64 * 16, 1024 + 127 * 16 }) {
+		for (bool skip_transparent: { false, true }) {
+			const auto input = MakePixels(stride * height, saturation);
+
+			auto expected = input;
+			REQUIRE(BitmapKernels::SetIsa(BitmapKernels::Isa::Scalar));
+			BitmapKernels::SaturationTone(expected.data(), width, height, stride, saturation, rs, gs, bs, as, skip_transparent);
+
+			for (auto isa: isas) {
+				if (!BitmapKernels::SetIsa(isa)) {
+					continue;
+				}
+				INFO(BitmapKernels::GetIsaName(isa), " ", saturation, " ", skip_transparent);
+
+				auto pixels = input;
+				BitmapKernels::SaturationTone(pixels.data(), width, height, stride, saturation, rs, gs, bs, as, skip_transparent);
+				REQUIRE(pixels == expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("SaturationToneGray") {
+	IsaGuard guard;
+
+	for (auto isa: isas) {
+		if (!BitmapKernels::SetIsa(isa)) {
+			continue;
+		}
+		INFO(BitmapKernels::GetIsaName(isa));
+
+		std::vector<uint32_t> pixels(16, 0xFF0000FF);
+		pixels[15] = 0x00FF0000;
+		BitmapKernels::SaturationTone(pixels.data(), 16, 1, 16, 0, rs, gs, bs, as, true);
+
+		// Luminance of pure red
+		REQUIRE_EQ(pixels[0], 0x4C4C4CFF);
+		REQUIRE_EQ(pixels[14], 0x4C4C4CFF);
+		REQUIRE_EQ(pixels[15], 0x00FF0000);
+	}
+}
+
+TEST_SUITE_END();
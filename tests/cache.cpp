@@ -0,0 +1,123 @@
+#include "doctest.h"
+#include "bitmap.h"
+#include "cache.h"
+#include "color.h"
+#include "pixel_format.h"
+#include "rect.h"
+#include "tone.h"
+
+TEST_SUITE_BEGIN("Cache");
+
+namespace {
+BitmapRef FlipEffect(const BitmapRef& src, int x) {
+	return Cache::SpriteEffect(src, Rect(x, 0, 16, 16), true, false, Tone(), Color());
+}
+
+uint32_t FirstPixel(const Bitmap& bmp) {
+	return *static_cast<const uint32_t*>(bmp.pixels());
+}
+}
+
+TEST_CASE("SpriteEffectHit") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Cache::Clear();
+	Cache::ResetStats();
+
+	auto src = Bitmap::Create(64, 16);
+	auto a = FlipEffect(src, 0);
+	auto b = FlipEffect(src, 0);
+
+	REQUIRE_EQ(a, b);
+
+	auto stats = Cache::GetStats(Cache::Category::SpriteEffect);
+	REQUIRE_EQ(stats.items, 1);
+	REQUIRE_EQ(stats.hits, 1);
+	REQUIRE_EQ(stats.misses, 1);
+	REQUIRE_EQ(stats.size, a->GetSize());
+
+	Cache::Clear();
+}
+
+TEST_CASE("SpriteEffectWithoutId") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Cache::Clear();
+
+	auto src = Bitmap::Create(64, 16, Color(255, 0, 0, 255));
+	const void* address = src.get();
+	auto red = FlipEffect(src, 0);
+	REQUIRE_EQ(FirstPixel(*red), FirstPixel(*src));
+	const auto red_pixel = FirstPixel(*red);
+	red.reset();
+	src.reset();
+
+	// The allocator usually hands out the freed address again
+	src = Bitmap::Create(64, 16, Color(0, 0, 255, 255));
+	if (src.get() != address) {
+		MESSAGE("Address of the freed bitmap was not reused");
+	}
+
+	auto blue = FlipEffect(src, 0);
+	REQUIRE_NE(FirstPixel(*blue), red_pixel);
+	REQUIRE_EQ(FirstPixel(*blue), FirstPixel(*src));
+
+	Cache::Clear();
+}
+
+TEST_CASE("SpriteEffectEvictLru") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Cache::Clear();
+	Cache::ResetStats();
+
+	auto src = Bitmap::Create(64, 16);
+	const auto size = FlipEffect(src, 0)->GetSize();
+	Cache::SetBudget(Cache::Category::SpriteEffect, size * 2);
+
+	FlipEffect(src, 16);
+	// Touch 0 again, 16 is now the least recently used
+	FlipEffect(src, 0);
+	FlipEffect(src, 32);
+
+	auto stats = Cache::GetStats(Cache::Category::SpriteEffect);
+	REQUIRE_EQ(stats.items, 2);
+	REQUIRE_EQ(stats.evictions, 1);
+	REQUIRE_EQ(stats.size, size * 2);
+
+	FlipEffect(src, 0);
+	REQUIRE_EQ(Cache::GetStats(Cache::Category::SpriteEffect).hits, 2);
+
+	FlipEffect(src, 16);
+	REQUIRE_EQ(Cache::GetStats(Cache::Category::SpriteEffect).misses, 4);
+
+	Cache::SetBudget(Cache::Category::SpriteEffect, 1024 * 1024);
+	Cache::Clear();
+}
+
+TEST_CASE("SpriteEffectKeepReferenced") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Cache::Clear();
+	Cache::ResetStats();
+
+	auto src = Bitmap::Create(64, 16);
+	auto a = FlipEffect(src, 0);
+	Cache::SetBudget(Cache::Category::SpriteEffect, a->GetSize());
+
+	auto b = FlipEffect(src, 16);
+
+	// Both are in use and cannot be freed
+	auto stats = Cache::GetStats(Cache::Category::SpriteEffect);
+	REQUIRE_EQ(stats.items, 2);
+	REQUIRE_EQ(stats.evictions, 0);
+
+	a.reset();
+	FlipEffect(src, 32);
+
+	// a is freed, b and the new effect are still referenced during the insert
+	stats = Cache::GetStats(Cache::Category::SpriteEffect);
+	REQUIRE_EQ(stats.evictions, 1);
+	REQUIRE_EQ(stats.items, 2);
+
+	Cache::SetBudget(Cache::Category::SpriteEffect, 1024 * 1024);
+	Cache::Clear();
+}
+
+TEST_SUITE_END();
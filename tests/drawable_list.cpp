@@ -22,6 +22,21 @@ class TestFrame : public Drawable {
 		void Draw(Bitmap&) override {}
 };
 
+class TestDamage : public Drawable {
+	public:
+		TestDamage(Drawable::Z_t z, Rect rect) : Drawable(z, Drawable::Flags::Global), rect(rect) {}
+		void Draw(Bitmap&) override {}
+		bool GetDamageState(DamageState& state) const override {
+			state.rect = rect;
+			state.Hash(value);
+			return supported;
+		}
+
+		Rect rect;
+		int value = 0;
+		bool supported = true;
+};
+
 }
 
 TEST_CASE("Default") {
@@ -350,4 +365,131 @@ TEST_CASE("TakeFromPred") {
 	REQUIRE(list2.IsDirty());
 }
 
+TEST_CASE("DrawPass") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Bitmap bitmap(16, 16, false);
+
+	DrawableList list;
+
+	auto pass = DrawableList::GetDrawPass();
+	list.Draw(bitmap);
+	REQUIRE_EQ(DrawableList::GetDrawPass(), pass + 1);
+}
+
+TEST_CASE("CollectDamage") {
+	DrawableList list;
+	std::vector<Rect> damage;
+
+	TestDamage d1(1, Rect(0, 0, 8, 8));
+	TestDamage d2(2, Rect(16, 16, 4, 4));
+	list.Append(&d1);
+	list.Append(&d2);
+
+	// Nothing recorded yet
+	REQUIRE_FALSE(list.CollectDamage(damage));
+
+	REQUIRE(list.CollectDamage(damage));
+	REQUIRE(damage.empty());
+
+	SUBCASE("changed state") {
+		d1.value = 1;
+		REQUIRE(list.CollectDamage(damage));
+		REQUIRE_EQ(damage.size(), 2);
+		REQUIRE_EQ(damage[0], d1.rect);
+		REQUIRE_EQ(damage[1], d1.rect);
+
+		REQUIRE(list.CollectDamage(damage));
+		REQUIRE(damage.empty());
+	}
+
+	SUBCASE("moved") {
+		d2.rect = Rect(20, 16, 4, 4);
+		REQUIRE(list.CollectDamage(damage));
+		REQUIRE_EQ(damage.size(), 2);
+		REQUIRE_EQ(damage[0], Rect(16, 16, 4, 4));
+		REQUIRE_EQ(damage[1], Rect(20, 16, 4, 4));
+	}
+
+	SUBCASE("hidden") {
+		d1.SetVisible(false);
+		REQUIRE(list.CollectDamage(damage));
+		REQUIRE_EQ(damage.size(), 1);
+		REQUIRE_EQ(damage[0], d1.rect);
+	}
+
+	SUBCASE("order changed") {
+		DrawableMgr::SetLocalList(&list);
+		d1.SetZ(3);
+		REQUIRE(list.CollectDamage(damage));
+		REQUIRE_EQ(damage.size(), 4);
+	}
+
+	SUBCASE("unsupported") {
+		d2.supported = false;
+		REQUIRE_FALSE(list.CollectDamage(damage));
+
+		d2.supported = true;
+		REQUIRE_FALSE(list.CollectDamage(damage));
+		REQUIRE(list.CollectDamage(damage));
+		REQUIRE(damage.empty());
+	}
+
+	SUBCASE("reset") {
+		list.ResetDamage();
+		REQUIRE_FALSE(list.CollectDamage(damage));
+	}
+}
+
+TEST_CASE("BitmapRevision") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Bitmap bitmap(4, 4, true);
+	Bitmap src(4, 4, true);
+
+	auto rev = bitmap.GetRevision();
+	bitmap.Fill(Color(255, 0, 0, 255));
+	REQUIRE_NE(bitmap.GetRevision(), rev);
+
+	rev = bitmap.GetRevision();
+	bitmap.Blit(0, 0, src, src.GetRect(), Opacity::Opaque());
+	REQUIRE_NE(bitmap.GetRevision(), rev);
+
+	rev = bitmap.GetRevision();
+	bitmap.GetColorAt(0, 0);
+	src.Clear();
+	REQUIRE_EQ(bitmap.GetRevision(), rev);
+}
+
+TEST_CASE("BitmapRevisionUnique") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+
+	// Same size and drawing operations, usually allocated at the same address
+	auto bitmap = Bitmap::Create(4, 4, true);
+	bitmap->Fill(Color(255, 0, 0, 255));
+	const auto rev = bitmap->GetRevision();
+	bitmap.reset();
+
+	bitmap = Bitmap::Create(4, 4, true);
+	REQUIRE_NE(bitmap->GetRevision(), rev);
+	bitmap->Fill(Color(255, 0, 0, 255));
+	REQUIRE_NE(bitmap->GetRevision(), rev);
+}
+
+TEST_CASE("BitmapClip") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Bitmap bitmap(4, 4, true);
+
+	bitmap.SetClipRects({ Rect(0, 0, 2, 2) });
+	bitmap.Fill(Color(255, 0, 0, 255));
+	REQUIRE_EQ(bitmap.GetColorAt(0, 0), Color(255, 0, 0, 255));
+	REQUIRE_EQ(bitmap.GetColorAt(3, 3), Color());
+
+	bitmap.SetClipRects({});
+	bitmap.Clear();
+	REQUIRE_EQ(bitmap.GetColorAt(0, 0), Color(255, 0, 0, 255));
+
+	bitmap.ResetClip();
+	bitmap.Clear();
+	REQUIRE_EQ(bitmap.GetColorAt(0, 0), Color());
+}
+
 TEST_SUITE_END();
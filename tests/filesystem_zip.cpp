@@ -1,3 +1,5 @@
+#include <utility>
+#include <vector>
 #include "filesystem.h"
 #include "filefinder.h"
 #include "main_data.h"
@@ -6,6 +8,25 @@
 
 #define ZIP_PATH EP_TEST_PATH "/filesystem/test.zip"
 #define ZIP_FOLDER_PATH EP_TEST_PATH "/filesystem/folder.zip"
+#define ZIP_LARGE_PATH EP_TEST_PATH "/filesystem/large.zip"
+
+namespace {
+// Content of the files in large.zip
+char LargeFileByte(int i) {
+	return static_cast<char>((i * 7 + (i >> 8)) & 0xFF);
+}
+
+void CheckLargeFileRead(Filesystem_Stream::InputStream& is, int pos, int len) {
+	is.clear();
+	is.seekg(pos, std::ios_base::beg);
+
+	std::vector<char> buf(len);
+	REQUIRE_EQ(is.read(buf.data(), len).gcount(), len);
+	for (int i = 0; i < len; ++i) {
+		REQUIRE_EQ(buf[i], LargeFileByte(pos + i));
+	}
+}
+}
 
 TEST_SUITE_BEGIN("Filesystem ZIP");
 
@@ -60,6 +81,25 @@ TEST_CASE("File reading") {
 	CHECK(line_out == "lo");
 }
 
+TEST_CASE("Streamed file reading") {
+	auto fs = FileFinder::Root().Create(ZIP_LARGE_PATH);
+
+	for (auto [name, size]: { std::pair{"deflate.bin", 300000}, std::pair{"stored.bin", 70000} }) {
+		auto is = fs.OpenInputStream(name);
+		REQUIRE(is);
+		CHECK_EQ(static_cast<int>(is.GetSize()), size);
+
+		// Forward, across the window and backwards
+		CheckLargeFileRead(is, 0, 4);
+		CheckLargeFileRead(is, 60000, 10000);
+		CheckLargeFileRead(is, 100, 1000);
+		CheckLargeFileRead(is, size - 100, 100);
+
+		char c;
+		CHECK(!is.read(&c, 1));
+	}
+}
+
 TEST_CASE("File IO error") {
 	auto fs = FileFinder::Root().Create(ZIP_PATH);
 	CHECK(!fs.OpenInputStream("game"));
@@ -0,0 +1,42 @@
+#include "frame_stats.h"
+#include "doctest.h"
+
+using namespace std::chrono_literals;
+
+TEST_SUITE_BEGIN("FrameStats");
+
+TEST_CASE("Empty") {
+	FrameStats stats;
+
+	REQUIRE_EQ(stats.GetNumFrames(), 0);
+	REQUIRE_EQ(stats.GetUpdatePercentile(50), FrameStats::duration());
+	REQUIRE_EQ(stats.GetTotalTime(), FrameStats::duration());
+}
+
+TEST_CASE("Percentile") {
+	std::vector<FrameStats::duration> values;
+	for (int i = 100; i > 0; --i) {
+		values.push_back(std::chrono::duration_cast<FrameStats::duration>(std::chrono::milliseconds(i)));
+	}
+
+	REQUIRE_EQ(FrameStats::Percentile(values, 0), 1ms);
+	REQUIRE_EQ(FrameStats::Percentile(values, 50), 50ms);
+	REQUIRE_EQ(FrameStats::Percentile(values, 99), 99ms);
+	REQUIRE_EQ(FrameStats::Percentile(values, 100), 100ms);
+}
+
+TEST_CASE("UpdateDraw") {
+	FrameStats stats;
+	stats.Add(3ms, 1ms);
+	stats.Add(1ms, 2ms);
+	stats.Add(2ms, 3ms);
+
+	REQUIRE_EQ(stats.GetNumFrames(), 3);
+	REQUIRE_EQ(stats.GetUpdatePercentile(0), 1ms);
+	REQUIRE_EQ(stats.GetUpdatePercentile(100), 3ms);
+	REQUIRE_EQ(stats.GetDrawPercentile(50), 2ms);
+	REQUIRE_EQ(stats.GetTotalPercentile(100), 5ms);
+	REQUIRE_EQ(stats.GetTotalTime(), 12ms);
+}
+
+TEST_SUITE_END();
@@ -860,4 +860,69 @@ TEST_CASE("ChangeParam") {
 	}
 }
 
+TEST_CASE("BattleStatsCache") {
+	const MockActor m;
+
+	auto* dba = MakeDBActor(1, 1, 99, 100, 10, 200, 300, 400, 500);
+	dba->parameters.attack[1] = 250;
+	MakeDBEquip(1, lcf::rpg::Item::Type_weapon, 10, 20, 30, 40);
+	auto& state = lcf::Data::states[1];
+	state.affect_attack = true;
+	state.affect_type = lcf::rpg::State::AffectType_half;
+
+	Game_Actor actor(1);
+	REQUIRE_EQ(actor.GetAtk(), 200);
+	REQUIRE_EQ(actor.GetDef(), 300);
+
+	actor.SetEquipment(1, 1);
+	REQUIRE_EQ(actor.GetAtk(), 210);
+	REQUIRE_EQ(actor.GetDef(), 320);
+
+	actor.AddState(2, true);
+	REQUIRE_EQ(actor.GetAtk(), 105);
+	REQUIRE_EQ(actor.GetDef(), 320);
+
+	actor.SetAtkModifier(10);
+	REQUIRE_EQ(actor.GetAtk(), 110);
+
+	actor.RemoveState(2, false);
+	REQUIRE_EQ(actor.GetAtk(), 220);
+
+	actor.SetLevel(2);
+	REQUIRE_EQ(actor.GetAtk(), 270);
+
+	actor.SetBaseAtk(100);
+	REQUIRE_EQ(actor.GetAtk(), 110);
+
+	actor.ResetBattle();
+	REQUIRE_EQ(actor.GetAtk(), 100);
+	REQUIRE_EQ(actor.GetAgi(), 540);
+}
+
+TEST_CASE("BattleStatsCacheFailedAddState") {
+	const MockActor m;
+
+	MakeDBActor(1, 1, 99, 100, 10, 200, 300, 400, 500);
+	auto& half = lcf::Data::states[1];
+	half.affect_attack = true;
+	half.affect_type = lcf::rpg::State::AffectType_half;
+	// State 3 removes state 2, state 4 prevents state 3
+	auto make_immune = [](int state_id, int immune_id) {
+		auto& immune = lcf::Data::states[state_id - 1].easyrpg_immune_states;
+		immune = std::decay_t<decltype(immune)>(immune_id);
+		immune[immune_id - 1] = true;
+	};
+	make_immune(3, 2);
+	make_immune(4, 3);
+
+	Game_Actor actor(1);
+	actor.AddState(4, true);
+	actor.AddState(2, true);
+	REQUIRE_EQ(actor.GetAtk(), 100);
+
+	REQUIRE_FALSE(actor.AddState(3, true));
+	REQUIRE_FALSE(actor.HasState(2));
+	REQUIRE_EQ(actor.GetAtk(), 200);
+}
+
 TEST_SUITE_END();
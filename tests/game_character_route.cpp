@@ -0,0 +1,82 @@
+#include "doctest.h"
+#include "game_map.h"
+#include "main_data.h"
+#include <vector>
+
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("Game_Character_Route");
+
+static std::vector<int> calcRoute(int x, int y, Game_Character::CalculateMoveRouteArgs args) {
+	auto& ch = *MockGame::GetPlayer();
+	ch.SetX(x);
+	ch.SetY(y);
+
+	REQUIRE(ch.CalculateMoveRoute(args));
+	REQUIRE(ch.IsMoveRouteOverwritten());
+
+	std::vector<int> cmds;
+	for (auto& cmd: ch.GetMoveRoute().move_commands) {
+		cmds.push_back(cmd.command_id);
+	}
+	return cmds;
+}
+
+TEST_CASE("Straight") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+
+	Game_Character::CalculateMoveRouteArgs args;
+	args.dest_x = 5;
+	args.dest_y = 2;
+	REQUIRE_EQ(calcRoute(2, 2, args), std::vector<int>{ Right, Right, Right, 23 });
+
+	args.dest_x = 2;
+	args.dest_y = 5;
+	REQUIRE_EQ(calcRoute(2, 2, args), std::vector<int>{ Down, Down, Down, 23 });
+}
+
+TEST_CASE("Diagonal") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+
+	Game_Character::CalculateMoveRouteArgs args;
+	args.dest_x = 5;
+	args.dest_y = 5;
+	args.allow_diagonal = true;
+	REQUIRE_EQ(calcRoute(2, 2, args), std::vector<int>{ DownRight, DownRight, DownRight, 23 });
+}
+
+TEST_CASE("Unreachable") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+
+	// Right half is blocked, walks to the closest reachable tile
+	Game_Character::CalculateMoveRouteArgs args;
+	args.dest_x = 15;
+	args.dest_y = 2;
+	REQUIRE_EQ(calcRoute(2, 2, args), std::vector<int>{ Right, Right, Right, Right, Right, Right, Right, 23 });
+}
+
+TEST_CASE("StepsMax") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+
+	Game_Character::CalculateMoveRouteArgs args;
+	args.dest_x = 5;
+	args.dest_y = 2;
+	args.steps_max = 2;
+	REQUIRE_EQ(calcRoute(2, 2, args), std::vector<int>{ Right, Right, 23 });
+}
+
+TEST_CASE("SearchMax") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+
+	Game_Character::CalculateMoveRouteArgs args;
+	args.dest_x = 5;
+	args.dest_y = 2;
+	args.search_max = 0;
+
+	auto& ch = *MockGame::GetPlayer();
+	ch.SetX(2);
+	ch.SetY(2);
+	REQUIRE_FALSE(ch.CalculateMoveRoute(args));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <random>
+#include <vector>
+#include "game_interpreter_jump_table.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Game_Interpreter_JumpTable");
+
+namespace {
+
+using Cmd = lcf::rpg::EventCommand::Code;
+
+lcf::rpg::EventCommand MakeCommand(Cmd code, int indent, std::initializer_list<int32_t> params = {}) {
+	lcf::rpg::EventCommand cmd;
+	cmd.code = static_cast<int32_t>(code);
+	cmd.indent = indent;
+	cmd.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+	return cmd;
+}
+
+// Random, mostly broken, event code to compare against the linear scans
+std::vector<lcf::rpg::EventCommand> MakeRandomList(int size, uint32_t seed) {
+	static constexpr Cmd codes[] = {
+		Cmd::ConditionalBranch, Cmd::ElseBranch, Cmd::EndBranch,
+		Cmd::Loop, Cmd::BreakLoop, Cmd::EndLoop,
+		Cmd::Label, Cmd::JumpToLabel, Cmd::ControlVariables, Cmd::Comment
+	};
+
+	std::mt19937 rng(seed);
+	std::vector<lcf::rpg::EventCommand> list;
+	int indent = 0;
+	for (int i = 0; i < size; ++i) {
+		indent = std::max(0, indent + static_cast<int>(rng() % 5) - 2);
+		list.push_back(MakeCommand(codes[rng() % std::size(codes)], indent, { static_cast<int32_t>(rng() % 4) }));
+	}
+	return list;
+}
+
+int RefNextConditional(const std::vector<lcf::rpg::EventCommand>& list, int index, std::initializer_list<Cmd> codes, int indent) {
+	if (index >= static_cast<int>(list.size())) {
+		return index;
+	}
+	for (++index; index < static_cast<int>(list.size()); ++index) {
+		const auto& com = list[index];
+		if (com.indent > indent) {
+			continue;
+		}
+		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
+			break;
+		}
+	}
+	return index;
+}
+
+int RefLoopStart(const std::vector<lcf::rpg::EventCommand>& list, int index, int indent) {
+	for (int idx = index; idx >= 0; idx--) {
+		if (list[idx].indent > indent)
+			continue;
+		if (list[idx].indent < indent)
+			return -1;
+		if (static_cast<Cmd>(list[idx].code) != Cmd::Loop)
+			continue;
+		return idx;
+	}
+	return index;
+}
+
+}
+
+TEST_CASE("Branches") {
+	const std::vector<lcf::rpg::EventCommand> list = {
+		MakeCommand(Cmd::ConditionalBranch, 0),
+		MakeCommand(Cmd::ConditionalBranch, 1),
+		MakeCommand(Cmd::ControlVariables, 2),
+		MakeCommand(Cmd::EndBranch, 1),
+		MakeCommand(Cmd::ControlVariables, 1),
+		MakeCommand(Cmd::ElseBranch, 0),
+		MakeCommand(Cmd::ControlVariables, 1),
+		MakeCommand(Cmd::EndBranch, 0),
+		MakeCommand(Cmd::ControlVariables, 0)
+	};
+	Game_Interpreter_JumpTable table(list);
+
+	REQUIRE_EQ(table.GetSize(), 9);
+	REQUIRE_EQ(table.FindNextConditional(0, { Cmd::ElseBranch, Cmd::EndBranch }, 0), 5);
+	REQUIRE_EQ(table.FindNextConditional(1, { Cmd::ElseBranch, Cmd::EndBranch }, 1), 3);
+	REQUIRE_EQ(table.FindNextConditional(5, { Cmd::EndBranch }, 0), 7);
+	REQUIRE_EQ(table.FindNextConditional(7, { Cmd::EndBranch }, 0), 9);
+	REQUIRE_EQ(table.FindNextConditional(9, { Cmd::EndBranch }, 0), 9);
+}
+
+TEST_CASE("Loops") {
+	const std::vector<lcf::rpg::EventCommand> list = {
+		MakeCommand(Cmd::Loop, 0),
+		MakeCommand(Cmd::Loop, 1),
+		MakeCommand(Cmd::BreakLoop, 2),
+		MakeCommand(Cmd::EndLoop, 1),
+		MakeCommand(Cmd::BreakLoop, 1),
+		MakeCommand(Cmd::EndLoop, 0)
+	};
+	Game_Interpreter_JumpTable table(list);
+
+	REQUIRE_EQ(table.FindNextConditional(0, { Cmd::EndLoop }, 0), 5);
+	REQUIRE_EQ(table.FindNextConditional(2, { Cmd::EndLoop }, 1), 3);
+	REQUIRE_EQ(table.FindNextConditional(4, { Cmd::EndLoop }, 0), 5);
+	REQUIRE_EQ(table.FindLoopStart(5, 0), 0);
+	REQUIRE_EQ(table.FindLoopStart(3, 1), 1);
+	REQUIRE_EQ(table.FindNextEndLoop(0), 3);
+	REQUIRE_EQ(table.FindNextEndLoop(4), 5);
+	REQUIRE_EQ(table.FindNextEndLoop(6), 6);
+}
+
+TEST_CASE("Labels") {
+	const std::vector<lcf::rpg::EventCommand> list = {
+		MakeCommand(Cmd::JumpToLabel, 0, { 2 }),
+		MakeCommand(Cmd::Label, 0, { 2 }),
+		MakeCommand(Cmd::Label, 0, { 1 }),
+		MakeCommand(Cmd::Label, 0, { 2 }),
+		MakeCommand(Cmd::Label, 0)
+	};
+	Game_Interpreter_JumpTable table(list);
+
+	REQUIRE_EQ(table.FindLabel(1), 2);
+	REQUIRE_EQ(table.FindLabel(2), 1);
+	REQUIRE_EQ(table.FindLabel(3), -1);
+}
+
+TEST_CASE("BrokenEventCode") {
+	for (uint32_t seed = 0; seed < 20; ++seed) {
+		const auto list = MakeRandomList(200, seed);
+		Game_Interpreter_JumpTable table(list);
+		const int size = static_cast<int>(list.size());
+
+		for (int index = 0; index < size; ++index) {
+			for (int indent = -1; indent < 8; ++indent) {
+				INFO(seed, " ", index, " ", indent);
+				REQUIRE_EQ(table.FindNextConditional(index, { Cmd::ElseBranch, Cmd::EndBranch }, indent),
+					RefNextConditional(list, index, { Cmd::ElseBranch, Cmd::EndBranch }, indent));
+				REQUIRE_EQ(table.FindNextConditional(index, { Cmd::EndLoop }, indent),
+					RefNextConditional(list, index, { Cmd::EndLoop }, indent));
+				REQUIRE_EQ(table.FindLoopStart(index, indent), RefLoopStart(list, index, indent));
+			}
+		}
+
+		for (int label_id = 0; label_id < 5; ++label_id) {
+			auto it = std::find_if(list.begin(), list.end(), [&](const auto& com) {
+				return static_cast<Cmd>(com.code) == Cmd::Label && com.parameters[0] == label_id;
+			});
+			REQUIRE_EQ(table.FindLabel(label_id), it == list.end() ? -1 : static_cast<int>(it - list.begin()));
+		}
+	}
+}
+
+TEST_SUITE_END();
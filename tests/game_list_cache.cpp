@@ -0,0 +1,69 @@
+#include <sstream>
+#include "game_list_cache.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("GameListCache");
+
+static GameListCache::Entry MakeEntry(int64_t size, int64_t mtime, FileFinder::ProjectType type) {
+	GameListCache::Entry entry;
+	entry.size = size;
+	entry.mtime = mtime;
+	entry.type = type;
+	return entry;
+}
+
+TEST_CASE("WriteRead") {
+	GameListCache cache;
+	cache.Set("/games/Game A", MakeEntry(4096, 1700000000, FileFinder::ProjectType::Supported));
+	cache.Set("/games/game b.zip", MakeEntry(123456789012, 1700000001, FileFinder::ProjectType::RpgMakerVxAce));
+
+	std::stringstream ss;
+	cache.Write(ss);
+
+	GameListCache read;
+	read.Read(ss);
+	REQUIRE_EQ(read.GetSize(), 2);
+
+	auto* entry = read.Find("/games/game b.zip");
+	REQUIRE(entry);
+	CHECK_EQ(entry->size, 123456789012);
+	CHECK_EQ(entry->mtime, 1700000001);
+	CHECK_EQ(entry->type, FileFinder::ProjectType::RpgMakerVxAce);
+
+	entry = read.Find("/games/Game A");
+	REQUIRE(entry);
+	CHECK_EQ(entry->type, FileFinder::ProjectType::Supported);
+
+	CHECK_FALSE(read.Find("/games/game a"));
+}
+
+TEST_CASE("Malformed") {
+	GameListCache cache;
+
+	std::stringstream other_version("EasyRPG Player game list 0\n1\t1\t1\t/games/a\n");
+	cache.Read(other_version);
+	CHECK_EQ(cache.GetSize(), 0);
+
+	std::stringstream ss;
+	GameListCache().Write(ss);
+	ss << "1\t1\t1\t/games/valid\n";
+	ss << "99\t1\t1\t/games/bad type\n";
+	ss << "1\t1\t/games/missing field\n";
+	ss << "1\t1\t1\t\n";
+	ss << "garbage\n";
+	cache.Read(ss);
+	CHECK_EQ(cache.GetSize(), 1);
+	CHECK(cache.Find("/games/valid"));
+}
+
+TEST_CASE("IsValid") {
+	auto entry = MakeEntry(100, 200, FileFinder::ProjectType::Supported);
+
+	CHECK(GameListCache::IsValid(entry, 100, 200));
+	CHECK_FALSE(GameListCache::IsValid(entry, 101, 200));
+	CHECK_FALSE(GameListCache::IsValid(entry, 100, 201));
+	// Missing modification time
+	CHECK_FALSE(GameListCache::IsValid(MakeEntry(100, -1, FileFinder::ProjectType::Supported), 100, -1));
+}
+
+TEST_SUITE_END();
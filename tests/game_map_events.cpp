@@ -0,0 +1,142 @@
+#include "doctest.h"
+#include "game_map.h"
+#include <vector>
+
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("Game_Map_Events");
+
+TEST_CASE("GetEventAt") {
+	const MockGame mg(MockMap::ePassEvents20x15);
+
+	REQUIRE_EQ(Game_Map::GetEventAt(0, 0, false), MockGame::GetEvent(3));
+	REQUIRE_EQ(Game_Map::GetEventAt(1, 0, false), nullptr);
+	REQUIRE_EQ(Game_Map::CheckEvent(0, 0), 1);
+}
+
+TEST_CASE("GetEventAtAfterMove") {
+	const MockGame mg(MockMap::ePassEvents20x15);
+
+	auto* ev3 = MockGame::GetEvent(3);
+	ev3->SetX(5);
+	ev3->SetY(7);
+
+	REQUIRE_EQ(Game_Map::GetEventAt(0, 0, false), MockGame::GetEvent(2));
+	REQUIRE_EQ(Game_Map::GetEventAt(5, 7, false), ev3);
+	REQUIRE_EQ(Game_Map::GetEventAt(5, 0, false), nullptr);
+
+	auto* ev1 = MockGame::GetEvent(1);
+	ev1->MoveTo(1, 5, 7);
+	REQUIRE_EQ(Game_Map::CheckEvent(5, 7), 1);
+	REQUIRE_EQ(Game_Map::GetEventAt(5, 7, false), ev3);
+
+	ev3->SetX(0);
+	ev3->SetY(0);
+	REQUIRE_EQ(Game_Map::GetEventAt(0, 0, false), ev3);
+	REQUIRE_EQ(Game_Map::GetEventAt(5, 7, false), ev1);
+}
+
+TEST_CASE("GetEventAtOutsideMap") {
+	const MockGame mg(MockMap::ePassEvents20x15);
+
+	auto* ev2 = MockGame::GetEvent(2);
+	ev2->SetX(-3);
+	REQUIRE_EQ(Game_Map::GetEventAt(-3, 0, false), ev2);
+	REQUIRE_EQ(Game_Map::GetEventAt(-4, 0, false), nullptr);
+
+	ev2->SetY(100);
+	REQUIRE_EQ(Game_Map::GetEventAt(-3, 0, false), nullptr);
+	REQUIRE_EQ(Game_Map::GetEventAt(-3, 100, false), ev2);
+}
+
+TEST_CASE("GetNextEventAt") {
+	const MockGame mg(MockMap::ePassEvents20x15);
+
+	std::vector<int> ids;
+	for (auto* ev = Game_Map::GetNextEventAt(0, 0, nullptr); ev; ev = Game_Map::GetNextEventAt(0, 0, ev)) {
+		ids.push_back(ev->GetId());
+	}
+	REQUIRE(ids == std::vector<int>{ 1, 2, 3 });
+}
+
+TEST_CASE("CheckWayBlockedByEvent") {
+	const MockGame mg(MockMap::ePassEvents20x15);
+
+	auto* ev = MockGame::GetEvent(1);
+	ev->SetX(3);
+	ev->SetY(3);
+	ev->SetLayer(lcf::rpg::EventPage::Layers_same);
+	ev->SetActive(true);
+
+	auto& player = *MockGame::GetPlayer();
+	player.SetLayer(lcf::rpg::EventPage::Layers_same);
+	player.SetX(2);
+	player.SetY(3);
+	REQUIRE_FALSE(Game_Map::CheckWay(player, 2, 3, 3, 3));
+	REQUIRE(Game_Map::CheckWay(player, 2, 3, 2, 4));
+
+	ev->SetX(2);
+	ev->SetY(4);
+	REQUIRE(Game_Map::CheckWay(player, 2, 3, 3, 3));
+	REQUIRE_FALSE(Game_Map::CheckWay(player, 2, 3, 2, 4));
+}
+
+static int GetPageId(int event_id) {
+	auto* page = MockGame::GetEvent(event_id)->GetActivePage();
+	return page ? page->ID : 0;
+}
+
+TEST_CASE("RefreshTargetedEvents") {
+	const MockGame mg(MockMap::ePageEvents20x15);
+	lcf::Data::items.resize(1);
+
+	Game_Map::Refresh();
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+	for (int id = 1; id <= 4; ++id) {
+		REQUIRE_EQ(GetPageId(id), 1);
+	}
+
+	// Not observed by any event
+	Main_Data::game_switches->Set(5, true);
+	Game_Map::SetNeedRefreshForSwitchChange(5);
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+
+	// The variable change is not announced, only the switch event refreshes
+	Main_Data::game_variables->Set(1, 1);
+	Main_Data::game_switches->Set(1, true);
+	Game_Map::SetNeedRefreshForSwitchChange(1);
+	REQUIRE(Game_Map::GetNeedRefresh());
+	Game_Map::RefreshChanged();
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+	REQUIRE_EQ(GetPageId(2), 2);
+	REQUIRE_EQ(GetPageId(3), 1);
+
+	Game_Map::SetNeedRefreshForVarRange(1, 100);
+	Game_Map::RefreshChanged();
+	REQUIRE_EQ(GetPageId(3), 2);
+
+	Main_Data::game_party->AddItem(1, 1);
+	Game_Map::SetNeedRefreshForItemChange(1);
+	Game_Map::RefreshChanged();
+	REQUIRE_EQ(GetPageId(4), 2);
+
+	// A direct refresh covers all events, also unannounced changes
+	Main_Data::game_switches->Set(1, false);
+	Game_Map::Refresh();
+	REQUIRE_EQ(GetPageId(2), 1);
+	Main_Data::game_switches->Set(1, true);
+	Game_Map::SetNeedRefreshForSwitchChange(5);
+	Game_Map::Refresh();
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+	REQUIRE_EQ(GetPageId(2), 2);
+
+	Main_Data::game_switches->Set(1, false);
+	Main_Data::game_variables->Set(1, 0);
+	Game_Map::SetNeedRefresh(true);
+	Game_Map::Refresh();
+	REQUIRE_EQ(GetPageId(2), 1);
+	REQUIRE_EQ(GetPageId(3), 1);
+	REQUIRE_EQ(GetPageId(4), 2);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,62 @@
+#include "instrumentation.h"
+#include "doctest.h"
+#include <cstring>
+#include <sstream>
+
+TEST_SUITE_BEGIN("Instrumentation");
+
+static int FindCount(const std::vector<Instrumentation::ScopeTiming>& timings, const char* name) {
+	for (auto& t: timings) {
+		if (std::strcmp(t.name, name) == 0) {
+			return t.count;
+		}
+	}
+	return 0;
+}
+
+TEST_CASE("ScopeDisabled") {
+	Instrumentation::Init("Test");
+	Instrumentation::SetRecording(false);
+
+	auto since = Game_Clock::now();
+	{
+		Instrumentation::Scope scope("TestDisabled");
+	}
+
+	REQUIRE_EQ(FindCount(Instrumentation::GetMainThreadTimings(since), "TestDisabled"), 0);
+}
+
+TEST_CASE("ScopeTimings") {
+	Instrumentation::Init("Test");
+	Instrumentation::SetRecording(true);
+
+	auto since = Game_Clock::now();
+	for (int i = 0; i < 3; ++i) {
+		Instrumentation::Scope outer("TestOuter");
+		Instrumentation::Scope inner("TestInner");
+	}
+
+	Instrumentation::SetRecording(false);
+
+	auto timings = Instrumentation::GetMainThreadTimings(since);
+	REQUIRE_EQ(FindCount(timings, "TestOuter"), 3);
+	REQUIRE_EQ(FindCount(timings, "TestInner"), 3);
+}
+
+TEST_CASE("ChromeTrace") {
+	Instrumentation::Init("Test");
+	Instrumentation::SetRecording(true);
+	{
+		Instrumentation::Scope scope("TestTrace");
+	}
+	Instrumentation::SetRecording(false);
+
+	std::stringstream ss;
+	Instrumentation::WriteChromeTrace(ss);
+
+	auto trace = ss.str();
+	REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+	REQUIRE(trace.find("\"name\":\"TestTrace\",\"ph\":\"X\"") != std::string::npos);
+}
+
+TEST_SUITE_END();
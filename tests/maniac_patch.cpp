@@ -0,0 +1,177 @@
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <vector>
+#include "game_interpreter.h"
+#include "game_interpreter_control_variables.h"
+#include "game_switches.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "maniac_patch.h"
+#include "rand.h"
+#include "doctest.h"
+#include <lcf/data.h>
+
+TEST_SUITE_BEGIN("ManiacPatch");
+
+namespace {
+
+// Op codes of the expressions
+constexpr uint8_t Null = 0;
+constexpr uint8_t U8 = 1;
+constexpr uint8_t U16 = 2;
+constexpr uint8_t S32 = 3;
+constexpr uint8_t Var = 8;
+constexpr uint8_t Switch = 9;
+constexpr uint8_t Not = 25;
+constexpr uint8_t Add = 48;
+constexpr uint8_t Mul = 50;
+constexpr uint8_t Div = 51;
+constexpr uint8_t Less = 62;
+constexpr uint8_t Ternary = 72;
+constexpr uint8_t Function = 78;
+constexpr uint8_t FnRand = 0;
+constexpr uint8_t FnPow = 7;
+constexpr uint8_t FnSqrt = 8;
+constexpr uint8_t FnSin = 9;
+constexpr uint8_t FnCos = 10;
+constexpr uint8_t FnAtan2 = 11;
+constexpr uint8_t FnMin = 12;
+constexpr uint8_t FnMax = 13;
+constexpr uint8_t FnAbs = 14;
+constexpr uint8_t FnClamp = 15;
+constexpr uint8_t FnMuldiv = 16;
+constexpr uint8_t FnDivmul = 17;
+constexpr uint8_t FnBetween = 18;
+
+// Packs the op code bytes into the parameters of the event command
+std::vector<int32_t> MakeOps(std::initializer_list<uint8_t> bytes) {
+	std::vector<uint8_t> data(bytes);
+	data.resize((data.size() + 3) / 4 * 4);
+	std::vector<int32_t> ops(data.size() / 4);
+	for (size_t i = 0; i < ops.size(); ++i) {
+		uint32_t op = data[i * 4] | (data[i * 4 + 1] << 8) | (data[i * 4 + 2] << 16) | (static_cast<uint32_t>(data[i * 4 + 3]) << 24);
+		ops[i] = static_cast<int32_t>(op);
+	}
+	return ops;
+}
+
+struct ExpressionGuard {
+	ExpressionGuard() {
+		lcf::Data::variables.resize(10);
+		lcf::Data::switches.resize(10);
+		Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+		Main_Data::game_variables->SetWarning(0);
+		Main_Data::game_switches = std::make_unique<Game_Switches>();
+		Main_Data::game_switches->SetWarning(0);
+		ManiacPatch::ClearExpressionCache();
+	}
+
+	~ExpressionGuard() {
+		ManiacPatch::ClearExpressionCache();
+		Main_Data::game_variables.reset();
+		Main_Data::game_switches.reset();
+		lcf::Data::data = {};
+	}
+
+	int32_t Eval(std::initializer_list<uint8_t> bytes) {
+		const auto ops = MakeOps(bytes);
+		return ManiacPatch::ParseExpression(MakeSpan(ops), interpreter);
+	}
+
+	Game_Interpreter interpreter;
+};
+
+}
+
+TEST_CASE("Constants") {
+	ExpressionGuard g;
+
+	REQUIRE_EQ(g.Eval({ U8, 200 }), 200);
+	REQUIRE_EQ(g.Eval({ U16, 0x34, 0x12 }), 0x1234);
+	REQUIRE_EQ(g.Eval({ S32, 0xFF, 0xFF, 0xFF, 0xFF }), -1);
+	REQUIRE_EQ(g.Eval({}), 0);
+	// Truncated constant
+	REQUIRE_EQ(g.Eval({ S32, 0x01 }), 0);
+}
+
+TEST_CASE("Operators") {
+	ExpressionGuard g;
+
+	// 5 + 3 * 258
+	REQUIRE_EQ(g.Eval({ Add, U8, 5, Mul, U8, 3, U16, 2, 1 }), 779);
+	// Division by zero returns the dividend
+	REQUIRE_EQ(g.Eval({ Div, U8, 7, U8, 0 }), 7);
+	// Results saturate
+	REQUIRE_EQ(g.Eval({ Add, S32, 0xFF, 0xFF, 0xFF, 0x7F, U8, 1 }), std::numeric_limits<int32_t>::max());
+	REQUIRE_EQ(g.Eval({ Ternary, Less, U8, 1, U8, 2, U8, 10, U8, 20 }), 10);
+	REQUIRE_EQ(g.Eval({ Not, U8, 0 }), 0);
+}
+
+TEST_CASE("Functions") {
+	ExpressionGuard g;
+
+	// The first op code is the last parameter
+	REQUIRE_EQ(g.Eval({ Function, FnPow, 2, U8, 2, U8, 10 }), 100);
+	REQUIRE_EQ(g.Eval({ Function, FnMax, 2, U8, 3, U8, 9 }), 9);
+	REQUIRE_EQ(g.Eval({ Function, FnAbs, 1, S32, 0xFE, 0xFF, 0xFF, 0xFF }), 2);
+	// Wrong argument count
+	REQUIRE_EQ(g.Eval({ Function, FnPow, 1, U8, 2 }), 0);
+}
+
+TEST_CASE("FunctionArgumentOrder") {
+	ExpressionGuard g;
+
+	// The former recursive evaluation passed the op codes from the last to the
+	// first parameter, the compiled expressions must give identical results
+	auto eval2 = [&](uint8_t fn, uint8_t x, uint8_t y) {
+		return g.Eval({ Function, fn, 2, U8, x, U8, y });
+	};
+	auto eval3 = [&](uint8_t fn, uint8_t x, uint8_t y, uint8_t z) {
+		return g.Eval({ Function, fn, 3, U8, x, U8, y, U8, z });
+	};
+
+	REQUIRE_EQ(eval2(FnPow, 3, 2), ControlVariables::Pow(2, 3));
+	REQUIRE_EQ(eval2(FnSqrt, 10, 81), ControlVariables::Sqrt(81, 10));
+	REQUIRE_EQ(eval3(FnSin, 100, 4, 90), ControlVariables::Sin(90, 4, 100));
+	REQUIRE_EQ(eval3(FnCos, 100, 4, 90), ControlVariables::Cos(90, 4, 100));
+	REQUIRE_EQ(eval3(FnAtan2, 100, 3, 1), ControlVariables::Atan2(1, 3, 100));
+	REQUIRE_EQ(eval2(FnMin, 3, 9), ControlVariables::Min(9, 3));
+	REQUIRE_EQ(eval2(FnMax, 3, 9), ControlVariables::Max(9, 3));
+	REQUIRE_EQ(eval3(FnClamp, 10, 20, 30), ControlVariables::Clamp(30, 20, 10));
+	REQUIRE_EQ(eval3(FnMuldiv, 3, 7, 12), ControlVariables::Muldiv(12, 7, 3));
+	REQUIRE_EQ(eval3(FnDivmul, 3, 7, 12), ControlVariables::Divmul(12, 7, 3));
+	REQUIRE_EQ(eval3(FnBetween, 20, 10, 15), ControlVariables::Between(15, 10, 20));
+
+	Rand::SeedRandomNumberGenerator(7);
+	const auto rnd = eval2(FnRand, 100, 1);
+	Rand::SeedRandomNumberGenerator(7);
+	REQUIRE_EQ(rnd, ControlVariables::Random(1, 100));
+}
+
+TEST_CASE("Variables") {
+	ExpressionGuard g;
+
+	Main_Data::game_variables->Set(2, 42);
+	Main_Data::game_switches->Set(3, true);
+
+	REQUIRE_EQ(g.Eval({ Var, U8, 2 }), 42);
+	REQUIRE_EQ(g.Eval({ Switch, U8, 3 }), 1);
+	REQUIRE_EQ(g.Eval({ Add, Var, U8, 2, Switch, U8, 3 }), 43);
+
+	// The cached expression reads the new value
+	Main_Data::game_variables->Set(2, -8);
+	REQUIRE_EQ(g.Eval({ Var, U8, 2 }), -8);
+}
+
+TEST_CASE("Multiple") {
+	ExpressionGuard g;
+
+	const auto ops = MakeOps({ U8, 1, Add, U8, 2, U8, 3, U16, 0, 1, Null });
+	REQUIRE_EQ(ManiacPatch::ParseExpressions(MakeSpan(ops), g.interpreter), std::vector<int32_t>{ 1, 5, 256 });
+
+	const std::vector<int32_t> empty;
+	REQUIRE(ManiacPatch::ParseExpressions(MakeSpan(empty), g.interpreter).empty());
+}
+
+TEST_SUITE_END();
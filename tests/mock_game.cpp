@@ -111,6 +111,38 @@ std::unique_ptr<lcf::rpg::Map> MakeMockMap(MockMap maptag) {
 		case MockMap::eMapCount:
 		case MockMap::ePass40x30:
 			break;
+		case MockMap::ePassEvents20x15:
+			for (int id = 2; id <= 3; ++id) {
+				map->events.push_back(map->events.back());
+				map->events.back().ID = id;
+			}
+			break;
+		case MockMap::ePageEvents20x15:
+			for (int id = 2; id <= 4; ++id) {
+				map->events.push_back(map->events.front());
+				auto& ev = map->events.back();
+				ev.ID = id;
+				ev.pages.push_back(ev.pages.back());
+				auto& page = ev.pages.back();
+				page.ID = 2;
+				switch (id) {
+					case 2:
+						page.condition.flags.switch_a = true;
+						page.condition.switch_a_id = 1;
+						break;
+					case 3:
+						page.condition.flags.variable = true;
+						page.condition.variable_id = 1;
+						page.condition.variable_value = 1;
+						page.condition.compare_operator = 1;
+						break;
+					case 4:
+						page.condition.flags.item = true;
+						page.condition.item_id = 1;
+						break;
+				}
+			}
+			break;
 		case MockMap::ePassBlock20x15:
 			for (int y = 0; y < h; ++y) {
 				for (int x = 0; x < w; ++x) {
@@ -22,6 +22,8 @@ enum class MockMap {
 	eNone,
 	ePassBlock20x15, // Left half is passable, right half is blocked
 	ePass40x30,
+	ePassEvents20x15, // Passable, three events stacked at (0,0)
+	ePageEvents20x15, // Passable, events 2 to 4 with a second page on switch 1, variable 1 and item 1
 	eMapCount
 };
 
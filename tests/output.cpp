@@ -15,4 +15,34 @@ TEST_CASE("Message Output") {
 	Graphics::Quit();
 }
 
+TEST_CASE("LogBuffer") {
+	const auto level = Output::GetLogLevel();
+	Output::SetLogLevel(LogLevel::Debug);
+
+	std::vector<Output::LogMessage> messages;
+	{
+		Output::LogBuffer log(messages);
+		Output::Warning("Test {}", "warn");
+		Output::Debug("Test {}", "debg");
+	}
+
+	REQUIRE_EQ(messages.size(), 2);
+	REQUIRE(messages[0].lvl == LogLevel::Warning);
+	REQUIRE_EQ(messages[0].msg, "Test warn");
+	REQUIRE(messages[1].lvl == LogLevel::Debug);
+	REQUIRE_EQ(messages[1].msg, "Test debg");
+
+	// Not buffered anymore
+	Output::Debug("Test {}", "debg");
+	REQUIRE_EQ(messages.size(), 2);
+
+	Graphics::Init();
+	Main_Data::Init();
+	Output::WriteMessages(messages);
+	Main_Data::Cleanup();
+	Graphics::Quit();
+
+	Output::SetLogLevel(level);
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,77 @@
+#include <regex>
+#include "regex_cache.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("RegexCache");
+
+namespace {
+
+struct CacheGuard {
+	CacheGuard() {
+		RegexCache::Clear();
+		RegexCache::SetCapacity(RegexCache::default_capacity);
+	}
+
+	~CacheGuard() {
+		RegexCache::Clear();
+		RegexCache::SetCapacity(RegexCache::default_capacity);
+	}
+};
+
+}
+
+TEST_CASE("Lookup") {
+	CacheGuard g;
+
+	auto a = RegexCache::Get(L"a+b");
+	auto b = RegexCache::Get(L"a+b");
+	REQUIRE_EQ(a, b);
+	REQUIRE(std::regex_match(std::wstring(L"aaab"), *a));
+
+	// The flags are part of the key
+	auto c = RegexCache::Get(L"a+b", std::regex_constants::ECMAScript | std::regex_constants::icase);
+	REQUIRE_NE(a, c);
+	REQUIRE(std::regex_match(std::wstring(L"AAB"), *c));
+
+	const auto stats = RegexCache::GetStats();
+	REQUIRE_EQ(stats.items, 2);
+	REQUIRE_EQ(stats.hits, 1);
+	REQUIRE_EQ(stats.misses, 2);
+	REQUIRE_EQ(stats.evictions, 0);
+}
+
+TEST_CASE("Eviction") {
+	CacheGuard g;
+	RegexCache::SetCapacity(2);
+
+	auto a = RegexCache::Get(L"a");
+	RegexCache::Get(L"b");
+	// Touching a makes b the least recently used pattern
+	RegexCache::Get(L"a");
+	RegexCache::Get(L"c");
+
+	REQUIRE_EQ(RegexCache::GetStats().evictions, 1);
+	REQUIRE_EQ(RegexCache::Get(L"a"), a);
+	REQUIRE_EQ(RegexCache::GetStats().misses, 3);
+	RegexCache::Get(L"b");
+	REQUIRE_EQ(RegexCache::GetStats().misses, 4);
+	REQUIRE_EQ(RegexCache::GetStats().items, 2);
+
+	// Evicted expressions stay usable
+	RegexCache::SetCapacity(0);
+	REQUIRE_EQ(RegexCache::GetStats().items, 0);
+	REQUIRE(std::regex_match(std::wstring(L"a"), *a));
+	RegexCache::Get(L"a");
+	REQUIRE_EQ(RegexCache::GetStats().items, 0);
+}
+
+TEST_CASE("Invalid") {
+	CacheGuard g;
+
+	REQUIRE_THROWS_AS(RegexCache::Get(L"(a"), std::regex_error);
+	REQUIRE_EQ(RegexCache::GetStats().items, 0);
+	REQUIRE_THROWS_AS(RegexCache::Get(L"(a"), std::regex_error);
+	REQUIRE_EQ(RegexCache::GetStats().misses, 2);
+}
+
+TEST_SUITE_END();
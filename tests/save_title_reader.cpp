@@ -0,0 +1,73 @@
+#include <sstream>
+#include <string>
+#include "save_title_reader.h"
+#include "doctest.h"
+#include <lcf/lsd/reader.h>
+
+TEST_SUITE_BEGIN("SaveTitleReader");
+
+static std::string MakeSave() {
+	lcf::rpg::Save save;
+	save.title.timestamp = 45000.25;
+	save.title.hero_name = "Alex";
+	save.title.hero_level = 12;
+	save.title.hero_hp = 345;
+	save.title.face1_name = "Chara1";
+	save.title.face1_id = 3;
+	save.title.face4_name = "Chara2";
+	save.title.face4_id = 7;
+	save.system.variables.resize(500, 1);
+	save.party_location.map_id = 4;
+
+	std::stringstream ss;
+	REQUIRE(lcf::LSD_Reader::Save(ss, save, lcf::EngineVersion::e2k3, "1252"));
+	return ss.str();
+}
+
+TEST_CASE("Load") {
+	std::istringstream is(MakeSave());
+	auto title = SaveTitleReader::Load(is, "1252");
+	REQUIRE(title);
+
+	REQUIRE_EQ(title->timestamp, 45000.25);
+	REQUIRE_EQ(title->hero_name, "Alex");
+	REQUIRE_EQ(title->hero_level, 12);
+	REQUIRE_EQ(title->hero_hp, 345);
+	REQUIRE_EQ(title->face1_name, "Chara1");
+	REQUIRE_EQ(title->face1_id, 3);
+	REQUIRE(title->face2_name.empty());
+	REQUIRE_EQ(title->face4_name, "Chara2");
+	REQUIRE_EQ(title->face4_id, 7);
+}
+
+TEST_CASE("SameAsFullLoad") {
+	const auto data = MakeSave();
+
+	std::istringstream is(data);
+	auto save = lcf::LSD_Reader::Load(is, "1252");
+	REQUIRE(save);
+
+	std::istringstream title_is(data);
+	auto title = SaveTitleReader::Load(title_is, "1252");
+	REQUIRE(title);
+	REQUIRE(*title == save->title);
+}
+
+TEST_CASE("Corrupted") {
+	const auto data = MakeSave();
+
+	std::istringstream empty("");
+	REQUIRE_FALSE(SaveTitleReader::Load(empty, "1252"));
+
+	std::istringstream no_save("LcfMapUnit");
+	REQUIRE_FALSE(SaveTitleReader::Load(no_save, "1252"));
+
+	// Truncated inside of the title and inside of a later block
+	std::istringstream title_cut(data.substr(0, 30));
+	REQUIRE_FALSE(SaveTitleReader::Load(title_cut, "1252"));
+
+	std::istringstream end_cut(data.substr(0, data.size() / 2));
+	REQUIRE_FALSE(SaveTitleReader::Load(end_cut, "1252"));
+}
+
+TEST_SUITE_END();
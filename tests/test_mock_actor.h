@@ -255,6 +255,7 @@ inline void Setup(Game_Enemy* enemy, int hp, int sp, int atk, int def, int spi,
 	db.defense = def;
 	db.spirit = spi;
 	db.agility = agi;
+	enemy->InvalidateBattleStats();
 
 	enemy->SetHp(hp);
 	enemy->SetSp(sp);
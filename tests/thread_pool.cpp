@@ -0,0 +1,52 @@
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "thread_pool.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("ThreadPool");
+
+TEST_CASE("Results") {
+	ThreadPool pool(ThreadPool::GetDefaultNumThreads());
+
+	std::vector<std::future<int>> results;
+	for (int i = 0; i < 64; ++i) {
+		results.push_back(pool.Submit([i]() { return i * i; }));
+	}
+
+	for (int i = 0; i < 64; ++i) {
+		REQUIRE_EQ(results[i].get(), i * i);
+	}
+}
+
+TEST_CASE("MoveOnlyJob") {
+	ThreadPool pool(1);
+
+	auto value = std::make_unique<int>(42);
+	auto result = pool.Submit([value = std::move(value)]() { return *value; });
+
+	REQUIRE_EQ(result.get(), 42);
+}
+
+TEST_CASE("NoThreadsRunsInline") {
+	ThreadPool pool(0);
+
+	REQUIRE_EQ(pool.GetNumThreads(), 0);
+
+	bool ran = false;
+	pool.Submit([&ran]() { ran = true; });
+	REQUIRE(ran);
+}
+
+TEST_CASE("DestructorFinishesJobs") {
+	std::atomic<int> count = 0;
+	{
+		ThreadPool pool(2);
+		for (int i = 0; i < 32; ++i) {
+			pool.Submit([&count]() { ++count; });
+		}
+	}
+	REQUIRE_EQ(count.load(), 32);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,139 @@
+#include <vector>
+#include "mock_game.h"
+#include "bitmap.h"
+#include "drawable_list.h"
+#include "drawable_mgr.h"
+#include "pixel_format.h"
+#include "tilemap_layer.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("TilemapLayer");
+
+namespace {
+
+constexpr int map_width = 40;
+constexpr int map_height = 30;
+
+const Color red(255, 0, 0, 255);
+const Color blue(0, 0, 255, 255);
+const Color green(0, 255, 0, 255);
+
+// Block E tile n is at chipset column 12 + n
+Rect ChipsetRect(int n) {
+	return Rect((12 + n) * TILE_SIZE, 0, TILE_SIZE, TILE_SIZE);
+}
+
+BitmapRef MakeChipset() {
+	auto chipset = Bitmap::Create(480, 256, Color(0, 0, 0, 0));
+	chipset->FillRect(ChipsetRect(0), red);
+	chipset->FillRect(ChipsetRect(1), blue);
+	return chipset;
+}
+
+void Setup(TilemapLayer& layer, const BitmapRef& chipset) {
+	layer.SetWidth(map_width);
+	layer.SetHeight(map_height);
+	layer.SetChipset(chipset);
+	layer.SetMapData(std::vector<short>(map_width * map_height, BLOCK_E));
+}
+
+uint32_t Pixel(Bitmap& bmp, int x, int y) {
+	auto* row = static_cast<const uint8_t*>(bmp.pixels()) + y * bmp.pitch();
+	return reinterpret_cast<const uint32_t*>(row)[x];
+}
+
+uint32_t PixelOf(const Color& color) {
+	auto bmp = Bitmap::Create(1, 1, color);
+	return Pixel(*bmp, 0, 0);
+}
+
+}
+
+TEST_CASE("ChunkInvalidation") {
+	const MockGame mg(MockMap::ePass40x30);
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	auto chipset = MakeChipset();
+	TilemapLayer layer(0);
+	Setup(layer, chipset);
+
+	auto dst = Bitmap::Create(Player::screen_width, Player::screen_height, Color());
+	layer.Draw(*dst, TilemapLayer::TileBelow, 0, 0);
+	REQUIRE_EQ(Pixel(*dst, 0, 0), PixelOf(red));
+	REQUIRE_EQ(Pixel(*dst, TILE_SIZE, 0), PixelOf(red));
+
+	// Changed tile
+	layer.SetMapTileDataAt(0, 0, BLOCK_E + 1, true);
+	layer.Draw(*dst, TilemapLayer::TileBelow, 0, 0);
+	REQUIRE_EQ(Pixel(*dst, 0, 0), PixelOf(blue));
+	REQUIRE_EQ(Pixel(*dst, TILE_SIZE, 0), PixelOf(red));
+
+	// Changed chipset pixels
+	chipset->FillRect(ChipsetRect(0), green);
+	layer.Draw(*dst, TilemapLayer::TileBelow, 0, 0);
+	REQUIRE_EQ(Pixel(*dst, 0, 0), PixelOf(blue));
+	REQUIRE_EQ(Pixel(*dst, TILE_SIZE, 0), PixelOf(green));
+}
+
+TEST_CASE("ChunkTone") {
+	const MockGame mg(MockMap::ePass40x30);
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	TilemapLayer layer(0);
+	Setup(layer, MakeChipset());
+
+	auto dst = Bitmap::Create(Player::screen_width, Player::screen_height, Color());
+	layer.Draw(*dst, TilemapLayer::TileBelow, 0, 0);
+	const auto untoned = Pixel(*dst, 0, 0);
+
+	// The first draws after a tone change draw tile by tile, later draws use
+	// the chunks again. Both must apply the tone.
+	layer.SetTone(Tone(0, 255, 128, 128));
+	layer.Draw(*dst, TilemapLayer::TileBelow, 0, 0);
+	const auto toned = Pixel(*dst, 0, 0);
+	REQUIRE_NE(toned, untoned);
+
+	for (int i = 0; i < 10; ++i) {
+		dst->Clear();
+		layer.Draw(*dst, TilemapLayer::TileBelow, 0, 0);
+		REQUIRE_EQ(Pixel(*dst, 0, 0), toned);
+	}
+}
+
+TEST_CASE("ChunkFastBlit") {
+	const MockGame mg(MockMap::ePass40x30);
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	// Semi transparent tile, fast blit copies it without blending
+	auto chipset = Bitmap::Create(480, 256, Color(0, 0, 0, 0));
+	chipset->FillRect(ChipsetRect(0), Color(255, 0, 0, 128));
+
+	TilemapLayer layer(0);
+	Setup(layer, chipset);
+	layer.SetFastBlit(true);
+
+	// Block E tile 1 is above the characters, the chunk below is not full
+	std::vector<unsigned char> passable(NUM_LOWER_TILES, 0);
+	passable[BLOCK_E_INDEX + 1] = Passable::Above;
+	layer.SetPassable(passable);
+	layer.SetMapTileDataAt(1, 1, BLOCK_E + 1, true);
+
+	auto copied = Bitmap::Create(TILE_SIZE, TILE_SIZE, Color(0, 0, 255, 255));
+	copied->BlitFast(0, 0, *chipset, ChipsetRect(0), 255);
+
+	auto dst = Bitmap::Create(Player::screen_width, Player::screen_height, Color(0, 0, 255, 255));
+	layer.Draw(*dst, TilemapLayer::TileBelow, 0, 0);
+	REQUIRE_EQ(Pixel(*dst, 0, 0), Pixel(*copied, 0, 0));
+	REQUIRE_EQ(Pixel(*dst, 2 * TILE_SIZE, 0), Pixel(*copied, 0, 0));
+
+	// The tile of the other sublayer is not drawn
+	REQUIRE_EQ(Pixel(*dst, TILE_SIZE, TILE_SIZE), PixelOf(Color(0, 0, 255, 255)));
+}
+
+TEST_SUITE_END();